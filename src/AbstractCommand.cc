@@ -262,12 +262,26 @@ bool AbstractCommand::execute()
           getDownloadContext()->getFileEntries().size() == 1) {
         size_t maxSegments = req_ ? req_->getMaxPipelinedRequest() : 1;
         size_t minSplitSize = calculateMinSplitSize();
-        while (segments_.size() < maxSegments) {
-          auto segment = sm->getSegment(getCuid(), minSplitSize);
-          if (!segment) {
-            break;
+        if (maxSegments > 1) {
+          sm->getPipelinedSegment(segments_, getCuid(), minSplitSize,
+                                  maxSegments);
+        }
+        else {
+          while (segments_.size() < maxSegments) {
+            auto segment = sm->getSegment(getCuid(), minSplitSize);
+            if (!segment) {
+              break;
+            }
+            segments_.push_back(segment);
+          }
+          if (segments_.empty() && req_) {
+            // No free range is large enough.  Rather than waiting,
+            // share the remaining work of the slowest connection.
+            auto segment = sm->stealSegment(getCuid());
+            if (segment) {
+              segments_.push_back(segment);
+            }
           }
-          segments_.push_back(segment);
         }
         if (segments_.empty()) {
           // TODO socket could be pooled here if pipelining is
@@ -773,7 +787,18 @@ std::string AbstractCommand::resolveHostname(std::vector<std::string>& addrs,
     return ipaddr;
   }
 
+  {
+    const auto& error = e_->findCachedNameResolveError(hostname, port);
+    if (!error.empty()) {
+      throw DL_ABORT_EX2(fmt(MSG_NAME_RESOLUTION_FAILED, getCuid(),
+                             hostname.c_str(), error.c_str()),
+                         error_code::NAME_RESOLVE_ERROR);
+    }
+  }
+
   std::string ipaddr;
+  // TTL of resolved addresses in seconds, or -1 if unknown.
+  int ttl = -1;
 #ifdef ENABLE_ASYNC_DNS
   if (getOption()->getAsBool(PREF_ASYNC_DNS)) {
     if (!asyncNameResolverMan_->started()) {
@@ -781,6 +806,12 @@ std::string AbstractCommand::resolveHostname(std::vector<std::string>& addrs,
     }
     switch (asyncNameResolverMan_->getStatus()) {
     case -1:
+      // Timeouts and server failures may go away soon.  Only cache
+      // the answer that the name has no address.
+      if (asyncNameResolverMan_->isNegativeAnswer()) {
+        e_->cacheNameResolveError(hostname, port,
+                                  asyncNameResolverMan_->getLastError());
+      }
       if (!isProxyRequest(req_->getProtocol(), getOption())) {
         e_->getRequestGroupMan()
             ->getOrCreateServerStat(req_->getHost(), req_->getProtocol())
@@ -795,6 +826,7 @@ std::string AbstractCommand::resolveHostname(std::vector<std::string>& addrs,
 
     case 1:
       asyncNameResolverMan_->getResolvedAddress(addrs);
+      ttl = asyncNameResolverMan_->getTTL();
       if (addrs.empty()) {
         throw DL_ABORT_EX2(fmt(MSG_NAME_RESOLUTION_FAILED, getCuid(),
                                hostname.c_str(), "No address returned"),
@@ -811,12 +843,25 @@ std::string AbstractCommand::resolveHostname(std::vector<std::string>& addrs,
     if (e_->getOption()->getAsBool(PREF_DISABLE_IPV6)) {
       res.setFamily(AF_INET);
     }
-    res.resolve(addrs, hostname);
+    try {
+      res.resolve(addrs, hostname);
+    }
+    catch (RecoverableException& ex) {
+      if (res.isNegativeAnswer()) {
+        e_->cacheNameResolveError(hostname, port, res.getLastError());
+      }
+      throw;
+    }
   }
   A2_LOG_INFO(fmt(MSG_NAME_RESOLUTION_COMPLETE, getCuid(), hostname.c_str(),
                   strjoin(std::begin(addrs), std::end(addrs), ", ").c_str()));
   for (const auto& addr : addrs) {
-    e_->cacheIPAddress(hostname, addr, port);
+    if (ttl == -1) {
+      e_->cacheIPAddress(hostname, addr, port);
+    }
+    else {
+      e_->cacheIPAddress(hostname, addr, port, std::chrono::seconds(ttl));
+    }
   }
   ipaddr = e_->findCachedIPAddress(hostname, port);
   return ipaddr;
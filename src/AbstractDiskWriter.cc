@@ -53,6 +53,7 @@
 #include "DownloadFailureException.h"
 #include "error_code.h"
 #include "LogFactory.h"
+#include "DiskIOEngine.h"
 
 namespace aria2 {
 
@@ -66,7 +67,8 @@ AbstractDiskWriter::AbstractDiskWriter(const std::string& filename)
       readOnly_(false),
       enableMmap_(false),
       mapaddr_(nullptr),
-      maplen_(0)
+      maplen_(0),
+      device_(0)
 
 {
 }
@@ -130,6 +132,12 @@ void AbstractDiskWriter::openFile(int64_t totalLength)
 
 void AbstractDiskWriter::closeFile()
 {
+  auto engine = DiskIOEngine::getInstance();
+  if (pendingWrites_ && engine) {
+    // The error of a failed write is thrown by the next drainWrites()
+    // or flushOSBuffers(), even after the file is closed.
+    engine->wait(*pendingWrites_);
+  }
 #if defined(HAVE_MMAP) || defined(__MINGW32__)
   if (mapaddr_) {
     int errNum = 0;
@@ -441,32 +449,80 @@ bool isDiskFullError(int errNum)
 }
 } // namespace
 
+namespace {
+void throwWriteError(const std::string& filename, int errNum)
+{
+  // If the error indicates disk full situation, throw
+  // DownloadFailureException and abort download instantly.
+  if (isDiskFullError(errNum)) {
+    throw DOWNLOAD_FAILURE_EXCEPTION3(
+        errNum,
+        fmt(EX_FILE_WRITE, filename.c_str(), fileStrerror(errNum).c_str()),
+        error_code::NOT_ENOUGH_DISK_SPACE);
+  }
+  else {
+    throw DL_ABORT_EX3(
+        errNum,
+        fmt(EX_FILE_WRITE, filename.c_str(), fileStrerror(errNum).c_str()),
+        error_code::FILE_IO_ERROR);
+  }
+}
+} // namespace
+
+bool AbstractDiskWriter::writeAsync() const
+{
+#ifdef __MINGW32__
+  return false;
+#else  // !__MINGW32__
+  return DiskIOEngine::getInstance() && DiskIOEngine::getBuffer() &&
+         !enableMmap_ && !mapaddr_ && fd_ != A2_BAD_FD;
+#endif // !__MINGW32__
+}
+
+void AbstractDiskWriter::drainWrites()
+{
+  auto engine = DiskIOEngine::getInstance();
+  if (!pendingWrites_ || !engine) {
+    return;
+  }
+  int errNum = engine->drain(*pendingWrites_);
+  if (errNum != 0) {
+    throwWriteError(filename_, errNum);
+  }
+}
+
 void AbstractDiskWriter::writeData(const unsigned char* data, size_t len,
                                    int64_t offset)
 {
-  ensureMmapWrite(len, offset);
-  if (writeDataInternal(data, len, offset) < 0) {
-    int errNum = fileError();
-    // If the error indicates disk full situation, throw
-    // DownloadFailureException and abort download instantly.
-    if (isDiskFullError(errNum)) {
-      throw DOWNLOAD_FAILURE_EXCEPTION3(
-          errNum,
-          fmt(EX_FILE_WRITE, filename_.c_str(), fileStrerror(errNum).c_str()),
-          error_code::NOT_ENOUGH_DISK_SPACE);
+#ifndef __MINGW32__
+  if (writeAsync()) {
+    auto engine = DiskIOEngine::getInstance();
+    if (!pendingWrites_) {
+      pendingWrites_ = std::make_shared<PendingWrites>(filename_);
+      a2_struct_stat st;
+      device_ = a2fstat(fd_, &st) == 0 ? st.st_dev : 0;
     }
-    else {
-      throw DL_ABORT_EX3(
-          errNum,
-          fmt(EX_FILE_WRITE, filename_.c_str(), fileStrerror(errNum).c_str()),
-          error_code::FILE_IO_ERROR);
+    // Report the failure of a previous write as if it were this one.
+    int errNum = engine->takeError(*pendingWrites_);
+    if (errNum != 0) {
+      throwWriteError(filename_, errNum);
     }
+    engine->write(pendingWrites_, device_, fd_, data, len, offset,
+                  DiskIOEngine::getBuffer());
+    return;
+  }
+#endif // !__MINGW32__
+  drainWrites();
+  ensureMmapWrite(len, offset);
+  if (writeDataInternal(data, len, offset) < 0) {
+    throwWriteError(filename_, fileError());
   }
 }
 
 ssize_t AbstractDiskWriter::readData(unsigned char* data, size_t len,
                                      int64_t offset)
 {
+  drainWrites();
   ssize_t ret;
   if ((ret = readDataInternal(data, len, offset)) < 0) {
     int errNum = fileError();
@@ -483,6 +539,7 @@ void AbstractDiskWriter::truncate(int64_t length)
   if (fd_ == A2_BAD_FD) {
     throw DL_ABORT_EX("File not yet opened.");
   }
+  drainWrites();
 #ifdef __MINGW32__
   // Since mingw32's ftruncate cannot handle over 2GB files, we use
   // SetEndOfFile instead.
@@ -504,6 +561,7 @@ void AbstractDiskWriter::allocate(int64_t offset, int64_t length, bool sparse)
   if (fd_ == A2_BAD_FD) {
     throw DL_ABORT_EX("File not yet opened.");
   }
+  drainWrites();
   if (sparse) {
 #ifdef __MINGW32__
     DWORD bytesReturned;
@@ -575,7 +633,11 @@ void AbstractDiskWriter::allocate(int64_t offset, int64_t length, bool sparse)
 #endif // HAVE_SOME_FALLOCATE
 }
 
-int64_t AbstractDiskWriter::size() { return File(filename_).size(); }
+int64_t AbstractDiskWriter::size()
+{
+  drainWrites();
+  return File(filename_).size();
+}
 
 void AbstractDiskWriter::enableReadOnly() { readOnly_ = true; }
 
@@ -592,6 +654,7 @@ void AbstractDiskWriter::dropCache(int64_t len, int64_t offset)
 
 void AbstractDiskWriter::flushOSBuffers()
 {
+  drainWrites();
   if (fd_ == A2_BAD_FD) {
     return;
   }
@@ -37,9 +37,12 @@
 
 #include "DiskWriter.h"
 #include <string>
+#include <memory>
 
 namespace aria2 {
 
+struct PendingWrites;
+
 class AbstractDiskWriter : public DiskWriter {
 private:
   std::string filename_;
@@ -58,6 +61,14 @@ private:
   unsigned char* mapaddr_;
   int64_t maplen_;
 
+  // Writes submitted to DiskIOEngine, created by the first one.
+  std::shared_ptr<PendingWrites> pendingWrites_;
+  // The device the file is on.  Writes are queued per device.
+  uint64_t device_;
+
+  // Returns true if the write can be submitted to DiskIOEngine.
+  bool writeAsync() const;
+
   ssize_t writeDataInternal(const unsigned char* data, size_t len,
                             int64_t offset);
   ssize_t readDataInternal(unsigned char* data, size_t len, int64_t offset);
@@ -102,6 +113,8 @@ public:
   virtual void dropCache(int64_t len, int64_t offset) CXX11_OVERRIDE;
 
   virtual void flushOSBuffers() CXX11_OVERRIDE;
+
+  virtual void drainWrites() CXX11_OVERRIDE;
 };
 
 } // namespace aria2
@@ -74,6 +74,8 @@ bool AbstractProxyRequestCommand::executeInternal()
     httpRequest->setUserAgent(getOption()->get(PREF_USER_AGENT));
     httpRequest->setRequest(getRequest());
     httpRequest->setProxyRequest(proxyRequest_);
+    httpRequest->setAuthConfigFactory(
+        getDownloadEngine()->getAuthConfigFactory().get());
 
     httpConnection_->sendProxyRequest(std::move(httpRequest));
   }
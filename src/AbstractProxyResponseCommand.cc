@@ -37,6 +37,7 @@
 #include "Request.h"
 #include "Segment.h"
 #include "RequestGroup.h"
+#include "RequestGroupMan.h"
 #include "DownloadEngine.h"
 #include "HttpRequest.h"
 #include "HttpResponse.h"
@@ -71,6 +72,17 @@ bool AbstractProxyResponseCommand::executeInternal()
     addCommandSelf();
     return false;
   }
+  {
+    auto authStat = httpResponse->createAuthStat();
+    getRequestGroup()->getAuthStat() += authStat;
+    getDownloadEngine()->getRequestGroupMan()->getAuthStat() += authStat;
+  }
+  if (httpResponse->getStatusCode() == 407 &&
+      httpResponse->processProxyAuthChallenge()) {
+    // The proxy may close the connection after 407 response, so
+    // start over with new connection.
+    return prepareForRetry(0);
+  }
   if (httpResponse->getStatusCode() != 200) {
     throw DL_RETRY_EX(EX_PROXY_CONNECTION_FAILED);
   }
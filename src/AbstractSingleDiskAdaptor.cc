@@ -96,6 +96,8 @@ ssize_t AbstractSingleDiskAdaptor::readDataDropCache(unsigned char* data,
 
 void AbstractSingleDiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
 {
+  // Adjacent cells are not merged here.  DiskIOEngine merges them
+  // when it is enabled; otherwise each cell is one write.
   for (auto& d : entry->getDataSet()) {
     A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", d->goff,
                      static_cast<unsigned long>(d->len)));
@@ -108,6 +110,8 @@ void AbstractSingleDiskAdaptor::flushOSBuffers()
   diskWriter_->flushOSBuffers();
 }
 
+void AbstractSingleDiskAdaptor::drainWrites() { diskWriter_->drainWrites(); }
+
 bool AbstractSingleDiskAdaptor::fileExists()
 {
   return File(getFilePath()).exists();
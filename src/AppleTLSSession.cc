@@ -550,6 +550,16 @@ int AppleTLSSession::setSNIHostname(const std::string& hostname)
   return (lastError_ != noErr) ? TLS_ERR_ERROR : TLS_ERR_OK;
 }
 
+int AppleTLSSession::setSessionData(const std::string& data)
+{
+  // Secure Transport resumes sessions on its own, keyed by peer ID.
+  return TLS_ERR_OK;
+}
+
+std::string AppleTLSSession::getSessionData() { return ""; }
+
+bool AppleTLSSession::isResumed() { return false; }
+
 int AppleTLSSession::closeConnection()
 {
   if (state_ != st_connected) {
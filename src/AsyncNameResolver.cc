@@ -43,11 +43,21 @@
 
 namespace aria2 {
 
+namespace {
+// Returns true if |status| is an answer from DNS server saying the
+// name has no address, as opposed to a timeout or a server failure.
+bool isNegativeAnswer(int status)
+{
+  return status == ARES_ENOTFOUND || status == ARES_ENODATA;
+}
+} // namespace
+
 void callback(void* arg, int status, int timeouts, struct hostent* host)
 {
   AsyncNameResolver* resolverPtr = reinterpret_cast<AsyncNameResolver*>(arg);
   if (status != ARES_SUCCESS) {
     resolverPtr->error_ = ares_strerror(status);
+    resolverPtr->negativeAnswer_ = isNegativeAnswer(status);
     resolverPtr->status_ = AsyncNameResolver::STATUS_ERROR;
     return;
   }
@@ -66,13 +76,54 @@ void callback(void* arg, int status, int timeouts, struct hostent* host)
   }
 }
 
+#ifdef HAVE_ARES_GETADDRINFO
+void addrinfoCallback(void* arg, int status, int timeouts,
+                      struct ares_addrinfo* result)
+{
+  AsyncNameResolver* resolverPtr = reinterpret_cast<AsyncNameResolver*>(arg);
+  if (status != ARES_SUCCESS) {
+    resolverPtr->error_ = ares_strerror(status);
+    resolverPtr->negativeAnswer_ = isNegativeAnswer(status);
+    resolverPtr->status_ = AsyncNameResolver::STATUS_ERROR;
+    return;
+  }
+  for (auto node = result->nodes; node; node = node->ai_next) {
+    const void* addr;
+    if (node->ai_family == AF_INET) {
+      addr = &reinterpret_cast<sockaddr_in*>(node->ai_addr)->sin_addr;
+    }
+    else if (node->ai_family == AF_INET6) {
+      addr = &reinterpret_cast<sockaddr_in6*>(node->ai_addr)->sin6_addr;
+    }
+    else {
+      continue;
+    }
+    char addrstring[NI_MAXHOST];
+    if (inetNtop(node->ai_family, addr, addrstring, sizeof(addrstring)) == 0) {
+      resolverPtr->resolvedAddresses_.push_back(addrstring);
+      if (resolverPtr->ttl_ == -1 || node->ai_ttl < resolverPtr->ttl_) {
+        resolverPtr->ttl_ = node->ai_ttl;
+      }
+    }
+  }
+  ares_freeaddrinfo(result);
+  if (resolverPtr->resolvedAddresses_.empty()) {
+    resolverPtr->error_ = "no address returned or address conversion failed";
+    resolverPtr->status_ = AsyncNameResolver::STATUS_ERROR;
+  }
+  else {
+    resolverPtr->status_ = AsyncNameResolver::STATUS_SUCCESS;
+  }
+}
+#endif // HAVE_ARES_GETADDRINFO
+
 AsyncNameResolver::AsyncNameResolver(int family
 #ifdef HAVE_ARES_ADDR_NODE
                                      ,
                                      ares_addr_node* servers
 #endif // HAVE_ARES_ADDR_NODE
                                      )
-    : status_(STATUS_READY), family_(family)
+    : status_(STATUS_READY), family_(family), ttl_(-1), negativeAnswer_(false)
 {
   // TODO evaluate return value
   ares_init(&channel_);
@@ -92,7 +143,17 @@ void AsyncNameResolver::resolve(const std::string& name)
 {
   hostname_ = name;
   status_ = STATUS_QUERYING;
+#ifdef HAVE_ARES_GETADDRINFO
+  // Unlike ares_gethostbyname(), this gives us TTL of records.
+  ares_addrinfo_hints hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = family_;
+  hints.ai_socktype = SOCK_STREAM;
+  ares_getaddrinfo(channel_, name.c_str(), nullptr, &hints, addrinfoCallback,
+                   this);
+#else  // !HAVE_ARES_GETADDRINFO
   ares_gethostbyname(channel_, name.c_str(), family_, callback, this);
+#endif // !HAVE_ARES_GETADDRINFO
 }
 
 int AsyncNameResolver::getFds(fd_set* rfdsPtr, fd_set* wfdsPtr) const
@@ -129,6 +190,8 @@ void AsyncNameResolver::reset()
 {
   hostname_ = A2STR::NIL;
   resolvedAddresses_.clear();
+  ttl_ = -1;
+  negativeAnswer_ = false;
   status_ = STATUS_READY;
   ares_destroy(channel_);
   // TODO evaluate return value
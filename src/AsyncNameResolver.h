@@ -49,6 +49,10 @@ namespace aria2 {
 class AsyncNameResolver {
   friend void callback(void* arg, int status, int timeouts,
                        struct hostent* host);
+#ifdef HAVE_ARES_GETADDRINFO
+  friend void addrinfoCallback(void* arg, int status, int timeouts,
+                               struct ares_addrinfo* result);
+#endif // HAVE_ARES_GETADDRINFO
 
 public:
   enum STATUS {
@@ -66,6 +70,11 @@ private:
   std::vector<std::string> resolvedAddresses_;
   std::string error_;
   std::string hostname_;
+  // The smallest TTL of resolved addresses in seconds, or -1 if
+  // unknown.
+  int ttl_;
+  // true if the error is an answer that the name has no address.
+  bool negativeAnswer_;
 
 public:
   AsyncNameResolver(int family
@@ -86,6 +95,14 @@ public:
 
   const std::string& getError() const { return error_; }
 
+  // Returns true if the error is an answer from DNS server that the
+  // name has no address.  false for timeouts and server failures.
+  bool isNegativeAnswer() const { return negativeAnswer_; }
+
+  // Returns the smallest TTL of resolved addresses in seconds, or -1
+  // if c-ares does not tell us TTL.
+  int getTTL() const { return ttl_; }
+
   STATUS getStatus() const { return status_; }
 
   int getFds(fd_set* rfdsPtr, fd_set* wfdsPtr) const;
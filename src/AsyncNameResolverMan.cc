@@ -111,6 +111,21 @@ void AsyncNameResolverMan::getResolvedAddress(
   return;
 }
 
+int AsyncNameResolverMan::getTTL() const
+{
+  int ttl = -1;
+  for (size_t i = 0; i < numResolver_; ++i) {
+    if (asyncNameResolver_[i]->getStatus() ==
+        AsyncNameResolver::STATUS_SUCCESS) {
+      auto t = asyncNameResolver_[i]->getTTL();
+      if (t != -1 && (ttl == -1 || t < ttl)) {
+        ttl = t;
+      }
+    }
+  }
+  return ttl;
+}
+
 void AsyncNameResolverMan::setNameResolverCheck(DownloadEngine* e,
                                                 Command* command)
 {
@@ -194,6 +209,17 @@ const std::string& AsyncNameResolverMan::getLastError() const
   return A2STR::NIL;
 }
 
+bool AsyncNameResolverMan::isNegativeAnswer() const
+{
+  for (size_t i = 0; i < numResolver_; ++i) {
+    if (asyncNameResolver_[i]->getStatus() != AsyncNameResolver::STATUS_ERROR ||
+        !asyncNameResolver_[i]->isNegativeAnswer()) {
+      return false;
+    }
+  }
+  return numResolver_ > 0;
+}
+
 void AsyncNameResolverMan::reset(DownloadEngine* e, Command* command)
 {
   disableNameResolverCheck(e, command);
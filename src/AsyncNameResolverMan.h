@@ -65,6 +65,9 @@ public:
                   Command* command);
   // Appends resolved addresses to |res|.
   void getResolvedAddress(std::vector<std::string>& res) const;
+  // Returns the smallest TTL in seconds of resolved addresses, or -1
+  // if it is unknown.
+  int getTTL() const;
   // Adds resolvers to DownloadEngine to check event notification.
   void setNameResolverCheck(DownloadEngine* e, Command* command);
   // Removes resolvers from DownloadEngine.
@@ -76,6 +79,9 @@ public:
   int getStatus() const;
   // Returns last error string
   const std::string& getLastError() const;
+  // Returns true if all resolvers failed with an answer that the name
+  // has no address, so that the failure is worth caching.
+  bool isNegativeAnswer() const;
   // Resets state. Also removes resolvers from DownloadEngine.
   void reset(DownloadEngine* e, Command* command);
 
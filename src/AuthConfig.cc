@@ -34,6 +34,8 @@
 /* copyright --> */
 #include "AuthConfig.h"
 
+#include <cassert>
+#include <cstdio>
 #include <ostream>
 
 #include "LogFactory.h"
@@ -41,39 +43,245 @@
 #include "base64.h"
 #include "MessageDigest.h"
 #include "a2functional.h"
+#include "fmt.h"
+#include "A2STR.h"
+#include "array_fun.h"
 
 namespace aria2 {
 
-AuthConfig::AuthConfig() {}
+namespace {
+// Digest algorithms in the order of strength, weakest first.
+constexpr const char* DIGEST_ALGORITHMS[][2] = {
+    {"MD5", "md5"},
+    {"SHA-256", "sha-256"},
+    {"SHA-512-256", "sha-512-256"},
+};
+
+constexpr char SESS_SUFFIX[] = "-sess";
+} // namespace
+
+bool isDigestSessionAlgorithm(const std::string& algorithm)
+{
+  return util::iendsWith(algorithm, SESS_SUFFIX);
+}
+
+int getDigestAlgorithmStrength(const std::string& algorithm)
+{
+  if (algorithm.empty()) {
+    return 0;
+  }
+  auto last = std::end(algorithm);
+  if (isDigestSessionAlgorithm(algorithm)) {
+    last -= sizeof(SESS_SUFFIX) - 1;
+  }
+  for (size_t i = 0; i < arraySize(DIGEST_ALGORITHMS); ++i) {
+    if (util::strieq(std::begin(algorithm), last, DIGEST_ALGORITHMS[i][0])) {
+      if (MessageDigest::supports(DIGEST_ALGORITHMS[i][1])) {
+        return i;
+      }
+      break;
+    }
+  }
+  return -1;
+}
+
+std::string getDigestHashType(const std::string& algorithm)
+{
+  auto strength = getDigestAlgorithmStrength(algorithm);
+  if (strength == -1) {
+    return A2STR::NIL;
+  }
+  return DIGEST_ALGORITHMS[strength][1];
+}
+
+AuthConfig::AuthConfig()
+    : authScheme_(AUTH_NONE), nonceCount_(0), preemptive_(false)
+{
+}
 
 AuthConfig::AuthConfig(std::string user, std::string password)
-    : user_(std::move(user)), password_(std::move(password))
+    : authScheme_(AUTH_BASIC),
+      user_(std::move(user)),
+      password_(std::move(password)),
+      nonceCount_(0),
+      preemptive_(false)
+{
+}
+
+namespace {
+// Writes hex encoded digest of messageDigest to out, which must have
+// room for 2 * messageDigest.getDigestLength() bytes. Returns the
+// number of bytes written.
+size_t digestHex(char* out, MessageDigest& messageDigest)
+{
+  static constexpr char HEX[] = "0123456789abcdef";
+  unsigned char md[64];
+  auto len = messageDigest.getDigestLength();
+  assert(len <= sizeof(md));
+  messageDigest.digest(md);
+  for (size_t i = 0; i < len; ++i) {
+    *out++ = HEX[md[i] >> 4];
+    *out++ = HEX[md[i] & 0xf];
+  }
+  return len * 2;
+}
+} // namespace
+
+namespace {
+void update(MessageDigest& messageDigest, const std::string& s)
+{
+  messageDigest.update(s.data(), s.size());
+}
+} // namespace
+
+namespace {
+// Computes hex encoded request-digest (RFC 7616 3.4.1) into out and
+// returns its length.  nc is 8 hex digits nonce-count, which is only
+// used if qop is not empty.  Empty method gives the response-auth
+// sent back in Authentication-Info header field.
+size_t digestResponse(char* out, MessageDigest& messageDigest,
+                      const std::string& method, const std::string& uri,
+                      const std::string& ha1, const std::string& serverNonce,
+                      const char* nc, const std::string& clientNonce,
+                      const std::string& qop)
 {
-  authScheme_ = AUTH_BASIC;
+  char ha2[128];
+  if (qop == "auth-int") {
+    // A2 = Method ":" request-uri ":" H(entity-body).  Hash the empty
+    // body first, then hash A2 with the result.
+    char bodyHash[128];
+    messageDigest.reset();
+    auto bodyHashLen = digestHex(bodyHash, messageDigest);
+    messageDigest.reset();
+    update(messageDigest, method);
+    messageDigest.update(":", 1);
+    update(messageDigest, uri);
+    messageDigest.update(":", 1);
+    messageDigest.update(bodyHash, bodyHashLen);
+  }
+  else {
+    messageDigest.reset();
+    update(messageDigest, method);
+    messageDigest.update(":", 1);
+    update(messageDigest, uri);
+  }
+  auto ha2len = digestHex(ha2, messageDigest);
+
+  messageDigest.reset();
+  update(messageDigest, ha1);
+  messageDigest.update(":", 1);
+  update(messageDigest, serverNonce);
+  messageDigest.update(":", 1);
+  if (!qop.empty()) {
+    messageDigest.update(nc, 8);
+    messageDigest.update(":", 1);
+    update(messageDigest, clientNonce);
+    messageDigest.update(":", 1);
+    update(messageDigest, qop);
+    messageDigest.update(":", 1);
+  }
+  messageDigest.update(ha2, ha2len);
+  return digestHex(out, messageDigest);
 }
+} // namespace
 
-AuthConfig::AuthConfig(std::string user, std::string password, std::string path, std::string method, const std::unique_ptr<DigestAuthParams>& digestAuthParams)
-    : user_(std::move(user)), password_(std::move(password))
+AuthConfig::AuthConfig(std::string user, const std::string& uri,
+                       const std::string& method,
+                       const DigestAuthParams& digestAuthParams,
+                       const std::string& ha1, MessageDigest& messageDigest)
+    : authScheme_(AUTH_DIGEST),
+      user_(std::move(user)),
+      nonceCount_(digestAuthParams.nonceCount),
+      preemptive_(nonceCount_ > 1 || digestAuthParams.nextNonce),
+      serverNonce_(digestAuthParams.serverNonce),
+      clientNonce_(digestAuthParams.clientNonce),
+      qop_(digestAuthParams.qop),
+      digestUri_(uri)
 {
-  authScheme_ = AUTH_DIGEST;
-  auto digest = MessageDigest::create("md5");
-  const auto rawH1 = user_ + ":" + digestAuthParams->realm + ":" + password_;
-  const auto rawH2 = method + ":" + path;
-  digest->update(rawH1.c_str(), rawH1.length());
-  std::string H1 = util::toHex(digest->digest());
-  digest->reset();
-  digest->update(rawH2.c_str(), rawH2.length());
-  std::string H2 = util::toHex(digest->digest());
-  const auto rawResponse = H1 + ":" + digestAuthParams->serverNonce + ":00000001:0a4f113b:" + digestAuthParams->qop + ":" + H2;
-  digest->reset();
-  digest->update(rawResponse.c_str(), rawResponse.length());
-  std::string response = util::toHex(digest->digest());
-  digest_ = " username=\"" + user_ + "\", realm=\"" + digestAuthParams->realm + "\", nonce=\"" + digestAuthParams->serverNonce + "\", uri=\"" + path + "\", algorithm=" + digestAuthParams->algorithm + ", response=\"" + response + "\", qop=" + digestAuthParams->qop + " , nc=00000001, cnonce=\"0a4f113b\"";
-  A2_LOG_INFO("Created HTTP digest");
+  char response[128];
+  char nc[9];
+
+  snprintf(nc, sizeof(nc), "%08x", nonceCount_);
+  auto responseLen =
+      digestResponse(response, messageDigest, method, uri, ha1,
+                     serverNonce_, nc, clientNonce_, qop_);
+
+  digest_.reserve(128 + user_.size() + digestAuthParams.realm.size() +
+                  digestAuthParams.serverNonce.size() + uri.size() +
+                  digestAuthParams.algorithm.size() + responseLen +
+                  digestAuthParams.clientNonce.size() +
+                  digestAuthParams.opaque.size());
+  digest_ += "username=\"";
+  if (digestAuthParams.userhash) {
+    // username = H(unq(username) ":" unq(realm))
+    char userhash[128];
+    messageDigest.reset();
+    update(messageDigest, user_);
+    messageDigest.update(":", 1);
+    update(messageDigest, digestAuthParams.realm);
+    digest_.append(userhash, digestHex(userhash, messageDigest));
+  }
+  else {
+    digest_ += user_;
+  }
+  digest_ += "\", realm=\"";
+  digest_ += digestAuthParams.realm;
+  digest_ += "\", nonce=\"";
+  digest_ += digestAuthParams.serverNonce;
+  digest_ += "\", uri=\"";
+  digest_ += uri;
+  digest_ += '"';
+  if (!digestAuthParams.algorithm.empty()) {
+    digest_ += ", algorithm=";
+    digest_ += digestAuthParams.algorithm;
+  }
+  digest_ += ", response=\"";
+  digest_.append(response, responseLen);
+  digest_ += '"';
+  if (!digestAuthParams.qop.empty()) {
+    // RFC 2617 requires nc and cnonce only if qop is sent.
+    digest_ += ", qop=";
+    digest_ += digestAuthParams.qop;
+    digest_ += ", nc=";
+    digest_.append(nc, 8);
+    digest_ += ", cnonce=\"";
+    digest_ += digestAuthParams.clientNonce;
+    digest_ += '"';
+  }
+  if (!digestAuthParams.opaque.empty()) {
+    digest_ += ", opaque=\"";
+    digest_ += digestAuthParams.opaque;
+    digest_ += '"';
+  }
+  if (digestAuthParams.userhash) {
+    digest_ += ", userhash=true";
+  }
+  A2_LOG_DEBUG(fmt("Created HTTP digest, nc=%u", nonceCount_));
 }
 
 AuthConfig::~AuthConfig() = default;
 
+bool AuthConfig::verifyResponseAuth(const std::string& rspauth,
+                                    const std::string& ha1,
+                                    MessageDigest& messageDigest) const
+{
+  if (authScheme_ != AUTH_DIGEST) {
+    return false;
+  }
+  if (qop_ == "auth-int") {
+    // response-auth covers the response body, which we have not
+    // received yet.
+    return true;
+  }
+  char expected[128];
+  char nc[9];
+  snprintf(nc, sizeof(nc), "%08x", nonceCount_);
+  auto len = digestResponse(expected, messageDigest, A2STR::NIL, digestUri_,
+                            ha1, serverNonce_, nc, clientNonce_, qop_);
+  return util::strieq(std::begin(rspauth), std::end(rspauth), expected,
+                      expected + len);
+}
+
 std::string AuthConfig::getAuthText() const
 {
   if (authScheme_ == AUTH_BASIC) {
@@ -84,7 +292,7 @@ std::string AuthConfig::getAuthText() const
   } else if (authScheme_ == AUTH_DIGEST) {
     return "Digest " + digest_;
   } else {
-    return nullptr;
+    return A2STR::NIL;
   }
 }
 
@@ -99,20 +307,51 @@ std::unique_ptr<AuthConfig> AuthConfig::create(std::string user,
   }
 }
 
-std::unique_ptr<AuthConfig> AuthConfig::create(std::string user,
-                                               std::string password,
-                                               std::string path, // dir + file path
-                                               std::string method,
-                                               const std::unique_ptr<DigestAuthParams>& digestAuthParams)
+std::unique_ptr<AuthConfig>
+AuthConfig::create(std::string user, const std::string& uri,
+                   const std::string& method,
+                   const DigestAuthParams& digestAuthParams,
+                   const std::string& ha1, MessageDigest& messageDigest)
 {
   if (user.empty()) {
     return nullptr;
   }
   else {
-    return make_unique<AuthConfig>(std::move(user), std::move(password), path, method, digestAuthParams);
+    return make_unique<AuthConfig>(std::move(user), uri, method,
+                                   digestAuthParams, ha1, messageDigest);
   }
 }
 
+std::string AuthConfig::createDigestHA1(MessageDigest& messageDigest,
+                                        const std::string& user,
+                                        const std::string& realm,
+                                        const std::string& password)
+{
+  char ha1[128];
+  messageDigest.reset();
+  update(messageDigest, user);
+  messageDigest.update(":", 1);
+  update(messageDigest, realm);
+  messageDigest.update(":", 1);
+  update(messageDigest, password);
+  return std::string(ha1, digestHex(ha1, messageDigest));
+}
+
+std::string AuthConfig::createDigestSessionHA1(MessageDigest& messageDigest,
+                                               const std::string& ha1,
+                                               const std::string& serverNonce,
+                                               const std::string& clientNonce)
+{
+  char sessionHA1[128];
+  messageDigest.reset();
+  update(messageDigest, ha1);
+  messageDigest.update(":", 1);
+  update(messageDigest, serverNonce);
+  messageDigest.update(":", 1);
+  update(messageDigest, clientNonce);
+  return std::string(sessionHA1, digestHex(sessionHA1, messageDigest));
+}
+
 std::ostream& operator<<(std::ostream& o,
                          const std::shared_ptr<AuthConfig>& authConfig)
 {
@@ -40,6 +40,7 @@
 #include <string>
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 namespace aria2 {
 
@@ -59,19 +60,76 @@ struct DigestAuthParams {
   std::string response;
   std::string algorithm;
   std::string uri;
+  // The number of requests sent with serverNonce so far. It is
+  // incremented each time serverNonce is reused, and starts over when
+  // the server issues a new nonce.
+  uint32_t nonceCount;
+  // Opaque data which must be sent back to the server unchanged.
+  std::string opaque;
+  // URIs which define the protection space of realm.
+  std::vector<std::string> domain;
+  // true if the server indicated that the previous request was
+  // rejected only because its nonce was stale.
+  bool stale;
+  // true if the server supports hashed username (RFC 7616).
+  bool userhash;
+  // true if serverNonce was given in nextnonce of Authentication-Info
+  // header field rather than in a challenge.
+  bool nextNonce;
+
+  DigestAuthParams()
+      : nonceCount(0), stale(false), userhash(false), nextNonce(false)
+  {
+  }
 };
 
+// Returns the relative strength of Digest algorithm (RFC 7616), such
+// as "MD5", "SHA-256" and "SHA-512-256-sess". The larger value means
+// stronger algorithm. Empty algorithm is treated as "MD5". Returns -1
+// if algorithm is unknown or its hash function is not supported by
+// MessageDigest.
+int getDigestAlgorithmStrength(const std::string& algorithm);
+
+// Returns hash type which can be passed to MessageDigest::create()
+// for Digest algorithm, e.g., "sha-256" for "SHA-256-sess". Returns
+// empty string if algorithm is not supported.
+std::string getDigestHashType(const std::string& algorithm);
+
+// Returns true if algorithm is one of "-sess" variants.
+bool isDigestSessionAlgorithm(const std::string& algorithm);
+
+class MessageDigest;
+
 class AuthConfig {
 private:
   AuthScheme authScheme_;
   std::string user_;
   std::string password_;
   std::string digest_;
+  // nonce-count sent in Digest response. 0 for Basic.
+  uint32_t nonceCount_;
+  // true if Digest response was created without waiting for the
+  // challenge, using the nonce cached from the previous exchange.
+  bool preemptive_;
+  // The following Digest parameters are kept to verify response-auth
+  // in Authentication-Info header field.
+  std::string serverNonce_;
+  std::string clientNonce_;
+  std::string qop_;
+  std::string digestUri_;
 
 public:
   AuthConfig();
   AuthConfig(std::string user, std::string password);
-  AuthConfig(std::string user, std::string password, std::string path, std::string method, const std::unique_ptr<DigestAuthParams>& digestAuthParams);
+  // Creates Digest AuthConfig for uri and method. ha1 is hex encoded
+  // H(A1) (session H(A1) for "-sess" algorithms) and messageDigest is
+  // used to compute H(A2) and response. If qop is "auth-int", the
+  // entity body is assumed to be empty because we only send GET and
+  // HEAD requests.
+  AuthConfig(std::string user, const std::string& uri,
+             const std::string& method,
+             const DigestAuthParams& digestAuthParams, const std::string& ha1,
+             MessageDigest& messageDigest);
   ~AuthConfig();
 
   // Don't allow copying
@@ -84,13 +142,41 @@ public:
 
   const std::string& getPassword() const { return password_; }
 
+  AuthScheme getAuthScheme() const { return authScheme_; }
+
+  uint32_t getNonceCount() const { return nonceCount_; }
+
+  bool isPreemptive() const { return preemptive_; }
+
+  const std::string& getServerNonce() const { return serverNonce_; }
+
+  // Returns true if rspauth, the response-auth in Authentication-Info
+  // header field, matches the one computed from this Digest
+  // AuthConfig. ha1 is the same H(A1) used to create this object.
+  // Returns false if this is not Digest AuthConfig.
+  bool verifyResponseAuth(const std::string& rspauth, const std::string& ha1,
+                          MessageDigest& messageDigest) const;
+
   static std::unique_ptr<AuthConfig> create(std::string user,
                                             std::string password);
-  static std::unique_ptr<AuthConfig> create(std::string user,
-                                            std::string password,
-                                            std::string path, // dir + file path
-                                            std::string method,
-                                            const std::unique_ptr<DigestAuthParams>& digestAuthParams);
+  static std::unique_ptr<AuthConfig>
+  create(std::string user, const std::string& uri, const std::string& method,
+         const DigestAuthParams& digestAuthParams, const std::string& ha1,
+         MessageDigest& messageDigest);
+
+  // Returns hex encoded H(user ":" realm ":" password) computed using
+  // messageDigest.
+  static std::string createDigestHA1(MessageDigest& messageDigest,
+                                     const std::string& user,
+                                     const std::string& realm,
+                                     const std::string& password);
+
+  // Returns hex encoded session H(A1) for "-sess" algorithms, that is
+  // H(ha1 ":" serverNonce ":" clientNonce).
+  static std::string createDigestSessionHA1(MessageDigest& messageDigest,
+                                            const std::string& ha1,
+                                            const std::string& serverNonce,
+                                            const std::string& clientNonce);
 };
 
 std::ostream& operator<<(std::ostream& o,
@@ -35,6 +35,7 @@
 #include "AuthConfigFactory.h"
 
 #include <algorithm>
+#include <array>
 
 #include "Option.h"
 #include "AuthConfig.h"
@@ -44,6 +45,10 @@
 #include "prefs.h"
 #include "Request.h"
 #include "util.h"
+#include "uri.h"
+#include "fmt.h"
+#include "LogFactory.h"
+#include "HttpHeader.h"
 
 namespace aria2 {
 
@@ -52,6 +57,15 @@ const std::string AUTH_DEFAULT_USER("anonymous");
 const std::string AUTH_DEFAULT_PASSWD("ARIA2USER@");
 } // namespace
 
+namespace {
+std::string createClientNonce()
+{
+  std::array<unsigned char, 8> buf;
+  util::generateRandomData(buf.data(), buf.size());
+  return util::toHex(buf.data(), buf.size());
+}
+} // namespace
+
 AuthConfigFactory::AuthConfigFactory() {}
 
 AuthConfigFactory::~AuthConfigFactory() = default;
@@ -61,9 +75,18 @@ AuthConfigFactory::createAuthConfig(const std::shared_ptr<Request>& request,
                                     const Option* op)
 {
   if (request->getProtocol() == "http" || request->getProtocol() == "https") {
+    auto i = findAuthCred(request->getHost(), request->getPort(),
+                          request->getDir());
+    if (i != std::end(authCreds_) && (*i)->isDigest()) {
+      // The server has already challenged us with Digest in this
+      // protection space.  Answer preemptively using the cached nonce
+      // so that we don't pay extra round trip for 401 response.
+      auto uri = request->getDir();
+      uri += request->getFile();
+      uri += request->getQuery();
+      return createDigestAuthConfig(*(*i), request->getMethod(), uri);
+    }
     if (op->getAsBool(PREF_HTTP_AUTH_CHALLENGE)) {
-      auto i = findAuthCred(request->getHost(), request->getPort(),
-                             request->getDir());
       if (i == std::end(authCreds_)) {
         if (!request->getUsername().empty()) {
           updateAuthCred(make_unique<AuthCred>(
@@ -76,15 +99,7 @@ AuthConfigFactory::createAuthConfig(const std::shared_ptr<Request>& request,
         }
       }
       else {
-        if ((*i)->isDigest()) {
-          return AuthConfig::create((*i)->user_,
-                                     (*i)->password_,
-                                     request->getDir() + request->getFile(),
-                                     request->getMethod(),
-                                     (*i)->getDigestAuthParams());
-        } else {
-          return AuthConfig::create((*i)->user_, (*i)->password_);
-        }
+        return AuthConfig::create((*i)->user_, (*i)->password_);
       }
     }
     else {
@@ -135,6 +150,85 @@ AuthConfigFactory::createAuthConfig(const std::shared_ptr<Request>& request,
   }
 }
 
+std::unique_ptr<AuthConfig>
+AuthConfigFactory::createDigestAuthConfig(AuthCred& authCred,
+                                          const std::string& method,
+                                          const std::string& uri)
+{
+  const auto& digestAuthParams = authCred.getDigestAuthParams();
+  ++digestAuthParams->nonceCount;
+  auto sess = isDigestSessionAlgorithm(digestAuthParams->algorithm);
+  // For "-sess" algorithms, client nonce is a part of session H(A1),
+  // so we keep using the same one until server nonce changes.
+  if (!sess || digestAuthParams->clientNonce.empty()) {
+    digestAuthParams->clientNonce = createClientNonce();
+  }
+  if (!authCred.messageDigest_) {
+    authCred.messageDigest_ =
+        MessageDigest::create(getDigestHashType(digestAuthParams->algorithm));
+  }
+  if (authCred.digestHA1_.empty()) {
+    authCred.digestHA1_ = AuthConfig::createDigestHA1(
+        *authCred.messageDigest_, authCred.user_, digestAuthParams->realm,
+        authCred.password_);
+  }
+  if (sess && authCred.digestSessionHA1_.empty()) {
+    authCred.digestSessionHA1_ = AuthConfig::createDigestSessionHA1(
+        *authCred.messageDigest_, authCred.digestHA1_,
+        digestAuthParams->serverNonce, digestAuthParams->clientNonce);
+  }
+  return AuthConfig::create(
+      authCred.user_, uri, method, *digestAuthParams,
+      sess ? authCred.digestSessionHA1_ : authCred.digestHA1_,
+      *authCred.messageDigest_);
+}
+
+std::unique_ptr<AuthConfig> AuthConfigFactory::createProxyAuthConfig(
+    const std::shared_ptr<Request>& proxyRequest, const std::string& method,
+    const std::string& uri)
+{
+  if (proxyRequest->getUsername().empty()) {
+    return nullptr;
+  }
+  auto bc = make_unique<AuthCred>("", "", proxyRequest->getHost(),
+                                  proxyRequest->getPort(), "/");
+  auto i = proxyAuthCreds_.find(bc);
+  if (i != std::end(proxyAuthCreds_) &&
+      (*i)->user_ == proxyRequest->getUsername() &&
+      (*i)->password_ == proxyRequest->getPassword()) {
+    return createDigestAuthConfig(*(*i), method, uri);
+  }
+  return AuthConfig::create(proxyRequest->getUsername(),
+                            proxyRequest->getPassword());
+}
+
+bool AuthConfigFactory::activateProxyAuthCred(
+    const std::shared_ptr<Request>& proxyRequest,
+    std::unique_ptr<DigestAuthParams> digestAuthParams)
+{
+  if (proxyRequest->getUsername().empty()) {
+    return false;
+  }
+  std::shared_ptr<DigestAuthParams> params = std::move(digestAuthParams);
+  auto c = make_unique<AuthCred>(
+      proxyRequest->getUsername(), proxyRequest->getPassword(),
+      proxyRequest->getHost(), proxyRequest->getPort(), "/", params, true);
+  auto i = proxyAuthCreds_.lower_bound(c);
+  if (i != std::end(proxyAuthCreds_) && *(*i) == *c) {
+    if ((*i)->user_ == c->user_ && (*i)->password_ == c->password_) {
+      // Keep cached H(A1) if realm is unchanged.
+      (*i)->upgradeToDigest(std::move(params));
+    }
+    else {
+      *(*i) = std::move(*c);
+    }
+  }
+  else {
+    proxyAuthCreds_.insert(i, std::move(c));
+  }
+  return true;
+}
+
 std::unique_ptr<AuthResolver>
 AuthConfigFactory::createHttpAuthResolver(const Option* op) const
 {
@@ -193,24 +287,139 @@ bool AuthConfigFactory::activateAuthCred(const std::string& host,
                                          const Option* op,
                                          std::unique_ptr<DigestAuthParams> digestAuthParams)
 {
+  std::shared_ptr<DigestAuthParams> params = std::move(digestAuthParams);
+  AuthCred* authCred;
   auto i = findAuthCred(host, port, path);
   if (i == std::end(authCreds_)) {
     auto authConfig = createHttpAuthResolver(op)->resolveAuthConfig(host);
     if (!authConfig) {
       return false;
     }
-    else {
-      authCreds_.insert(make_unique<AuthCred>(authConfig->getUser(),
-                                              authConfig->getPassword(), host,
-                                              port, path, std::move(digestAuthParams), true));
-      return true;
-    }
+    auto c = make_unique<AuthCred>(authConfig->getUser(),
+                                   authConfig->getPassword(), host, port,
+                                   path, params, true);
+    authCred = c.get();
+    authCreds_.insert(std::move(c));
   }
   else {
-    (*i)->activate();
-    (*i)->upgradeToDigest(std::move(digestAuthParams));
+    authCred = (*i).get();
+    auto oldParams = authCred->getDigestAuthParams();
+    if (oldParams) {
+      replaceDigestAuthParams(oldParams, params);
+    }
+    authCred->activate();
+    authCred->upgradeToDigest(params);
+  }
+  registerDigestDomain(*authCred, host, port);
+  return true;
+}
+
+void AuthConfigFactory::replaceDigestAuthParams(
+    const std::shared_ptr<DigestAuthParams>& oldParams,
+    const std::shared_ptr<DigestAuthParams>& newParams)
+{
+  // Hold oldParams here because upgradeToDigest() may release the
+  // last reference to it.
+  auto params = oldParams;
+  for (auto& c : authCreds_) {
+    if (c->getDigestAuthParams() == params) {
+      c->upgradeToDigest(newParams);
+    }
+  }
+}
+
+bool AuthConfigFactory::updateDigestAuthInfo(
+    const std::shared_ptr<Request>& request, const AuthConfig& authConfig,
+    const std::string& authInfo)
+{
+  auto i = findAuthCred(request->getHost(), request->getPort(),
+                        request->getDir());
+  if (i == std::end(authCreds_) || !(*i)->isDigest()) {
     return true;
   }
+  auto& authCred = *(*i);
+  auto params = authCred.getDigestAuthParams();
+  if (params->serverNonce != authConfig.getServerNonce()) {
+    // The nonce has been replaced since the request was sent, maybe
+    // by the response on another connection.
+    return true;
+  }
+  std::string rspauth;
+  std::string nextnonce;
+  for (auto& p : parseAuthParams(authInfo)) {
+    if (p.first == "rspauth") {
+      rspauth = std::move(p.second);
+    }
+    else if (p.first == "nextnonce") {
+      nextnonce = std::move(p.second);
+    }
+  }
+  // Verify rspauth before nextnonce is applied, because the new nonce
+  // clears H(A1) of -sess algorithms.
+  if (!rspauth.empty()) {
+    if (!authCred.messageDigest_) {
+      return false;
+    }
+    const auto& ha1 = isDigestSessionAlgorithm(params->algorithm)
+                          ? authCred.digestSessionHA1_
+                          : authCred.digestHA1_;
+    if (!authConfig.verifyResponseAuth(rspauth, ha1,
+                                       *authCred.messageDigest_)) {
+      A2_LOG_INFO(fmt("Digest response-auth mismatch for %s:%u%s",
+                      request->getHost().c_str(), request->getPort(),
+                      request->getDir().c_str()));
+      return false;
+    }
+  }
+  if (!nextnonce.empty() && nextnonce != params->serverNonce) {
+    auto newParams = std::make_shared<DigestAuthParams>(*params);
+    newParams->serverNonce = std::move(nextnonce);
+    newParams->nonceCount = 0;
+    newParams->clientNonce.clear();
+    newParams->stale = false;
+    newParams->nextNonce = true;
+    A2_LOG_DEBUG(fmt("Digest nextnonce received for %s:%u%s",
+                     request->getHost().c_str(), request->getPort(),
+                     request->getDir().c_str()));
+    replaceDigestAuthParams(params, newParams);
+  }
+  return true;
+}
+
+void AuthConfigFactory::registerDigestDomain(const AuthCred& authCred,
+                                             const std::string& host,
+                                             uint16_t port)
+{
+  const auto& params = authCred.getDigestAuthParams();
+  for (const auto& domain : params->domain) {
+    std::string path;
+    if (util::startsWith(domain, "/")) {
+      path = domain;
+    }
+    else {
+      uri::UriStruct us;
+      if (!uri::parse(us, domain) || us.host != host || us.port != port) {
+        continue;
+      }
+      path = us.dir;
+      path += us.file;
+    }
+    auto c = make_unique<AuthCred>(authCred.user_, authCred.password_, host,
+                                   port, path, params, true);
+    auto j = authCreds_.lower_bound(c);
+    if (j != std::end(authCreds_) && *(*j) == *c) {
+      if ((*j)->user_ == authCred.user_ &&
+          (*j)->getDigestAuthParams() != params) {
+        (*j)->activate();
+        (*j)->upgradeToDigest(params);
+      }
+    }
+    else {
+      A2_LOG_DEBUG(fmt("Registered Digest protection space %s:%u%s",
+                       host.c_str(), port, c->path_.c_str()));
+      authCreds_.insert(j, std::move(c));
+    }
+  }
 }
 
 bool AuthConfigFactory::activateAuthCred(const std::string& host,
@@ -252,20 +461,34 @@ AuthCred::AuthCred(std::string user, std::string password, std::string host,
 }
 
 AuthCred::AuthCred(std::string user, std::string password, std::string host,
-                   uint16_t port, std::string path, std::unique_ptr<DigestAuthParams> digestAuthParams, bool activated)
+                   uint16_t port, std::string path, std::shared_ptr<DigestAuthParams> digestAuthParams, bool activated)
     : user_(std::move(user)),
       password_(std::move(password)),
       host_(std::move(host)),
       port_(port),
       path_(std::move(path)),
-      digestAuthParams_(std::move(digestAuthParams)),
-      activated_(activated)
+      activated_(activated),
+      digestAuthParams_(std::move(digestAuthParams))
 {
   if (path_.empty() || path_[path_.size() - 1] != '/') {
     path_ += "/";
   }
 }
 
+void AuthCred::upgradeToDigest(
+    std::shared_ptr<DigestAuthParams> digestAuthParams)
+{
+  if (!digestAuthParams_ || !digestAuthParams ||
+      digestAuthParams_->realm != digestAuthParams->realm ||
+      getDigestHashType(digestAuthParams_->algorithm) !=
+          getDigestHashType(digestAuthParams->algorithm)) {
+    digestHA1_.clear();
+    messageDigest_.reset();
+  }
+  digestSessionHA1_.clear();
+  digestAuthParams_ = std::move(digestAuthParams);
+}
+
 void AuthCred::activate() { activated_ = true; }
 
 bool AuthCred::isActivated() const { return activated_; }
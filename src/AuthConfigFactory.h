@@ -42,6 +42,7 @@
 #include <memory>
 
 #include "AuthConfig.h"
+#include "MessageDigest.h"
 #include "SingletonHolder.h"
 #include "a2functional.h"
 
@@ -61,18 +62,32 @@ public:
   uint16_t port_;
   std::string path_;
   bool activated_;
-  std::unique_ptr<DigestAuthParams> digestAuthParams_;
+  // Shared among AuthCreds in the same protection space so that they
+  // use the same nonce and nonce-count.
+  std::shared_ptr<DigestAuthParams> digestAuthParams_;
+  // H(A1) for Digest authentication. It only depends on user, realm
+  // and password, so it is computed once and reused until the realm
+  // changes.
+  std::string digestHA1_;
+  // Session H(A1) for "-sess" algorithms. It also depends on server
+  // nonce and client nonce, so it is discarded when server nonce
+  // changes.
+  std::string digestSessionHA1_;
+  // Hash context reused to compute H(A2) and response for each
+  // request.
+  std::unique_ptr<MessageDigest> messageDigest_;
 
   AuthCred(std::string user, std::string password, std::string host,
             uint16_t port, std::string path, bool activated = false);
   AuthCred(std::string user, std::string password, std::string host,
-            uint16_t port, std::string path, std::unique_ptr<DigestAuthParams> digestAuthParams, bool activated = false);
+            uint16_t port, std::string path, std::shared_ptr<DigestAuthParams> digestAuthParams, bool activated = false);
 
-  void upgradeToDigest(std::unique_ptr<DigestAuthParams> digestAuthParams) {
-    digestAuthParams_ = std::move(digestAuthParams);
-  }
+  // Replaces cached Digest parameters with digestAuthParams. The
+  // cached H(A1) is discarded if realm or algorithm has changed. The
+  // cached session H(A1) is always discarded.
+  void upgradeToDigest(std::shared_ptr<DigestAuthParams> digestAuthParams);
 
-  const std::unique_ptr<DigestAuthParams>& getDigestAuthParams() const {
+  const std::shared_ptr<DigestAuthParams>& getDigestAuthParams() const {
     return digestAuthParams_;
   }
 
@@ -100,8 +115,33 @@ private:
 
   std::unique_ptr<AuthResolver> createFtpAuthResolver(const Option* op) const;
 
+  // Creates Digest AuthConfig for method and uri, the request-target,
+  // using the server nonce cached in authCred. The nonce-count is
+  // incremented and a fresh client nonce is generated for each
+  // call. H(A1) is computed on first use and cached in authCred.
+  std::unique_ptr<AuthConfig> createDigestAuthConfig(AuthCred& authCred,
+                                                     const std::string& method,
+                                                     const std::string& uri);
+
+  // Registers the URIs listed in domain parameter of authCred's
+  // Digest challenge as the same protection space, so that requests
+  // to them are authenticated preemptively. Only URIs on host and
+  // port are registered.
+  void registerDigestDomain(const AuthCred& authCred, const std::string& host,
+                            uint16_t port);
+
+  // Replaces oldParams with newParams in all AuthCreds sharing
+  // oldParams.
+  void
+  replaceDigestAuthParams(const std::shared_ptr<DigestAuthParams>& oldParams,
+                          const std::shared_ptr<DigestAuthParams>& newParams);
+
   BasicCredSet authCreds_;
 
+  // AuthCreds for proxies which challenged us with Digest. The path
+  // of each AuthCred is always "/".
+  BasicCredSet proxyAuthCreds_;
+
 public:
   AuthConfigFactory();
 
@@ -110,14 +150,37 @@ public:
   // Creates AuthConfig object for request. Following option values
   // are used in this method: PREF_HTTP_USER, PREF_HTTP_PASSWD,
   // PREF_FTP_USER, PREF_FTP_PASSWD, PREF_NO_NETRC and
-  // PREF_HTTP_AUTH_CHALLENGE.
+  // PREF_HTTP_AUTH_CHALLENGE. If the server challenged us with Digest
+  // for the protection space of request, Digest AuthConfig is
+  // returned regardless of PREF_HTTP_AUTH_CHALLENGE.
   std::unique_ptr<AuthConfig>
   createAuthConfig(const std::shared_ptr<Request>& request, const Option* op);
 
+  // Creates AuthConfig to authenticate with the proxy given in
+  // proxyRequest. If the proxy has challenged us with Digest, Digest
+  // AuthConfig for method and uri, the request-target sent to the
+  // proxy, is returned using the cached nonce. Otherwise, Basic
+  // AuthConfig is returned. Returns nullptr if proxyRequest has no
+  // user name.
+  std::unique_ptr<AuthConfig>
+  createProxyAuthConfig(const std::shared_ptr<Request>& proxyRequest,
+                        const std::string& method, const std::string& uri);
+
+  // Caches digestAuthParams received in Proxy-Authenticate header
+  // field from the proxy given in proxyRequest, so that subsequent
+  // requests to the proxy, including CONNECT on new connections, are
+  // authenticated with Digest preemptively. Returns false if
+  // proxyRequest has no user name.
+  bool activateProxyAuthCred(const std::shared_ptr<Request>& proxyRequest,
+                             std::unique_ptr<DigestAuthParams> digestAuthParams);
+
   void setNetrc(std::unique_ptr<Netrc> netrc);
 
   // Find a AuthCred using findAuthCred() and activate it then
-  // return true.  If matching AuthCred is not found, AuthConfig
+  // return true.  If digestAuthParams is given, it replaces the
+  // cached Digest parameters of AuthCred and the other AuthCreds
+  // sharing them, and its nonce-count starts over. The paths in its
+  // domain parameter are registered as well.  If matching AuthCred is not found, AuthConfig
   // object is created using createHttpAuthResolver and op.  If it is
   // null, then returns false. Otherwise new AuthCred is created
   // using this AuthConfig object with given host and path "/" and
@@ -128,6 +191,17 @@ public:
                          const std::string& path, const Option* op,
                          std::unique_ptr<DigestAuthParams> digestAuthParams);
 
+  // Processes Authentication-Info header field value authInfo (RFC
+  // 7615) received in response to request authenticated with
+  // authConfig.  If it carries rspauth, it is verified against the
+  // cached H(A1), and false is returned if it does not match.  If it
+  // carries nextnonce, the nonce of the protection space is replaced
+  // with it and nonce-count starts over, so that the next request
+  // can be authenticated preemptively.  Otherwise returns true.
+  bool updateDigestAuthInfo(const std::shared_ptr<Request>& request,
+                            const AuthConfig& authConfig,
+                            const std::string& authInfo);
+
   // Find a AuthCred using host, port and path and return the
   // iterator pointing to it. If not found, then return
   // authCreds_.end().
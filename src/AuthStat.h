@@ -0,0 +1,81 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2012 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_AUTH_STAT_H
+#define D_AUTH_STAT_H
+
+#include "common.h"
+
+namespace aria2 {
+
+// Counters of HTTP authentication handshakes, kept per RequestGroup
+// and globally in RequestGroupMan.
+struct AuthStat {
+  AuthStat()
+      : challenges(0),
+        preemptiveHits(0),
+        preemptiveMisses(0),
+        staleNonceRetries(0),
+        retryTime(0)
+  {
+  }
+
+  AuthStat& operator+=(const AuthStat& stat)
+  {
+    challenges += stat.challenges;
+    preemptiveHits += stat.preemptiveHits;
+    preemptiveMisses += stat.preemptiveMisses;
+    staleNonceRetries += stat.staleNonceRetries;
+    retryTime += stat.retryTime;
+    return *this;
+  }
+
+  // The number of 401 and 407 responses received.
+  int64_t challenges;
+  // The number of requests authorized preemptively with cached
+  // Digest nonce which were accepted by the server.
+  int64_t preemptiveHits;
+  // The number of requests authorized preemptively with cached
+  // Digest nonce which were challenged again.
+  int64_t preemptiveMisses;
+  // The number of challenges which told us that the nonce was stale.
+  int64_t staleNonceRetries;
+  // Cumulative time in milliseconds from sending requests to
+  // receiving 401 or 407 responses to them.
+  int64_t retryTime;
+};
+
+} // namespace aria2
+
+#endif // D_AUTH_STAT_H
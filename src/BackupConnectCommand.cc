@@ -32,7 +32,7 @@
  * files in the program, then also delete it here.
  */
 /* copyright --> */
-#include "BackupIPv4ConnectCommand.h"
+#include "BackupConnectCommand.h"
 #include "RequestGroup.h"
 #include "DownloadEngine.h"
 #include "SocketCore.h"
@@ -47,26 +47,29 @@ namespace aria2 {
 
 BackupConnectInfo::BackupConnectInfo() : cancel(false) {}
 
-BackupIPv4ConnectCommand::BackupIPv4ConnectCommand(
-    cuid_t cuid, const std::string& ipaddr, uint16_t port,
+BackupConnectCommand::BackupConnectCommand(
+    cuid_t cuid, const std::string& hostname, const std::string& ipaddr,
+    uint16_t port, std::chrono::milliseconds delay,
     const std::shared_ptr<BackupConnectInfo>& info, Command* mainCommand,
     RequestGroup* requestGroup, DownloadEngine* e)
     : Command(cuid),
+      hostname_(hostname),
       ipaddr_(ipaddr),
       port_(port),
+      delay_(delay),
       info_(info),
       mainCommand_(mainCommand),
       requestGroup_(requestGroup),
       e_(e),
       startTime_(global::wallclock()),
-      timeoutCheck_(global::wallclock()),
+      timeoutCheck_(Timer::zero()),
       timeout_(requestGroup_->getOption()->getAsInt(PREF_CONNECT_TIMEOUT))
 {
   requestGroup_->increaseStreamCommand();
   requestGroup_->increaseNumCommand();
 }
 
-BackupIPv4ConnectCommand::~BackupIPv4ConnectCommand()
+BackupConnectCommand::~BackupConnectCommand()
 {
   requestGroup_->decreaseNumCommand();
   requestGroup_->decreaseStreamCommand();
@@ -75,7 +78,7 @@ BackupIPv4ConnectCommand::~BackupIPv4ConnectCommand()
   }
 }
 
-bool BackupIPv4ConnectCommand::execute()
+bool BackupConnectCommand::execute()
 {
   bool retval = false;
   if (requestGroup_->downloadFinished() || requestGroup_->isHaltRequested()) {
@@ -86,14 +89,24 @@ bool BackupIPv4ConnectCommand::execute()
         fmt("CUID#%" PRId64 " - Backup connection canceled", getCuid()));
     retval = true;
   }
+  else if (!info_->ipaddr.empty()) {
+    A2_LOG_INFO(fmt("CUID#%" PRId64 " - Backup connection to %s lost the race"
+                    " against %s",
+                    getCuid(), ipaddr_.c_str(), info_->ipaddr.c_str()));
+    retval = true;
+  }
   else if (socket_) {
     if (writeEventEnabled()) {
       try {
         std::string error = socket_->getSocketError();
         if (error.empty()) {
+          auto rtt = std::chrono::duration_cast<std::chrono::milliseconds>(
+              timeoutCheck_.difference(global::wallclock()));
           A2_LOG_INFO(fmt("CUID#%" PRId64 " - Backup connection to %s "
-                          "established",
-                          getCuid(), ipaddr_.c_str()));
+                          "established in %" PRId64 "ms",
+                          getCuid(), ipaddr_.c_str(),
+                          static_cast<int64_t>(rtt.count())));
+          e_->updateIPAddressRTT(hostname_, ipaddr_, port_, rtt);
           info_->ipaddr = ipaddr_;
           e_->deleteSocketForWriteCheck(socket_, this);
           info_->socket.swap(socket_);
@@ -102,43 +115,48 @@ bool BackupIPv4ConnectCommand::execute()
           retval = true;
         }
         else {
-          A2_LOG_INFO(fmt("CUID#%" PRId64 " - Backup connection failed: %s",
-                          getCuid(), error.c_str()));
+          A2_LOG_INFO(fmt("CUID#%" PRId64 " - Backup connection to %s failed:"
+                          " %s",
+                          getCuid(), ipaddr_.c_str(), error.c_str()));
+          e_->markBadIPAddress(hostname_, ipaddr_, port_);
           retval = true;
         }
       }
       catch (RecoverableException& e) {
         A2_LOG_INFO_EX(
             fmt("CUID#%" PRId64 " - Backup connection failed", getCuid()), e);
+        e_->markBadIPAddress(hostname_, ipaddr_, port_);
         retval = true;
       }
     }
+    else if (timeoutCheck_.difference(global::wallclock()) >= timeout_) {
+      A2_LOG_INFO(fmt("CUID#%" PRId64 " - Backup connection command timeout",
+                      getCuid()));
+      e_->markBadIPAddress(hostname_, ipaddr_, port_);
+      retval = true;
+    }
   }
-  else if (!socket_) {
-    // TODO Although we check 300ms initial timeout as described in
-    // RFC 6555, the interval will be much longer and around 1 second
-    // due to the refresh interval mechanism in DownloadEngine.
-    if (startTime_.difference(global::wallclock()) >=
-        std::chrono::milliseconds(300)) {
+  else {
+    // TODO Although we stagger attempts in 250ms steps as described
+    // in RFC 8305, the interval may be longer due to the refresh
+    // interval mechanism in DownloadEngine.
+    if (startTime_.difference(global::wallclock()) >= delay_) {
       socket_ = std::make_shared<SocketCore>();
       try {
+        // The stagger delay does not count toward the timeout and RTT.
+        timeoutCheck_ = global::wallclock();
         socket_->establishConnection(ipaddr_, port_);
         e_->addSocketForWriteCheck(socket_, this);
-        timeoutCheck_ = global::wallclock();
       }
       catch (RecoverableException& e) {
         A2_LOG_INFO_EX(
             fmt("CUID#%" PRId64 " - Backup connection failed", getCuid()), e);
+        e_->markBadIPAddress(hostname_, ipaddr_, port_);
         socket_.reset();
         retval = true;
       }
     }
   }
-  else if (timeoutCheck_.difference(global::wallclock()) >= timeout_) {
-    A2_LOG_INFO(
-        fmt("CUID#%" PRId64 " - Backup connection command timeout", getCuid()));
-    retval = true;
-  }
   if (!retval) {
     e_->addCommand(std::unique_ptr<Command>(this));
   }
@@ -32,8 +32,8 @@
  * files in the program, then also delete it here.
  */
 /* copyright --> */
-#ifndef BACKUP_IPV4_CONNECT_COMMAND_H
-#define BACKUP_IPV4_CONNECT_COMMAND_H
+#ifndef BACKUP_CONNECT_COMMAND_H
+#define BACKUP_CONNECT_COMMAND_H
 
 #include "Command.h"
 
@@ -48,11 +48,13 @@ class RequestGroup;
 class DownloadEngine;
 class SocketCore;
 
-// Used to communicate mainCommand and backup IPv4 connection command.
-// When backup connection succeeds, ipaddr is filled with connected
-// IPv4 address and socket is a socket connected to the ipaddr.  If
-// mainCommand wants to cancel backup connection command, cancel
-// member becomes true.
+// Used to communicate mainCommand and backup connection commands.
+// All backup commands issued for one mainCommand share the same
+// object.  When one of the backup connections succeeds first, ipaddr
+// is filled with connected address and socket is a socket connected
+// to the ipaddr.  The other backup commands see non-empty ipaddr and
+// give up.  If mainCommand wants to cancel backup connection
+// commands, cancel member becomes true.
 struct BackupConnectInfo {
   std::string ipaddr;
   std::shared_ptr<SocketCore> socket;
@@ -60,31 +62,36 @@ struct BackupConnectInfo {
   BackupConnectInfo();
 };
 
-// Make backup connection to IPv4 address. This is a simplest RFC 6555
-// "Happy Eyeballs" implementation.
-class BackupIPv4ConnectCommand : public Command {
+// Make backup connection to |ipaddr| after |delay| has passed, racing
+// against mainCommand and the other backup commands.  This is RFC
+// 8305 "Happy Eyeballs Version 2" connection attempt.
+class BackupConnectCommand : public Command {
 public:
-  BackupIPv4ConnectCommand(cuid_t cuid, const std::string& ipaddr,
-                           uint16_t port,
-                           const std::shared_ptr<BackupConnectInfo>& info,
-                           Command* mainCommand, RequestGroup* requestGroup,
-                           DownloadEngine* e);
-  ~BackupIPv4ConnectCommand();
+  BackupConnectCommand(cuid_t cuid, const std::string& hostname,
+                       const std::string& ipaddr, uint16_t port,
+                       std::chrono::milliseconds delay,
+                       const std::shared_ptr<BackupConnectInfo>& info,
+                       Command* mainCommand, RequestGroup* requestGroup,
+                       DownloadEngine* e);
+  ~BackupConnectCommand();
   virtual bool execute() CXX11_OVERRIDE;
 
 private:
+  std::string hostname_;
   std::string ipaddr_;
   uint16_t port_;
+  std::chrono::milliseconds delay_;
   std::shared_ptr<SocketCore> socket_;
   std::shared_ptr<BackupConnectInfo> info_;
   Command* mainCommand_;
   RequestGroup* requestGroup_;
   DownloadEngine* e_;
   Timer startTime_;
+  // Started when the socket is opened.
   Timer timeoutCheck_;
   std::chrono::seconds timeout_;
 };
 
 } // namespace aria2
 
-#endif // BACKUP_IPV4_CONNECT_COMMAND_H
+#endif // BACKUP_CONNECT_COMMAND_H
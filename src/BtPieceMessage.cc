@@ -61,6 +61,10 @@
 #include "WrDiskCacheEntry.h"
 #include "DownloadFailureException.h"
 #include "BtRejectMessage.h"
+#include "HashWorkerPool.h"
+#include "RequestGroup.h"
+#include "RdDiskCache.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -131,9 +135,16 @@ void BtPieceMessage::doReceivedAction()
     A2_LOG_DEBUG(fmt(
         MSG_PIECE_BITFIELD, getCuid(),
         util::toHex(piece->getBitfield(), piece->getBitfieldLength()).c_str()));
-    piece->updateHash(begin_, data_ + 9, blockLength_);
+    if (!HashWorkerPool::getInstance() || !piece->getWrDiskCacheEntry()) {
+      piece->updateHash(begin_, data_ + 9, blockLength_);
+    }
+    // Otherwise, the piece is verified in HashWorkerPool using the
+    // cached data when it completes.
     getBtMessageDispatcher()->removeOutstandingRequest(slot);
     if (piece->pieceComplete()) {
+      if (checkPieceHashAsync(piece)) {
+        return;
+      }
       if (checkPieceHash(piece)) {
         onNewPiece(piece);
       }
@@ -218,8 +229,19 @@ void BtPieceMessage::pushPieceData(int64_t offset, int32_t length) const
   auto buf = std::vector<unsigned char>(length + MESSAGE_HEADER_LENGTH);
   createMessageHeader(buf.data());
   ssize_t r;
-  r = getPieceStorage()->getDiskAdaptor()->readData(
-      buf.data() + MESSAGE_HEADER_LENGTH, length, offset);
+  auto cache = RdDiskCache::getInstance();
+  if (cache &&
+      cache->readData(buf.data() + MESSAGE_HEADER_LENGTH, length, begin_,
+                      downloadContext_->getOwnerRequestGroup(), index_,
+                      offset - begin_,
+                      getPieceStorage()->getPieceLength(index_),
+                      getPieceStorage()->getDiskAdaptor().get())) {
+    r = length;
+  }
+  else {
+    r = getPieceStorage()->getDiskAdaptor()->readData(
+        buf.data() + MESSAGE_HEADER_LENGTH, length, offset);
+  }
   if (r == length) {
     const auto& peer = getPeer();
     getPeerConnection()->pushBytes(
@@ -262,6 +284,79 @@ bool BtPieceMessage::checkPieceHash(const std::shared_ptr<Piece>& piece)
   }
 }
 
+namespace {
+// Completes or discards the piece when its hash calculated by
+// HashWorkerPool arrives.  Unlike the synchronous path, the
+// connection to the peer which sent bad data is kept.
+struct PieceHashCallback {
+  std::shared_ptr<Piece> piece;
+  PieceStorage* pieceStorage;
+  PeerStorage* peerStorage;
+  DownloadContext* downloadContext;
+  cuid_t cuid;
+  std::string ipaddr;
+
+  void operator()(const std::string& digest) const
+  {
+    auto index = static_cast<unsigned long>(piece->getIndex());
+    if (digest != downloadContext->getPieceHash(piece->getIndex())) {
+      A2_LOG_INFO(fmt(MSG_GOT_WRONG_PIECE, cuid, index));
+      piece->clearAllBlock(pieceStorage->getWrDiskCache());
+      pieceStorage->cancelPiece(piece, cuid);
+      peerStorage->addBadPeer(ipaddr);
+      return;
+    }
+    if (piece->getWrDiskCacheEntry()) {
+      piece->flushWrCache(pieceStorage->getWrDiskCache());
+      if (piece->getWrDiskCacheEntry()->getError() !=
+          WrDiskCacheEntry::CACHE_ERR_SUCCESS) {
+        piece->clearAllBlock(pieceStorage->getWrDiskCache());
+        auto msg = fmt("Write disk cache flush failure index=%lu", index);
+        A2_LOG_ERROR(msg);
+        auto group = downloadContext->getOwnerRequestGroup();
+        group->setLastErrorCode(piece->getWrDiskCacheEntry()->getErrorCode(),
+                                msg.c_str());
+        group->setHaltRequested(true);
+        return;
+      }
+    }
+    A2_LOG_INFO(fmt(MSG_GOT_NEW_PIECE, cuid, index));
+    pieceStorage->completePiece(piece);
+    pieceStorage->advertisePiece(cuid, piece->getIndex(), global::wallclock());
+  }
+};
+} // namespace
+
+bool BtPieceMessage::checkPieceHashAsync(const std::shared_ptr<Piece>& piece)
+{
+  auto pool = HashWorkerPool::getInstance();
+  auto group = downloadContext_->getOwnerRequestGroup();
+  if (!pool || !group ||
+      (!getPieceStorage()->isEndGame() && piece->isHashCalculated()) ||
+      !pool->hasRoom(piece->getLength())) {
+    return false;
+  }
+  A2_LOG_DEBUG(fmt("Calculating hash in background index=%lu",
+                   static_cast<unsigned long>(piece->getIndex())));
+  std::vector<unsigned char> data;
+  try {
+    // Copy the data now, because the cache may be flushed before the
+    // hash is calculated.
+    data = piece->getDataWithWrCache(downloadContext_->getPieceLength(),
+                                     getPieceStorage()->getDiskAdaptor());
+  }
+  catch (RecoverableException& e) {
+    piece->clearAllBlock(getPieceStorage()->getWrDiskCache());
+    throw;
+  }
+  piece->destroyHashContext();
+  pool->submit(group, piece->getHashType(), std::move(data),
+               PieceHashCallback{piece, getPieceStorage(), peerStorage_,
+                                 downloadContext_, getCuid(),
+                                 getPeer()->getIPAddress()});
+  return true;
+}
+
 void BtPieceMessage::onNewPiece(const std::shared_ptr<Piece>& piece)
 {
   if (piece->getWrDiskCacheEntry()) {
@@ -54,6 +54,10 @@ private:
 
   bool checkPieceHash(const std::shared_ptr<Piece>& piece);
 
+  // Submits |piece| to HashWorkerPool unless its hash is already
+  // available.  Returns true if submitted.
+  bool checkPieceHashAsync(const std::shared_ptr<Piece>& piece);
+
   void onNewPiece(const std::shared_ptr<Piece>& piece);
 
   void onWrongPiece(const std::shared_ptr<Piece>& piece);
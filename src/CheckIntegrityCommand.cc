@@ -54,11 +54,13 @@ CheckIntegrityCommand::CheckIntegrityCommand(cuid_t cuid,
                                              CheckIntegrityEntry* entry)
     : RealtimeCommand{cuid, requestGroup, e}, entry_{entry}
 {
+  entry_->setWaiter(this);
 }
 
 CheckIntegrityCommand::~CheckIntegrityCommand()
 {
-  getDownloadEngine()->getCheckIntegrityMan()->dropPickedEntry();
+  entry_->setWaiter(nullptr);
+  getDownloadEngine()->getCheckIntegrityMan()->dropPickedEntry(entry_);
 }
 
 bool CheckIntegrityCommand::executeInternal()
@@ -92,6 +94,11 @@ bool CheckIntegrityCommand::executeInternal()
     return true;
   }
   else {
+    if (entry_->isWaiting()) {
+      // Nothing to do until HashWorkerPool returns digests.  Don't
+      // spin; the validator makes this command active again.
+      setStatusInactive();
+    }
     getDownloadEngine()->addCommand(std::unique_ptr<Command>(this));
     return false;
   }
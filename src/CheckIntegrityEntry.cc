@@ -41,18 +41,26 @@
 #include "FileAllocationEntry.h"
 #include "DownloadEngine.h"
 #include "Option.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
 CheckIntegrityEntry::CheckIntegrityEntry(RequestGroup* requestGroup,
                                          std::unique_ptr<Command> nextCommand)
-    : RequestGroupEntry{requestGroup, std::move(nextCommand)}
+    : RequestGroupEntry{requestGroup, std::move(nextCommand)},
+      startTime_{Timer::zero()}
 {
 }
 
 CheckIntegrityEntry::~CheckIntegrityEntry() = default;
 
-void CheckIntegrityEntry::validateChunk() { validator_->validateChunk(); }
+void CheckIntegrityEntry::validateChunk()
+{
+  if (startTime_.isZero()) {
+    startTime_ = global::wallclock();
+  }
+  validator_->validateChunk();
+}
 
 int64_t CheckIntegrityEntry::getTotalLength()
 {
@@ -76,6 +84,32 @@ int64_t CheckIntegrityEntry::getCurrentLength()
 
 bool CheckIntegrityEntry::finished() { return validator_->finished(); }
 
+bool CheckIntegrityEntry::isWaiting() const
+{
+  return validator_ && validator_->waiting();
+}
+
+void CheckIntegrityEntry::setWaiter(Command* command)
+{
+  if (validator_) {
+    validator_->setWaiter(command);
+  }
+}
+
+int CheckIntegrityEntry::getVerifySpeed() const
+{
+  if (!validator_ || startTime_.isZero()) {
+    return 0;
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     startTime_.difference(global::wallclock()))
+                     .count();
+  if (elapsed <= 0) {
+    return 0;
+  }
+  return validator_->getCurrentOffset() * 1000 / elapsed;
+}
+
 void CheckIntegrityEntry::cutTrailingGarbage()
 {
   getRequestGroup()->getPieceStorage()->getDiskAdaptor()->cutTrailingGarbage();
@@ -41,6 +41,7 @@
 #include <memory>
 
 #include "ProgressAwareEntry.h"
+#include "TimerA2.h"
 
 namespace aria2 {
 
@@ -52,6 +53,8 @@ class CheckIntegrityEntry : public RequestGroupEntry,
                             public ProgressAwareEntry {
 private:
   std::unique_ptr<IteratableValidator> validator_;
+  // The time when the first chunk was validated
+  Timer startTime_;
 
 protected:
   void setValidator(std::unique_ptr<IteratableValidator> validator);
@@ -75,6 +78,17 @@ public:
 
   virtual bool finished() CXX11_OVERRIDE;
 
+  // Returns true if the validator waits for the pieces hashed in
+  // background.
+  bool isWaiting() const;
+
+  // Makes |command| active when the validator can make progress
+  // again after isWaiting() returned true.
+  void setWaiter(Command* command);
+
+  // Returns the number of bytes verified per second.
+  int getVerifySpeed() const;
+
   virtual bool isValidationReady() = 0;
 
   virtual void initValidator() = 0;
@@ -33,7 +33,7 @@
  */
 /* copyright --> */
 #include "ConnectCommand.h"
-#include "BackupIPv4ConnectCommand.h"
+#include "BackupConnectCommand.h"
 #include "ControlChain.h"
 #include "Option.h"
 #include "message.h"
@@ -44,6 +44,9 @@
 #include "Request.h"
 #include "prefs.h"
 #include "SocketRecvBuffer.h"
+#include "wallclock.h"
+#include "RequestGroupMan.h"
+#include "ServerStat.h"
 
 namespace aria2 {
 
@@ -53,7 +56,8 @@ ConnectCommand::ConnectCommand(cuid_t cuid, const std::shared_ptr<Request>& req,
                                RequestGroup* requestGroup, DownloadEngine* e,
                                const std::shared_ptr<SocketCore>& s)
     : AbstractCommand(cuid, req, fileEntry, requestGroup, e, s),
-      proxyRequest_(proxyRequest)
+      proxyRequest_(proxyRequest),
+      startTime_(global::wallclock())
 {
   setTimeout(std::chrono::seconds(getOption()->getAsInt(PREF_CONNECT_TIMEOUT)));
   disableReadCheckSocket();
@@ -86,6 +90,7 @@ const std::shared_ptr<Request>& ConnectCommand::getProxyRequest() const
 
 bool ConnectCommand::executeInternal()
 {
+  bool backupUsed = false;
   if (backupConnectionInfo_ && !backupConnectionInfo_->ipaddr.empty()) {
     A2_LOG_INFO(fmt("CUID#%" PRId64 " - Use backup connection address %s",
                     getCuid(), backupConnectionInfo_->ipaddr.c_str()));
@@ -98,12 +103,29 @@ bool ConnectCommand::executeInternal()
                                        getRequest()->getConnectedPort());
     swapSocket(backupConnectionInfo_->socket);
     backupConnectionInfo_.reset();
+    // BackupConnectCommand has already recorded RTT.
+    backupUsed = true;
   }
   if (!checkIfConnectionEstablished(
           getSocket(), getRequest()->getConnectedHostname(),
           getRequest()->getConnectedAddr(), getRequest()->getConnectedPort())) {
     return true;
   }
+  if (!backupUsed) {
+    auto rtt = std::chrono::duration_cast<std::chrono::milliseconds>(
+        startTime_.difference(global::wallclock()));
+    getDownloadEngine()->updateIPAddressRTT(
+        getRequest()->getConnectedHostname(), getRequest()->getConnectedAddr(),
+        getRequest()->getConnectedPort(), rtt);
+    // With proxy, this is the time to connect to the proxy server.
+    if (!proxyRequest_) {
+      getDownloadEngine()
+          ->getRequestGroupMan()
+          ->getOrCreateServerStat(getRequest()->getHost(),
+                                  getRequest()->getProtocol())
+          ->addConnectTime(rtt);
+    }
+  }
   if (backupConnectionInfo_) {
     backupConnectionInfo_->cancel = true;
     backupConnectionInfo_.reset();
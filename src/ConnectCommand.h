@@ -63,6 +63,8 @@ private:
   std::shared_ptr<Request> proxyRequest_;
   std::shared_ptr<BackupConnectInfo> backupConnectionInfo_;
   std::shared_ptr<ControlChain<ConnectCommand*>> chain_;
+  // Used to measure the time taken to establish connection.
+  Timer startTime_;
 };
 
 } // namespace aria2
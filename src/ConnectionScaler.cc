@@ -0,0 +1,160 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "ConnectionScaler.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+#include "LogFactory.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+const double ConnectionScaler::MIN_MARGINAL_GAIN = 0.25;
+
+namespace {
+constexpr int INITIAL_CONNECTIONS = 2;
+} // namespace
+
+ConnectionScaler::ConnectionScaler(int minConnections, int maxConnections)
+    : minConnections_(std::max(1, minConnections)),
+      maxConnections_(std::max(minConnections_, maxConnections)),
+      target_(std::min(maxConnections_,
+                       std::max(minConnections_, INITIAL_CONNECTIONS))),
+      baseTarget_(target_),
+      baseSpeed_(0),
+      holdRounds_(0),
+      waitRounds_(0),
+      stableRounds_(0),
+      probing_(true),
+      busy_(false)
+{
+}
+
+void ConnectionScaler::setMaxConnections(int maxConnections)
+{
+  maxConnections_ = std::max(minConnections_, maxConnections);
+  target_ = std::min(target_, maxConnections_);
+  baseTarget_ = std::min(baseTarget_, maxConnections_);
+}
+
+void ConnectionScaler::onServerBusy() { busy_ = true; }
+
+void ConnectionScaler::setShedConnections(std::set<cuid_t> cuids)
+{
+  shedConnections_ = std::move(cuids);
+}
+
+bool ConnectionScaler::consumeShedConnection(cuid_t cuid)
+{
+  return shedConnections_.erase(cuid) > 0;
+}
+
+void ConnectionScaler::grow()
+{
+  if (target_ >= maxConnections_) {
+    probing_ = false;
+    stableRounds_ = 0;
+    return;
+  }
+  // Grow by 1.5 times, so that a few dozens of connections are reached
+  // in several rounds.
+  target_ = std::min(maxConnections_, target_ + std::max(1, target_ / 2));
+}
+
+int ConnectionScaler::update(int downloadSpeed, int numConnections)
+{
+  if (busy_) {
+    busy_ = false;
+    target_ = std::max(minConnections_, target_ / 2);
+    baseTarget_ = target_;
+    baseSpeed_ = 0;
+    holdRounds_ = BUSY_HOLD_ROUNDS;
+    probing_ = false;
+    stableRounds_ = 0;
+    A2_LOG_INFO(fmt("Server is busy. Lowered the number of connections to %d",
+                    target_));
+    return target_;
+  }
+  if (holdRounds_ > 0) {
+    --holdRounds_;
+    return target_;
+  }
+  // The speed is not representative until connections are made up to
+  // target_.  They may never be if the server or the number of pieces
+  // limits them, so don't wait forever.
+  if (numConnections < target_ && ++waitRounds_ < MAX_WAIT_ROUNDS) {
+    return target_;
+  }
+  waitRounds_ = 0;
+  if (!probing_) {
+    if (++stableRounds_ >= REPROBE_ROUNDS) {
+      probing_ = true;
+      baseSpeed_ = downloadSpeed;
+      baseTarget_ = target_;
+      grow();
+    }
+    return target_;
+  }
+  if (baseSpeed_ == 0) {
+    baseSpeed_ = downloadSpeed;
+    baseTarget_ = target_;
+    if (downloadSpeed > 0) {
+      grow();
+    }
+    return target_;
+  }
+  int added = target_ - baseTarget_;
+  double expectedGain =
+      static_cast<double>(baseSpeed_) / baseTarget_ * added;
+  double gain = downloadSpeed - baseSpeed_;
+  A2_LOG_DEBUG(fmt("ConnectionScaler: connections %d -> %d, speed %d -> %d",
+                   baseTarget_, target_, baseSpeed_, downloadSpeed));
+  if (added > 0 && gain >= expectedGain * MIN_MARGINAL_GAIN) {
+    baseSpeed_ = downloadSpeed;
+    baseTarget_ = target_;
+    grow();
+  }
+  else {
+    // The added connections did not pay off.
+    target_ = baseTarget_;
+    probing_ = false;
+    stableRounds_ = 0;
+    A2_LOG_INFO(fmt("Download speed saturated at %d connection(s)", target_));
+  }
+  return target_;
+}
+
+} // namespace aria2
@@ -0,0 +1,117 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_CONNECTION_SCALER_H
+#define D_CONNECTION_SCALER_H
+
+#include "common.h"
+
+#include <set>
+
+#include "Command.h"
+
+namespace aria2 {
+
+// Decides the number of concurrent connections of a download by hill
+// climbing on its aggregate download speed.  The number of
+// connections is increased while the speed grows, and reverted to the
+// last good value when the marginal gain of the added connections
+// flattens.  After a while, it probes again in case the network
+// condition has changed.  If the server says it is busy, the number
+// is halved and kept for some time.
+class ConnectionScaler {
+public:
+  ConnectionScaler(int minConnections, int maxConnections);
+
+  // Called periodically with the aggregate download speed and the
+  // current number of connections.  Returns the new target number of
+  // connections.
+  int update(int downloadSpeed, int numConnections);
+
+  // Called when the server responded with 429 or 503.  The target is
+  // lowered in the next update().
+  void onServerBusy();
+
+  int getTarget() const { return target_; }
+
+  int getMaxConnections() const { return maxConnections_; }
+
+  void setMaxConnections(int maxConnections);
+
+  // Replaces the set of connections, identified by CUID, which should
+  // be closed at the next segment boundary.
+  void setShedConnections(std::set<cuid_t> cuids);
+
+  // Returns true if connection |cuid| should be closed, and forgets
+  // it.
+  bool consumeShedConnection(cuid_t cuid);
+
+  // If the marginal speed gain per added connection is less than this
+  // ratio of the average speed per connection, the gain is considered
+  // flat.
+  static const double MIN_MARGINAL_GAIN;
+
+  // Number of update() calls to stay at a good value before probing
+  // again.
+  static const int REPROBE_ROUNDS = 20;
+
+  // Number of update() calls to keep the lowered target after the
+  // server said it is busy.
+  static const int BUSY_HOLD_ROUNDS = 10;
+
+  // Number of update() calls to wait for connections to catch up with
+  // the target before measuring anyway.
+  static const int MAX_WAIT_ROUNDS = 3;
+
+private:
+  void grow();
+
+  int minConnections_;
+  int maxConnections_;
+  int target_;
+  // Target and speed measured before the last increase.  baseSpeed_
+  // == 0 means there is no measurement yet.
+  int baseTarget_;
+  int baseSpeed_;
+  int holdRounds_;
+  int waitRounds_;
+  int stableRounds_;
+  bool probing_;
+  bool busy_;
+  std::set<cuid_t> shedConnections_;
+};
+
+} // namespace aria2
+
+#endif // D_CONNECTION_SCALER_H
@@ -0,0 +1,132 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "ConnectionScalingCommand.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "ConnectionScaler.h"
+#include "RequestGroup.h"
+#include "RequestGroupMan.h"
+#include "DownloadEngine.h"
+#include "DownloadContext.h"
+#include "SegmentMan.h"
+#include "PeerStat.h"
+#include "NetStat.h"
+#include "Logger.h"
+#include "LogFactory.h"
+#include "wallclock.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+ConnectionScalingCommand::ConnectionScalingCommand(
+    cuid_t cuid, RequestGroup* requestGroup, DownloadEngine* e,
+    std::chrono::seconds interval)
+    : Command(cuid),
+      requestGroup_(requestGroup),
+      e_(e),
+      interval_(std::move(interval))
+{
+  requestGroup_->increaseNumCommand();
+}
+
+ConnectionScalingCommand::~ConnectionScalingCommand()
+{
+  requestGroup_->decreaseNumCommand();
+}
+
+bool ConnectionScalingCommand::execute()
+{
+  // If this is the only command left, the download has ended without
+  // finishing, and no stream command will be created again.
+  if (requestGroup_->downloadFinished() || requestGroup_->isHaltRequested() ||
+      requestGroup_->getNumCommand() == 1) {
+    return true;
+  }
+  // No stream command may exist for a moment, e.g. while the file is
+  // allocated.  Speed limits make the measurement meaningless.
+  if (checkPoint_.difference(global::wallclock()) >= interval_ &&
+      requestGroup_->getNumStreamCommand() > 0 &&
+      e_->getRequestGroupMan()->getMaxOverallDownloadSpeedLimit() == 0 &&
+      requestGroup_->getMaxDownloadSpeedLimit() == 0) {
+    checkPoint_ = global::wallclock();
+    const auto& scaler = requestGroup_->getConnectionScaler();
+    int speed = requestGroup_->getDownloadContext()
+                    ->getNetStat()
+                    .calculateNewestDownloadSpeed(interval_.count());
+    int num = requestGroup_->getNumStreamCommand();
+    int target = scaler->update(speed, num);
+    requestGroup_->setNumConcurrentCommand(target);
+    if (target > num) {
+      A2_LOG_DEBUG(fmt("GID#%s - Adding %d connection(s)",
+                       requestGroup_->getGroupId()->toHex().c_str(),
+                       target - num));
+      std::vector<std::unique_ptr<Command>> commands;
+      requestGroup_->createNextCommand(commands, e_);
+      e_->addCommand(std::move(commands));
+      scaler->setShedConnections({});
+    }
+    else {
+      shedSlowestConnections(num - target);
+    }
+  }
+  e_->addCommand(std::unique_ptr<Command>(this));
+  return false;
+}
+
+void ConnectionScalingCommand::shedSlowestConnections(int num)
+{
+  std::set<cuid_t> cuids;
+  const auto& segmentMan = requestGroup_->getSegmentMan();
+  if (num > 0 && segmentMan) {
+    std::vector<std::pair<int, cuid_t>> speeds;
+    for (auto& ps : segmentMan->getPeerStats()) {
+      if (ps->getStatus() == NetStat::ACTIVE) {
+        speeds.emplace_back(ps->calculateDownloadSpeed(), ps->getCuid());
+      }
+    }
+    std::sort(std::begin(speeds), std::end(speeds));
+    for (int i = 0; i < num && i < static_cast<int>(speeds.size()); ++i) {
+      A2_LOG_DEBUG(fmt("CUID#%" PRId64 " - Closing slow connection (%d B/s)",
+                       speeds[i].second, speeds[i].first));
+      cuids.insert(speeds[i].second);
+    }
+  }
+  requestGroup_->getConnectionScaler()->setShedConnections(std::move(cuids));
+}
+
+} // namespace aria2
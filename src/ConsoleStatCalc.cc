@@ -204,6 +204,24 @@ void printProgress(ColorizedStream& o, const std::shared_ptr<RequestGroup>& rg,
 }
 } // namespace
 
+namespace {
+// Writes HTTP authentication counters in one line if any
+// authentication handshake has taken place.
+template <typename Stream>
+void printAuthStat(Stream& o, const AuthStat& stat)
+{
+  if (stat.challenges == 0 && stat.preemptiveHits == 0 &&
+      stat.preemptiveMisses == 0) {
+    return;
+  }
+  o << "AUTH: challenges=" << stat.challenges
+    << " preemptive=" << stat.preemptiveHits << "/"
+    << stat.preemptiveHits + stat.preemptiveMisses
+    << " stale=" << stat.staleNonceRetries << " retry=" << stat.retryTime
+    << "ms\n";
+}
+} // namespace
+
 namespace {
 class PrintSummary {
 private:
@@ -228,7 +246,9 @@ public:
     o << "\nFILE: ";
     writeFilePath(fileEntries.begin(), fileEntries.end(), o,
                   rg->inMemoryDownload());
-    o << "\n" << std::setfill(SEP_CHAR) << std::setw(cols_) << SEP_CHAR << "\n";
+    o << "\n";
+    printAuthStat(o, rg->getAuthStat());
+    o << std::setfill(SEP_CHAR) << std::setw(cols_) << SEP_CHAR << "\n";
     auto str = o.str(false);
     global::cout()->write(str.c_str());
   }
@@ -259,8 +279,9 @@ void printProgressSummary(const RequestGroupList& groups, size_t cols,
       o << " as of " << buf;
     }
   }
-  o << " *** \n"
-    << std::setfill(SEP_CHAR) << std::setw(cols) << SEP_CHAR << "\n";
+  o << " *** \n";
+  printAuthStat(o, e->getRequestGroupMan()->getAuthStat());
+  o << std::setfill(SEP_CHAR) << std::setw(cols) << SEP_CHAR << "\n";
   global::cout()->write(o.str().c_str());
   std::for_each(groups.begin(), groups.end(),
                 PrintSummary(cols, e, sizeFormatter));
@@ -365,24 +386,22 @@ void ConsoleStatCalc::calculateStat(const DownloadEngine* e)
       }
     }
   }
-  {
-    auto& entry = e->getCheckIntegrityMan()->getPickedEntry();
-    if (entry) {
-      o << " [Checksum:#"
-        << GroupId::toAbbrevHex(entry->getRequestGroup()->getGID()) << " "
-        << sizeFormatter(entry->getCurrentLength()) << "B/"
-        << sizeFormatter(entry->getTotalLength()) << "B(";
-      if (entry->getTotalLength() > 0) {
-        o << 100LL * entry->getCurrentLength() / entry->getTotalLength();
-      }
-      else {
-        o << "--";
-      }
-      o << "%)]";
-      if (e->getCheckIntegrityMan()->hasNext()) {
-        o << "(+" << e->getCheckIntegrityMan()->countEntryInQueue() << ")";
-      }
+  for (auto& entry : e->getCheckIntegrityMan()->getPickedEntries()) {
+    o << " [Checksum:#"
+      << GroupId::toAbbrevHex(entry->getRequestGroup()->getGID()) << " "
+      << sizeFormatter(entry->getCurrentLength()) << "B/"
+      << sizeFormatter(entry->getTotalLength()) << "B(";
+    if (entry->getTotalLength() > 0) {
+      o << 100LL * entry->getCurrentLength() / entry->getTotalLength();
+    }
+    else {
+      o << "--";
     }
+    o << "%)]";
+  }
+  if (e->getCheckIntegrityMan()->isPicked() &&
+      e->getCheckIntegrityMan()->hasNext()) {
+    o << "(+" << e->getCheckIntegrityMan()->countEntryInQueue() << ")";
   }
   if (isTTY_) {
     if (truncate_) {
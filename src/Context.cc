@@ -66,6 +66,7 @@
 #include "ProtocolDetector.h"
 #include "RecoverableException.h"
 #include "SocketCore.h"
+#include "SocketRecvBuffer.h"
 #include "DownloadContext.h"
 #include "fmt.h"
 #include "console.h"
@@ -224,6 +225,9 @@ Context::Context(bool standalone, int argc, char** argv, const KeyVals& options)
   SocketCore::setIpDscp(op->getAsInt(PREF_DSCP));
   SocketCore::setSocketRecvBufferSize(
       op->getAsInt(PREF_SOCKET_RECV_BUFFER_SIZE));
+  SocketRecvBuffer::setDefaultCapacity(op->getAsInt(PREF_RECV_BUFFER_SIZE));
+  SocketRecvBuffer::setMemoryLimit(
+      op->getAsLLInt(PREF_RECV_BUFFER_MEMORY_LIMIT));
   net::checkAddrconfig();
 
   if (!net::getIPv4AddrConfigured() && !net::getIPv6AddrConfigured()) {
@@ -34,11 +34,12 @@
 /* copyright --> */
 #include "DNSCache.h"
 #include "A2STR.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
 DNSCache::AddrEntry::AddrEntry(const std::string& addr)
-    : addr_(addr), good_(true)
+    : addr_(addr), good_(true), rtt_(std::chrono::milliseconds::max())
 {
 }
 
@@ -51,12 +52,13 @@ DNSCache::AddrEntry& DNSCache::AddrEntry::operator=(const AddrEntry& c)
   if (this != &c) {
     addr_ = c.addr_;
     good_ = c.good_;
+    rtt_ = c.rtt_;
   }
   return *this;
 }
 
 DNSCache::CacheEntry::CacheEntry(const std::string& hostname, uint16_t port)
-    : hostname_(hostname), port_(port)
+    : hostname_(hostname), port_(port), lastAccess_(0)
 {
 }
 
@@ -70,6 +72,9 @@ DNSCache::CacheEntry& DNSCache::CacheEntry::operator=(const CacheEntry& c)
     hostname_ = c.hostname_;
     port_ = c.port_;
     addrEntries_ = c.addrEntries_;
+    expiry_ = c.expiry_;
+    error_ = c.error_;
+    lastAccess_ = c.lastAccess_;
   }
   return *this;
 }
@@ -132,6 +137,40 @@ void DNSCache::CacheEntry::markBad(const std::string& addr)
   }
 }
 
+void DNSCache::CacheEntry::setRTT(const std::string& addr,
+                                  std::chrono::milliseconds rtt)
+{
+  auto i = find(addr);
+  if (i == addrEntries_.end()) {
+    return;
+  }
+  if (i->rtt_ == std::chrono::milliseconds::max()) {
+    i->rtt_ = std::move(rtt);
+  }
+  else {
+    // Smooth as TCP does for SRTT (RFC 6298)
+    i->rtt_ = (i->rtt_ * 7 + rtt) / 8;
+  }
+  std::stable_sort(
+      addrEntries_.begin(), addrEntries_.end(),
+      [](const AddrEntry& lhs, const AddrEntry& rhs) {
+        return lhs.rtt_ < rhs.rtt_;
+      });
+}
+
+bool DNSCache::CacheEntry::expired() const
+{
+  return expiry_ < global::wallclock();
+}
+
+void DNSCache::CacheEntry::reset(std::chrono::seconds ttl)
+{
+  addrEntries_.clear();
+  error_.clear();
+  expiry_ = global::wallclock();
+  expiry_.advance(ttl);
+}
+
 bool DNSCache::CacheEntry::operator<(const CacheEntry& e) const
 {
   int r = hostname_.compare(e.hostname_);
@@ -146,7 +185,13 @@ bool DNSCache::CacheEntry::operator==(const CacheEntry& e) const
   return hostname_ == e.hostname_ && port_ == e.port_;
 }
 
-DNSCache::DNSCache() {}
+DNSCache::DNSCache(size_t maxSize)
+    : maxSize_(maxSize),
+      ttl_(std::chrono::seconds(300)),
+      negativeTtl_(std::chrono::seconds(30)),
+      accessCounter_(0)
+{
+}
 
 DNSCache::DNSCache(const DNSCache& c) = default;
 
@@ -156,35 +201,126 @@ DNSCache& DNSCache::operator=(const DNSCache& c)
 {
   if (this != &c) {
     entries_ = c.entries_;
+    maxSize_ = c.maxSize_;
+    ttl_ = c.ttl_;
+    negativeTtl_ = c.negativeTtl_;
+    accessCounter_ = c.accessCounter_;
   }
   return *this;
 }
 
-const std::string& DNSCache::find(const std::string& hostname,
-                                  uint16_t port) const
+DNSCache::CacheEntry* DNSCache::findEntry(const std::string& hostname,
+                                          uint16_t port) const
 {
   auto target = std::make_shared<CacheEntry>(hostname, port);
   auto i = entries_.find(target);
-  if (i == entries_.end()) {
+  if (i == entries_.end() || (*i)->expired()) {
+    return nullptr;
+  }
+  (*i)->lastAccess_ = ++accessCounter_;
+  return (*i).get();
+}
+
+DNSCache::CacheEntry& DNSCache::getOrCreateEntry(const std::string& hostname,
+                                                 uint16_t port,
+                                                 std::chrono::seconds ttl,
+                                                 bool negative)
+{
+  auto target = std::make_shared<CacheEntry>(hostname, port);
+  auto i = entries_.lower_bound(target);
+  if (i != entries_.end() && *(*i) == *target) {
+    auto& entry = *(*i);
+    if (entry.expired() || entry.error_.empty() == negative) {
+      entry.reset(ttl);
+    }
+    else {
+      // Addresses from one resolution may come with different TTLs.
+      // The entry lives as long as the shortest of them.
+      Timer expiry = global::wallclock();
+      expiry.advance(ttl);
+      if (expiry < entry.expiry_) {
+        entry.expiry_ = expiry;
+      }
+    }
+    entry.lastAccess_ = ++accessCounter_;
+    return entry;
+  }
+  target->reset(ttl);
+  target->lastAccess_ = ++accessCounter_;
+  entries_.insert(i, target);
+  evict();
+  // evict() never removes the most recently used entry.
+  return *target;
+}
+
+void DNSCache::evict()
+{
+  if (entries_.size() <= maxSize_) {
+    return;
+  }
+  for (auto i = std::begin(entries_); i != std::end(entries_);) {
+    if ((*i)->expired()) {
+      i = entries_.erase(i);
+    }
+    else {
+      ++i;
+    }
+  }
+  while (entries_.size() > maxSize_ && entries_.size() > 1) {
+    auto lru = std::min_element(
+        std::begin(entries_), std::end(entries_),
+        [](const std::shared_ptr<CacheEntry>& lhs,
+           const std::shared_ptr<CacheEntry>& rhs) {
+          return lhs->lastAccess_ < rhs->lastAccess_;
+        });
+    entries_.erase(lru);
+  }
+}
+
+const std::string& DNSCache::find(const std::string& hostname,
+                                  uint16_t port) const
+{
+  auto entry = findEntry(hostname, port);
+  if (!entry) {
     return A2STR::NIL;
   }
   else {
-    return (*i)->getGoodAddr();
+    return entry->getGoodAddr();
   }
 }
 
 void DNSCache::put(const std::string& hostname, const std::string& ipaddr,
                    uint16_t port)
 {
-  auto target = std::make_shared<CacheEntry>(hostname, port);
-  auto i = entries_.lower_bound(target);
-  if (i != entries_.end() && *(*i) == *target) {
-    (*i)->add(ipaddr);
+  put(hostname, ipaddr, port, ttl_);
+}
+
+void DNSCache::put(const std::string& hostname, const std::string& ipaddr,
+                   uint16_t port, std::chrono::seconds ttl)
+{
+  // TTL of 0 is legal in DNS, but we need the address at least for the
+  // connection we are about to make.
+  ttl = std::max(std::chrono::seconds(1), std::min(ttl, ttl_));
+  getOrCreateEntry(hostname, port, ttl, false).add(ipaddr);
+}
+
+void DNSCache::putError(const std::string& hostname, uint16_t port,
+                        const std::string& error)
+{
+  if (negativeTtl_ == std::chrono::seconds(0)) {
+    return;
   }
-  else {
-    target->add(ipaddr);
-    entries_.insert(i, target);
+  getOrCreateEntry(hostname, port, negativeTtl_, true).error_ = error;
+}
+
+const std::string& DNSCache::findError(const std::string& hostname,
+                                       uint16_t port) const
+{
+  auto entry = findEntry(hostname, port);
+  if (!entry) {
+    return A2STR::NIL;
   }
+  return entry->error_;
 }
 
 void DNSCache::markBad(const std::string& hostname, const std::string& ipaddr,
@@ -197,6 +333,16 @@ void DNSCache::markBad(const std::string& hostname, const std::string& ipaddr,
   }
 }
 
+void DNSCache::setRTT(const std::string& hostname, const std::string& ipaddr,
+                      uint16_t port, std::chrono::milliseconds rtt)
+{
+  auto target = std::make_shared<CacheEntry>(hostname, port);
+  auto i = entries_.find(target);
+  if (i != entries_.end()) {
+    (*i)->setRTT(ipaddr, std::move(rtt));
+  }
+}
+
 void DNSCache::remove(const std::string& hostname, uint16_t port)
 {
   auto target = std::make_shared<CacheEntry>(hostname, port);
@@ -41,8 +41,10 @@
 #include <set>
 #include <algorithm>
 #include <vector>
+#include <chrono>
 
 #include "a2functional.h"
+#include "TimerA2.h"
 
 namespace aria2 {
 
@@ -51,6 +53,9 @@ private:
   struct AddrEntry {
     std::string addr_;
     bool good_;
+    // Smoothed time taken to establish connection to addr_.
+    // std::chrono::milliseconds::max() if it is unknown.
+    std::chrono::milliseconds rtt_;
 
     AddrEntry(const std::string& addr);
     AddrEntry(const AddrEntry& c);
@@ -63,6 +68,14 @@ private:
     std::string hostname_;
     uint16_t port_;
     std::vector<AddrEntry> addrEntries_;
+    // The time at which this entry expires.
+    Timer expiry_;
+    // Error message of the failed name resolution.  If this is not
+    // empty, this entry is a negative one and has no address.
+    std::string error_;
+    // The value of DNSCache::accessCounter_ when this entry was last
+    // used.  Used to evict the least recently used entry.
+    mutable uint64_t lastAccess_;
 
     CacheEntry(const std::string& hostname, uint16_t port);
     CacheEntry(const CacheEntry& c);
@@ -92,6 +105,17 @@ private:
 
     void markBad(const std::string& addr);
 
+    // Updates RTT of |addr| with |rtt| and reorders addresses so that
+    // the ones with shorter RTT come first.  The addresses whose RTT
+    // is unknown follow them in the order they were added.
+    void setRTT(const std::string& addr, std::chrono::milliseconds rtt);
+
+    bool expired() const;
+
+    // Removes all addresses and error, and makes this entry expire
+    // after |ttl|.
+    void reset(std::chrono::seconds ttl);
+
     bool operator<(const CacheEntry& e) const;
 
     bool operator==(const CacheEntry& e) const;
@@ -101,33 +125,87 @@ private:
                    DerefLess<std::shared_ptr<CacheEntry>>>
       CacheEntrySet;
   CacheEntrySet entries_;
+  // The maximum number of entries
+  size_t maxSize_;
+  // TTL of entries.  This is also the upper limit of TTL given to
+  // put().
+  std::chrono::seconds ttl_;
+  // TTL of negative entries
+  std::chrono::seconds negativeTtl_;
+  mutable uint64_t accessCounter_;
+
+  // Returns the entry for |hostname| and |port| if it exists and has
+  // not expired.  Otherwise returns nullptr.  This also marks the
+  // entry used.
+  CacheEntry* findEntry(const std::string& hostname, uint16_t port) const;
+
+  // Returns the entry for |hostname| and |port|, creating it if it
+  // does not exist.  If the entry has expired, or if |negative|
+  // differs from the kind of the entry, it is reset with |ttl|.
+  CacheEntry& getOrCreateEntry(const std::string& hostname, uint16_t port,
+                               std::chrono::seconds ttl, bool negative);
+
+  // Removes expired entries, and then the least recently used ones
+  // until the number of entries is not greater than maxSize_.
+  void evict();
 
 public:
-  DNSCache();
+  static const size_t DEFAULT_MAX_SIZE = 1024;
+
+  DNSCache(size_t maxSize = DEFAULT_MAX_SIZE);
   DNSCache(const DNSCache& c);
   ~DNSCache();
 
   DNSCache& operator=(const DNSCache& c);
 
+  void setTTL(std::chrono::seconds ttl) { ttl_ = std::move(ttl); }
+
+  void setNegativeTTL(std::chrono::seconds ttl)
+  {
+    negativeTtl_ = std::move(ttl);
+  }
+
+  size_t size() const { return entries_.size(); }
+
   const std::string& find(const std::string& hostname, uint16_t port) const;
 
   template <typename OutputIterator>
   void findAll(OutputIterator out, const std::string& hostname,
                uint16_t port) const
   {
-    auto target = std::make_shared<CacheEntry>(hostname, port);
-    auto i = entries_.find(target);
-    if (i != entries_.end()) {
-      (*i)->getAllGoodAddrs(out);
+    auto entry = findEntry(hostname, port);
+    if (entry) {
+      entry->getAllGoodAddrs(out);
     }
   }
 
   void put(const std::string& hostname, const std::string& ipaddr,
            uint16_t port);
 
+  // Same as above, but the entry expires after |ttl|, which is
+  // usually the TTL of DNS record.  |ttl| is capped by the TTL set by
+  // setTTL().
+  void put(const std::string& hostname, const std::string& ipaddr,
+           uint16_t port, std::chrono::seconds ttl);
+
+  // Remembers that name resolution of |hostname| failed with |error|
+  // for the TTL set by setNegativeTTL().
+  void putError(const std::string& hostname, uint16_t port,
+                const std::string& error);
+
+  // Returns the error message of the failed name resolution of
+  // |hostname| if it is cached.  Otherwise returns empty string.
+  const std::string& findError(const std::string& hostname,
+                               uint16_t port) const;
+
   void markBad(const std::string& hostname, const std::string& ipaddr,
                uint16_t port);
 
+  // Records that connection to |ipaddr| took |rtt| to establish.
+  // find() and findAll() prefer the addresses with shorter RTT.
+  void setRTT(const std::string& hostname, const std::string& ipaddr,
+              uint16_t port, std::chrono::milliseconds rtt);
+
   void remove(const std::string& hostname, uint16_t port);
 };
 
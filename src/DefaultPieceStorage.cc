@@ -790,6 +790,13 @@ void DefaultPieceStorage::markPieceMissing(size_t index)
 void DefaultPieceStorage::addInFlightPiece(
     const std::vector<std::shared_ptr<Piece>>& pieces)
 {
+  for (auto& piece : pieces) {
+    // The hash of this piece was being calculated by HashWorkerPool
+    // when the control file was saved.  Download it again.
+    if (piece->pieceComplete()) {
+      piece->clearAllBlock(nullptr);
+    }
+  }
   usedPieces_.insert(pieces.begin(), pieces.end());
 }
 
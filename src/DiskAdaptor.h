@@ -117,6 +117,10 @@ public:
   // Force physical write of data from OS buffer cache.
   virtual void flushOSBuffers(){};
 
+  // Waits for the writes performed in background to complete.  Throws
+  // the error of a write failed since the last call.
+  virtual void drainWrites() {}
+
   void setFileAllocationMethod(FileAllocationMethod method)
   {
     fileAllocationMethod_ = method;
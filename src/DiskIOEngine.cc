@@ -0,0 +1,298 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "DiskIOEngine.h"
+
+#include <cerrno>
+#include <climits>
+#include <algorithm>
+
+#ifdef HAVE_SYS_UIO_H
+#  include <sys/uio.h>
+#endif // HAVE_SYS_UIO_H
+
+#include "a2io.h"
+#include "message.h"
+#include "LogFactory.h"
+#include "fmt.h"
+#include "util.h"
+#include "WakeupPipe.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+DiskIOEngine* DiskIOEngine::instance_ = nullptr;
+
+std::shared_ptr<void> DiskIOEngine::buffer_;
+
+DiskIOEngine::DiskIOEngine(size_t queueDepth)
+    : queueDepth_(std::max(queueDepth, static_cast<size_t>(1))),
+      shutdown_(false),
+      wakeupPipe_(nullptr)
+{
+}
+
+DiskIOEngine::~DiskIOEngine()
+{
+  if (instance_ == this) {
+    instance_ = nullptr;
+  }
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    shutdown_ = true;
+    for (auto& dev : devices_) {
+      dev.second->cond.notify_one();
+    }
+  }
+  // Workers exit after their queues become empty.
+  for (auto& dev : devices_) {
+    dev.second->thread.join();
+  }
+  poll();
+}
+
+namespace {
+// The maximum number of writes merged into one job
+const size_t MAX_SEGMENTS = 256;
+} // namespace
+
+namespace {
+// Writes whole data.  Returns 0 on success, or errno.
+int writeFully(int fd, const unsigned char* data, size_t len, int64_t offset)
+{
+#ifndef __MINGW32__
+  while (len > 0) {
+    ssize_t n;
+    while ((n = a2pwrite(fd, data, len, offset)) == -1 && errno == EINTR)
+      ;
+    if (n == -1) {
+      return errno;
+    }
+    data += n;
+    len -= n;
+    offset += n;
+  }
+  return 0;
+#else  // __MINGW32__
+  // Not used in Mingw build.
+  return EINVAL;
+#endif // __MINGW32__
+}
+} // namespace
+
+namespace {
+// Writes all |segments| contiguously from |offset|.  Returns 0 on
+// success, or errno.
+int writeFully(int fd,
+               const std::vector<std::pair<const unsigned char*, size_t>>&
+                   segments,
+               int64_t offset)
+{
+#ifdef HAVE_PWRITEV
+#  ifdef IOV_MAX
+  const size_t iovMax = IOV_MAX;
+#  else  // !IOV_MAX
+  const size_t iovMax = 16;
+#  endif // !IOV_MAX
+  std::vector<struct iovec> iov(segments.size());
+  for (size_t i = 0; i < segments.size(); ++i) {
+    iov[i].iov_base = const_cast<unsigned char*>(segments[i].first);
+    iov[i].iov_len = segments[i].second;
+  }
+  for (size_t i = 0; i < iov.size();) {
+    ssize_t n;
+    while ((n = pwritev(fd, &iov[i], std::min(iov.size() - i, iovMax),
+                        offset)) == -1 &&
+           errno == EINTR)
+      ;
+    if (n == -1) {
+      return errno;
+    }
+    offset += n;
+    // Skip the segments written, and adjust the partially written one.
+    for (; i < iov.size() && static_cast<size_t>(n) >= iov[i].iov_len; ++i) {
+      n -= iov[i].iov_len;
+    }
+    if (n > 0) {
+      iov[i].iov_base = static_cast<unsigned char*>(iov[i].iov_base) + n;
+      iov[i].iov_len -= n;
+    }
+  }
+  return 0;
+#else  // !HAVE_PWRITEV
+  for (auto& seg : segments) {
+    int errNum = writeFully(fd, seg.first, seg.second, offset);
+    if (errNum != 0) {
+      return errNum;
+    }
+    offset += seg.second;
+  }
+  return 0;
+#endif // !HAVE_PWRITEV
+}
+} // namespace
+
+void DiskIOEngine::run(Device* device)
+{
+  std::unique_lock<std::mutex> lk(mutex_);
+  for (;;) {
+    device->cond.wait(lk,
+                      [&] { return shutdown_ || !device->queue.empty(); });
+    if (device->queue.empty()) {
+      return;
+    }
+    auto job = std::move(device->queue.front());
+    device->queue.pop_front();
+    lk.unlock();
+    int errNum = job.segments.size() == 1
+                     ? writeFully(job.fd, job.segments[0].first, job.len,
+                                  job.offset)
+                     : writeFully(job.fd, job.segments, job.offset);
+    job.buffers.clear();
+    lk.lock();
+    --device->numJobs;
+    --job.file->numPending;
+    if (errNum != 0) {
+      if (job.file->errNum == 0) {
+        job.file->errNum = errNum;
+      }
+      failures_.emplace_back(job.file->filename, errNum);
+      if (wakeupPipe_) {
+        wakeupPipe_->notify();
+      }
+    }
+    doneCond_.notify_all();
+  }
+}
+
+void DiskIOEngine::write(const std::shared_ptr<PendingWrites>& file,
+                         uint64_t device, int fd, const unsigned char* data,
+                         size_t len, int64_t offset,
+                         std::shared_ptr<void> buffer)
+{
+  std::unique_lock<std::mutex> lk(mutex_);
+  auto& dev = devices_[device];
+  if (!dev) {
+    dev = make_unique<Device>();
+    dev->numJobs = 0;
+    dev->thread = std::thread(&DiskIOEngine::run, this, dev.get());
+  }
+  auto d = dev.get();
+  if (!d->queue.empty()) {
+    // The worker has not started the last job yet.
+    auto& last = d->queue.back();
+    if (last.file == file && last.fd == fd &&
+        last.offset + static_cast<int64_t>(last.len) == offset &&
+        last.segments.size() < MAX_SEGMENTS) {
+      last.segments.emplace_back(data, len);
+      last.len += len;
+      if (last.buffers.back() != buffer) {
+        last.buffers.push_back(std::move(buffer));
+      }
+      return;
+    }
+  }
+  // Back pressure: the event loop stops here while the device is
+  // behind.
+  doneCond_.wait(lk, [&] { return d->numJobs < queueDepth_; });
+  ++d->numJobs;
+  ++file->numPending;
+  Job job;
+  job.file = file;
+  job.fd = fd;
+  job.segments.emplace_back(data, len);
+  job.len = len;
+  job.offset = offset;
+  job.buffers.push_back(std::move(buffer));
+  d->queue.push_back(std::move(job));
+  d->cond.notify_one();
+}
+
+int DiskIOEngine::drain(PendingWrites& file)
+{
+  std::unique_lock<std::mutex> lk(mutex_);
+  doneCond_.wait(lk, [&] { return file.numPending == 0; });
+  int errNum = file.errNum;
+  file.errNum = 0;
+  return errNum;
+}
+
+void DiskIOEngine::wait(PendingWrites& file)
+{
+  std::unique_lock<std::mutex> lk(mutex_);
+  doneCond_.wait(lk, [&] { return file.numPending == 0; });
+}
+
+int DiskIOEngine::takeError(PendingWrites& file)
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  int errNum = file.errNum;
+  file.errNum = 0;
+  return errNum;
+}
+
+void DiskIOEngine::poll()
+{
+  std::vector<std::pair<std::string, int>> failures;
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    failures.swap(failures_);
+  }
+  for (auto& f : failures) {
+    A2_LOG_ERROR(fmt(EX_FILE_WRITE, f.first.c_str(),
+                     util::safeStrerror(f.second).c_str()));
+  }
+}
+
+void DiskIOEngine::setWakeupPipe(WakeupPipe* wakeupPipe)
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  wakeupPipe_ = wakeupPipe;
+}
+
+DiskIOEngine* DiskIOEngine::getInstance() { return instance_; }
+
+void DiskIOEngine::setInstance(DiskIOEngine* engine) { instance_ = engine; }
+
+DiskIOEngine::BufferScope::BufferScope(std::shared_ptr<void> buffer)
+    : saved_(std::move(buffer_))
+{
+  buffer_ = std::move(buffer);
+}
+
+DiskIOEngine::BufferScope::~BufferScope() { buffer_ = std::move(saved_); }
+
+const std::shared_ptr<void>& DiskIOEngine::getBuffer() { return buffer_; }
+
+} // namespace aria2
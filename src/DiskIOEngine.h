@@ -0,0 +1,179 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_DISK_IO_ENGINE_H
+#define D_DISK_IO_ENGINE_H
+
+#include "common.h"
+
+#include <string>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace aria2 {
+
+class WakeupPipe;
+
+// The writes submitted for one file.  Members are guarded by the
+// mutex of DiskIOEngine.
+struct PendingWrites {
+  PendingWrites(std::string filename)
+      : filename(std::move(filename)), numPending(0), errNum(0)
+  {
+  }
+  std::string filename;
+  // The number of writes queued or running.
+  size_t numPending;
+  // The error of the first failed write which is not reported yet.
+  int errNum;
+};
+
+// Writes files in worker threads so that a slow disk does not stall
+// the event loop.  There is one worker thread per device and writes
+// to one device are performed in the order of submission.  When the
+// queue of a device is full, write() blocks until a write completes.
+// A write which continues the last queued write to the same file is
+// merged into it, and they are performed by one pwritev().
+//
+// The file descriptor must stay open until the writes to it complete.
+// AbstractDiskWriter waits for them with drain() before it reads,
+// closes or resizes the file.
+class DiskIOEngine {
+public:
+  // |queueDepth| is the maximum number of writes queued for one
+  // device.
+  DiskIOEngine(size_t queueDepth);
+  // Waits for all submitted writes to complete.
+  ~DiskIOEngine();
+
+  // Don't allow copying
+  DiskIOEngine(const DiskIOEngine&) = delete;
+  DiskIOEngine& operator=(const DiskIOEngine&) = delete;
+
+  // Writes [data, data+len) at |offset| of |fd| which is on |device|.
+  // |buffer| owns data and is released when the write completes.
+  // Merged writes don't count toward the queue depth.
+  void write(const std::shared_ptr<PendingWrites>& file, uint64_t device,
+             int fd, const unsigned char* data, size_t len, int64_t offset,
+             std::shared_ptr<void> buffer);
+
+  // Waits until all writes of |file| complete.  Returns the error of
+  // a write failed since the last call, or 0.
+  int drain(PendingWrites& file);
+
+  // Waits until all writes of |file| complete.  The error of a failed
+  // write is kept for drain() or takeError().
+  void wait(PendingWrites& file);
+
+  // Returns the error of a write of |file| failed since the last call
+  // without waiting, or 0.
+  int takeError(PendingWrites& file);
+
+  // Logs failed writes.  This function is called by DownloadEngine in
+  // each iteration, because Logger is not thread-safe.
+  void poll();
+
+  // Notifies |wakeupPipe| when a write fails, so that poll() is
+  // called soon.  |wakeupPipe| may be nullptr.
+  void setWakeupPipe(WakeupPipe* wakeupPipe);
+
+  size_t getQueueDepth() const { return queueDepth_; }
+
+  // Returns the engine used by AbstractDiskWriter, or nullptr if
+  // files are written synchronously.
+  static DiskIOEngine* getInstance();
+
+  static void setInstance(DiskIOEngine* engine);
+
+  // While an instance of this class is alive, AbstractDiskWriter
+  // submits writes to the engine and keeps |buffer|, which owns the
+  // written data, until they complete.  Used from the main thread
+  // only.
+  class BufferScope {
+  public:
+    BufferScope(std::shared_ptr<void> buffer);
+    ~BufferScope();
+
+  private:
+    std::shared_ptr<void> saved_;
+  };
+
+  // Returns the buffer of the innermost BufferScope, or null.
+  static const std::shared_ptr<void>& getBuffer();
+
+private:
+  struct Job {
+    std::shared_ptr<PendingWrites> file;
+    int fd;
+    // Contiguous regions written from |offset|
+    std::vector<std::pair<const unsigned char*, size_t>> segments;
+    // The total length of segments
+    size_t len;
+    int64_t offset;
+    // Usually, all segments share one buffer.
+    std::vector<std::shared_ptr<void>> buffers;
+  };
+
+  struct Device {
+    std::deque<Job> queue;
+    // The number of jobs queued or running.
+    size_t numJobs;
+    std::condition_variable cond;
+    std::thread thread;
+  };
+
+  void run(Device* device);
+
+  size_t queueDepth_;
+  bool shutdown_;
+  WakeupPipe* wakeupPipe_;
+  std::mutex mutex_;
+  // Notified when a job completes.
+  std::condition_variable doneCond_;
+  std::map<uint64_t, std::unique_ptr<Device>> devices_;
+  // Failed writes not logged yet.  Pairs of file name and error.
+  std::vector<std::pair<std::string, int>> failures_;
+
+  static DiskIOEngine* instance_;
+  static std::shared_ptr<void> buffer_;
+};
+
+} // namespace aria2
+
+#endif // D_DISK_IO_ENGINE_H
@@ -67,6 +67,7 @@
 #include "DownloadFailureException.h"
 #include "MessageDigest.h"
 #include "message_digest_helper.h"
+#include "ConnectionScaler.h"
 #ifdef ENABLE_BITTORRENT
 #  include "bittorrent_helper.h"
 #endif // ENABLE_BITTORRENT
@@ -343,6 +344,15 @@ bool DownloadCommand::prepareForNextSegment()
     return true;
   }
   else {
+    const auto& scaler = getRequestGroup()->getConnectionScaler();
+    if (scaler && scaler->consumeShedConnection(getCuid())) {
+      A2_LOG_INFO(fmt("CUID#%" PRId64 " - Closing this connection to reduce"
+                      " the number of connections.",
+                      getCuid()));
+      getSegmentMan()->cancelSegment(getCuid());
+      getFileEntry()->poolRequest(getRequest());
+      return true;
+    }
     // The number of segments should be 1 in order to pass through the next
     // segment.
     if (getSegments().size() == 1) {
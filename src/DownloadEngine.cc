@@ -50,6 +50,7 @@
 #include "LogFactory.h"
 #include "Logger.h"
 #include "SocketCore.h"
+#include "SocketPool.h"
 #include "util.h"
 #include "a2functional.h"
 #include "DlAbortEx.h"
@@ -63,6 +64,10 @@
 #include "Command.h"
 #include "FileAllocationEntry.h"
 #include "CheckIntegrityEntry.h"
+#include "DiskIOEngine.h"
+#include "HashWorkerPool.h"
+#include "WakeupPipe.h"
+#include "RdDiskCache.h"
 #include "BtProgressInfoFile.h"
 #include "DownloadContext.h"
 #include "fmt.h"
@@ -92,11 +97,15 @@ volatile sig_atomic_t globalHaltRequested = 0;
 
 namespace {
 constexpr auto DEFAULT_REFRESH_INTERVAL = 1_s;
+// The maximum interval between checks for verified pieces when
+// WakeupPipe is not available.
+constexpr auto HASH_POLL_INTERVAL = 10_ms;
 } // namespace
 
 DownloadEngine::DownloadEngine(std::unique_ptr<EventPoll> eventPoll)
     : eventPoll_(std::move(eventPoll)),
       haltRequested_(0),
+      socketPool_(make_unique<SocketPool>()),
       noWait_(true),
       refreshInterval_(DEFAULT_REFRESH_INTERVAL),
       lastRefresh_(Timer::zero()),
@@ -120,6 +129,10 @@ DownloadEngine::~DownloadEngine()
 #ifdef HAVE_ARES_ADDR_NODE
   setAsyncDNSServers(nullptr);
 #endif // HAVE_ARES_ADDR_NODE
+  if (wakeupPipe_) {
+    eventPoll_->deleteEvents(wakeupPipe_->getReadFd(), wakeupCommand_.get(),
+                             EventPoll::EVENT_READ);
+  }
 }
 
 namespace {
@@ -173,6 +186,17 @@ int DownloadEngine::run(bool oneshot)
     noWait_ = false;
     global::wallclock().reset();
     calculateStatistics();
+    // Invoke the callbacks first, so that the commands they make
+    // active are executed in this iteration.
+    if (wakeupPipe_) {
+      wakeupPipe_->drain();
+    }
+    if (diskIOEngine_) {
+      diskIOEngine_->poll();
+    }
+    if (hashWorkerPool_) {
+      hashWorkerPool_->poll();
+    }
     if (lastRefresh_.difference(global::wallclock()) + A2_DELTA_MILLIS >=
         refreshInterval_) {
       refreshInterval_ = DEFAULT_REFRESH_INTERVAL;
@@ -183,6 +207,15 @@ int DownloadEngine::run(bool oneshot)
       executeCommand(commands_, Command::STATUS_ACTIVE);
     }
     executeCommand(routineCommands_, Command::STATUS_ALL);
+    if (!wakeupPipe_ && hashWorkerPool_ &&
+        hashWorkerPool_->getNumPending() > 0) {
+      // Don't sleep long while pieces are verified.
+      refreshInterval_ = std::min(refreshInterval_, HASH_POLL_INTERVAL);
+    }
+    if (rdDiskCache_) {
+      // Give the memory back to the write cache as it grows.
+      rdDiskCache_->ensureLimit();
+    }
     afterEachIteration();
     if (!noWait_ && oneshot) {
       return 1;
@@ -309,50 +342,7 @@ void DownloadEngine::addRoutineCommand(std::unique_ptr<Command> command)
   routineCommands_.push_back(std::move(command));
 }
 
-void DownloadEngine::poolSocket(const std::string& key,
-                                const SocketPoolEntry& entry)
-{
-  A2_LOG_INFO(fmt("Pool socket for %s", key.c_str()));
-  std::multimap<std::string, SocketPoolEntry>::value_type p(key, entry);
-  socketPool_.insert(p);
-}
-
-void DownloadEngine::evictSocketPool()
-{
-  if (socketPool_.empty()) {
-    return;
-  }
-
-  std::multimap<std::string, SocketPoolEntry> newPool;
-  A2_LOG_DEBUG("Scanning SocketPool and erasing timed out entry.");
-  for (auto& elem : socketPool_) {
-    if (!elem.second.isTimeout()) {
-      newPool.insert(elem);
-    }
-  }
-  A2_LOG_DEBUG(
-      fmt("%lu entries removed.",
-          static_cast<unsigned long>(socketPool_.size() - newPool.size())));
-  socketPool_ = std::move(newPool);
-}
-
-namespace {
-std::string createSockPoolKey(const std::string& host, uint16_t port,
-                              const std::string& username,
-                              const std::string& proxyhost, uint16_t proxyport)
-{
-  std::string key;
-  if (!username.empty()) {
-    key += util::percentEncode(username);
-    key += "@";
-  }
-  key += fmt("%s(%u)", host.c_str(), port);
-  if (!proxyhost.empty()) {
-    key += fmt("/%s(%u)", proxyhost.c_str(), proxyport);
-  }
-  return key;
-}
-} // namespace
+void DownloadEngine::evictSocketPool() { socketPool_->evictExpired(); }
 
 void DownloadEngine::poolSocket(const std::string& ipaddr, uint16_t port,
                                 const std::string& username,
@@ -362,9 +352,8 @@ void DownloadEngine::poolSocket(const std::string& ipaddr, uint16_t port,
                                 const std::string& options,
                                 std::chrono::seconds timeout)
 {
-  SocketPoolEntry e(sock, options, std::move(timeout));
-  poolSocket(createSockPoolKey(ipaddr, port, username, proxyhost, proxyport),
-             e);
+  socketPool_->add(SocketPoolKey(ipaddr, port, username, proxyhost, proxyport),
+                   sock, options, std::move(timeout));
 }
 
 void DownloadEngine::poolSocket(const std::string& ipaddr, uint16_t port,
@@ -373,9 +362,9 @@ void DownloadEngine::poolSocket(const std::string& ipaddr, uint16_t port,
                                 const std::shared_ptr<SocketCore>& sock,
                                 std::chrono::seconds timeout)
 {
-  SocketPoolEntry e(sock, std::move(timeout));
-  poolSocket(createSockPoolKey(ipaddr, port, A2STR::NIL, proxyhost, proxyport),
-             e);
+  socketPool_->add(
+      SocketPoolKey(ipaddr, port, A2STR::NIL, proxyhost, proxyport), sock,
+      A2STR::NIL, std::move(timeout));
 }
 
 namespace {
@@ -435,37 +424,14 @@ void DownloadEngine::poolSocket(const std::shared_ptr<Request>& request,
   }
 }
 
-std::multimap<std::string, DownloadEngine::SocketPoolEntry>::iterator
-DownloadEngine::findSocketPoolEntry(const std::string& key)
-{
-  std::pair<std::multimap<std::string, SocketPoolEntry>::iterator,
-            std::multimap<std::string, SocketPoolEntry>::iterator>
-      range = socketPool_.equal_range(key);
-  for (auto i = range.first, eoi = range.second; i != eoi; ++i) {
-    const SocketPoolEntry& e = (*i).second;
-    // We assume that if socket is readable it means peer shutdowns
-    // connection and the socket will receive EOF. So skip it.
-    if (!e.isTimeout() && !e.getSocket()->isReadable(0)) {
-      A2_LOG_INFO(fmt("Found socket for %s", key.c_str()));
-      return i;
-    }
-  }
-  return socketPool_.end();
-}
-
 std::shared_ptr<SocketCore>
 DownloadEngine::popPooledSocket(const std::string& ipaddr, uint16_t port,
                                 const std::string& proxyhost,
                                 uint16_t proxyport)
 {
-  std::shared_ptr<SocketCore> s;
-  auto i = findSocketPoolEntry(
-      createSockPoolKey(ipaddr, port, A2STR::NIL, proxyhost, proxyport));
-  if (i != socketPool_.end()) {
-    s = (*i).second.getSocket();
-    socketPool_.erase(i);
-  }
-  return s;
+  std::string options;
+  return socketPool_->pop(
+      options, SocketPoolKey(ipaddr, port, A2STR::NIL, proxyhost, proxyport));
 }
 
 std::shared_ptr<SocketCore>
@@ -474,15 +440,8 @@ DownloadEngine::popPooledSocket(std::string& options, const std::string& ipaddr,
                                 const std::string& proxyhost,
                                 uint16_t proxyport)
 {
-  std::shared_ptr<SocketCore> s;
-  auto i = findSocketPoolEntry(
-      createSockPoolKey(ipaddr, port, username, proxyhost, proxyport));
-  if (i != socketPool_.end()) {
-    s = (*i).second.getSocket();
-    options = (*i).second.getOptions();
-    socketPool_.erase(i);
-  }
-  return s;
+  return socketPool_->pop(
+      options, SocketPoolKey(ipaddr, port, username, proxyhost, proxyport));
 }
 
 std::shared_ptr<SocketCore>
@@ -514,26 +473,6 @@ DownloadEngine::popPooledSocket(std::string& options,
   return s;
 }
 
-DownloadEngine::SocketPoolEntry::SocketPoolEntry(
-    const std::shared_ptr<SocketCore>& socket, const std::string& options,
-    std::chrono::seconds timeout)
-    : socket_(socket), options_(options), timeout_(std::move(timeout))
-{
-}
-
-DownloadEngine::SocketPoolEntry::SocketPoolEntry(
-    const std::shared_ptr<SocketCore>& socket, std::chrono::seconds timeout)
-    : socket_(socket), timeout_(std::move(timeout))
-{
-}
-
-DownloadEngine::SocketPoolEntry::~SocketPoolEntry() = default;
-
-bool DownloadEngine::SocketPoolEntry::isTimeout() const
-{
-  return registeredTime_.difference(global::wallclock()) >= timeout_;
-}
-
 cuid_t DownloadEngine::newCUID() { return cuidCounter_.newID(); }
 
 const std::string&
@@ -549,12 +488,41 @@ void DownloadEngine::cacheIPAddress(const std::string& hostname,
   dnsCache_->put(hostname, ipaddr, port);
 }
 
+void DownloadEngine::cacheIPAddress(const std::string& hostname,
+                                    const std::string& ipaddr, uint16_t port,
+                                    std::chrono::seconds ttl)
+{
+  dnsCache_->put(hostname, ipaddr, port, std::move(ttl));
+}
+
+void DownloadEngine::cacheNameResolveError(const std::string& hostname,
+                                           uint16_t port,
+                                           const std::string& error)
+{
+  dnsCache_->putError(hostname, port, error);
+}
+
+const std::string&
+DownloadEngine::findCachedNameResolveError(const std::string& hostname,
+                                           uint16_t port) const
+{
+  return dnsCache_->findError(hostname, port);
+}
+
 void DownloadEngine::markBadIPAddress(const std::string& hostname,
                                       const std::string& ipaddr, uint16_t port)
 {
   dnsCache_->markBad(hostname, ipaddr, port);
 }
 
+void DownloadEngine::updateIPAddressRTT(const std::string& hostname,
+                                        const std::string& ipaddr,
+                                        uint16_t port,
+                                        std::chrono::milliseconds rtt)
+{
+  dnsCache_->setRTT(hostname, ipaddr, port, std::move(rtt));
+}
+
 void DownloadEngine::removeCachedIPAddress(const std::string& hostname,
                                            uint16_t port)
 {
@@ -606,12 +574,73 @@ void DownloadEngine::setFileAllocationMan(
   fileAllocationMan_ = std::move(faman);
 }
 
+void DownloadEngine::setDNSCache(std::unique_ptr<DNSCache> dnsCache)
+{
+  dnsCache_ = std::move(dnsCache);
+}
+
 void DownloadEngine::setCheckIntegrityMan(
     std::unique_ptr<CheckIntegrityMan> ciman)
 {
   checkIntegrityMan_ = std::move(ciman);
 }
 
+namespace {
+// Makes EventPoll return when WakeupPipe is notified.  The work is
+// done by DownloadEngine::run() after EventPoll returns.
+class WakeupCommand : public Command {
+public:
+  WakeupCommand() : Command(0) {}
+
+  virtual bool execute() CXX11_OVERRIDE { return true; }
+};
+} // namespace
+
+void DownloadEngine::initWakeupPipe()
+{
+  if (wakeupPipe_) {
+    return;
+  }
+  try {
+    auto pipe = make_unique<WakeupPipe>();
+    auto command = make_unique<WakeupCommand>();
+    if (eventPoll_->addEvents(pipe->getReadFd(), command.get(),
+                              EventPoll::EVENT_READ)) {
+      wakeupPipe_ = std::move(pipe);
+      wakeupCommand_ = std::move(command);
+    }
+  }
+  catch (RecoverableException& e) {
+    A2_LOG_INFO_EX("Completions in worker threads are polled.", e);
+  }
+}
+
+void DownloadEngine::setDiskIOEngine(std::unique_ptr<DiskIOEngine> engine)
+{
+  diskIOEngine_ = std::move(engine);
+  DiskIOEngine::setInstance(diskIOEngine_.get());
+  if (diskIOEngine_) {
+    initWakeupPipe();
+    diskIOEngine_->setWakeupPipe(wakeupPipe_.get());
+  }
+}
+
+void DownloadEngine::setHashWorkerPool(std::unique_ptr<HashWorkerPool> pool)
+{
+  hashWorkerPool_ = std::move(pool);
+  HashWorkerPool::setInstance(hashWorkerPool_.get());
+  if (hashWorkerPool_) {
+    initWakeupPipe();
+    hashWorkerPool_->setWakeupPipe(wakeupPipe_.get());
+  }
+}
+
+void DownloadEngine::setRdDiskCache(std::unique_ptr<RdDiskCache> cache)
+{
+  rdDiskCache_ = std::move(cache);
+  RdDiskCache::setInstance(rdDiskCache_.get());
+}
+
 #ifdef HAVE_ARES_ADDR_NODE
 void DownloadEngine::setAsyncDNSServers(ares_addr_node* asyncDNSServers)
 {
@@ -60,11 +60,16 @@ class Option;
 class RequestGroupMan;
 class StatCalc;
 class SocketCore;
+class SocketPool;
 class CookieStorage;
 class AuthConfigFactory;
 class Request;
 class EventPoll;
 class Command;
+class DiskIOEngine;
+class HashWorkerPool;
+class WakeupPipe;
+class RdDiskCache;
 #ifdef ENABLE_BITTORRENT
 class BtRegistry;
 #endif // ENABLE_BITTORRENT
@@ -93,34 +98,7 @@ private:
 
   int haltRequested_;
 
-  class SocketPoolEntry {
-  private:
-    std::shared_ptr<SocketCore> socket_;
-    // protocol specific option string
-    std::string options_;
-
-    std::chrono::seconds timeout_;
-
-    Timer registeredTime_;
-
-  public:
-    SocketPoolEntry(const std::shared_ptr<SocketCore>& socket,
-                    const std::string& option, std::chrono::seconds timeout);
-
-    SocketPoolEntry(const std::shared_ptr<SocketCore>& socket,
-                    std::chrono::seconds timeout);
-
-    ~SocketPoolEntry();
-
-    bool isTimeout() const;
-
-    const std::shared_ptr<SocketCore>& getSocket() const { return socket_; }
-
-    const std::string& getOptions() const { return options_; }
-  };
-
-  // key = IP address:port, value = SocketPoolEntry
-  std::multimap<std::string, SocketPoolEntry> socketPool_;
+  std::unique_ptr<SocketPool> socketPool_;
 
   Timer lastSocketPoolScan_;
 
@@ -158,12 +136,24 @@ private:
 
   void afterEachIteration();
 
-  void poolSocket(const std::string& key, const SocketPoolEntry& entry);
-
-  std::multimap<std::string, SocketPoolEntry>::iterator
-  findSocketPoolEntry(const std::string& key);
-
+  // Creates wakeupPipe_ if it does not exist yet.
+  void initWakeupPipe();
+
+  // Notified by the worker threads of diskIOEngine_ and
+  // hashWorkerPool_.  nullptr if they are not used, or pipe is not
+  // available.  Declared before them so that it outlives the workers.
+  std::unique_ptr<WakeupPipe> wakeupPipe_;
+  // Registered to eventPoll_ with the read end of wakeupPipe_.  It is
+  // never executed.
+  std::unique_ptr<Command> wakeupCommand_;
+  // Declared before requestGroupMan_ so that the files of
+  // RequestGroups are closed while the engine is alive.
+  std::unique_ptr<DiskIOEngine> diskIOEngine_;
+  std::unique_ptr<HashWorkerPool> hashWorkerPool_;
   std::unique_ptr<RequestGroupMan> requestGroupMan_;
+  // Declared after requestGroupMan_ because it refers to the
+  // WrDiskCache of requestGroupMan_.
+  std::unique_ptr<RdDiskCache> rdDiskCache_;
   std::unique_ptr<FileAllocationMan> fileAllocationMan_;
   std::unique_ptr<CheckIntegrityMan> checkIntegrityMan_;
   Option* option_;
@@ -229,6 +219,32 @@ public:
 
   void setCheckIntegrityMan(std::unique_ptr<CheckIntegrityMan> ciman);
 
+  const std::unique_ptr<DiskIOEngine>& getDiskIOEngine() const
+  {
+    return diskIOEngine_;
+  }
+
+  // Also makes |engine| the instance used by AbstractDiskWriter.
+  void setDiskIOEngine(std::unique_ptr<DiskIOEngine> engine);
+
+  const std::unique_ptr<HashWorkerPool>& getHashWorkerPool() const
+  {
+    return hashWorkerPool_;
+  }
+
+  // Also makes |pool| the instance used by BtPieceMessage.
+  void setHashWorkerPool(std::unique_ptr<HashWorkerPool> pool);
+
+  const std::unique_ptr<RdDiskCache>& getRdDiskCache() const
+  {
+    return rdDiskCache_;
+  }
+
+  // Also makes |cache| the instance used by BtPieceMessage.
+  void setRdDiskCache(std::unique_ptr<RdDiskCache> cache);
+
+  void setDNSCache(std::unique_ptr<DNSCache> dnsCache);
+
   Option* getOption() const { return option_; }
 
   void setOption(Option* op) { option_ = op; }
@@ -289,6 +305,11 @@ public:
 
   void evictSocketPool();
 
+  const std::unique_ptr<SocketPool>& getSocketPool() const
+  {
+    return socketPool_;
+  }
+
   const std::unique_ptr<CookieStorage>& getCookieStorage() const;
 
 #ifdef ENABLE_BITTORRENT
@@ -313,9 +334,27 @@ public:
   void cacheIPAddress(const std::string& hostname, const std::string& ipaddr,
                       uint16_t port);
 
+  // Caches |ipaddr| for |ttl|, which is the TTL of the DNS record.
+  void cacheIPAddress(const std::string& hostname, const std::string& ipaddr,
+                      uint16_t port, std::chrono::seconds ttl);
+
+  // Caches the failure of name resolution of |hostname|.
+  void cacheNameResolveError(const std::string& hostname, uint16_t port,
+                             const std::string& error);
+
+  // Returns the error message of the cached failure of name
+  // resolution of |hostname|, or empty string.
+  const std::string& findCachedNameResolveError(const std::string& hostname,
+                                                uint16_t port) const;
+
   void markBadIPAddress(const std::string& hostname, const std::string& ipaddr,
                         uint16_t port);
 
+  // Records that connection to |ipaddr| took |rtt| to establish.
+  void updateIPAddressRTT(const std::string& hostname,
+                          const std::string& ipaddr, uint16_t port,
+                          std::chrono::milliseconds rtt);
+
   void removeCachedIPAddress(const std::string& hostname, uint16_t port);
 
   void setAuthConfigFactory(std::unique_ptr<AuthConfigFactory> factory);
@@ -42,6 +42,9 @@
 #include "RequestGroupMan.h"
 #include "FileAllocationMan.h"
 #include "CheckIntegrityMan.h"
+#include "DiskIOEngine.h"
+#include "HashWorkerPool.h"
+#include "RdDiskCache.h"
 #include "CheckIntegrityEntry.h"
 #include "CheckIntegrityDispatcherCommand.h"
 #include "prefs.h"
@@ -58,6 +61,8 @@
 #include "DownloadContext.h"
 #include "array_fun.h"
 #include "EvictSocketPoolCommand.h"
+#include "DNSCache.h"
+#include "SocketPool.h"
 #ifdef HAVE_LIBUV
 #  include "LibuvEventPoll.h"
 #endif // HAVE_LIBUV
@@ -156,10 +161,42 @@ std::unique_ptr<DownloadEngine> DownloadEngineFactory::newDownloadEngine(
     auto requestGroupMan = make_unique<RequestGroupMan>(
         std::move(requestGroups), MAX_CONCURRENT_DOWNLOADS, op);
     requestGroupMan->initWrDiskCache();
+    if (op->getAsInt(PREF_DISK_CACHE) > 0) {
+      // Pieces read for seeding use the part of --disk-cache the
+      // write cache does not use.
+      e->setRdDiskCache(make_unique<RdDiskCache>(
+          op->getAsInt(PREF_DISK_CACHE), requestGroupMan->getWrDiskCache()));
+    }
     e->setRequestGroupMan(std::move(requestGroupMan));
   }
   e->setFileAllocationMan(make_unique<FileAllocationMan>());
-  e->setCheckIntegrityMan(make_unique<CheckIntegrityMan>());
+  {
+    auto checkIntegrityMan = make_unique<CheckIntegrityMan>();
+    checkIntegrityMan->setMaxPicked(op->getAsInt(PREF_MAX_CONCURRENT_CHECKS));
+    e->setCheckIntegrityMan(std::move(checkIntegrityMan));
+  }
+#ifndef __MINGW32__
+  if (op->getAsInt(PREF_DISK_IO_QUEUE_DEPTH) > 0) {
+    e->setDiskIOEngine(
+        make_unique<DiskIOEngine>(op->getAsInt(PREF_DISK_IO_QUEUE_DEPTH)));
+  }
+#endif // !__MINGW32__
+  if (op->getAsInt(PREF_HASH_WORKER_THREADS) > 0) {
+    // Piece data are copied for verification.  Bound the memory used
+    // for them; pieces beyond the limit are verified synchronously.
+    e->setHashWorkerPool(make_unique<HashWorkerPool>(
+        op->getAsInt(PREF_HASH_WORKER_THREADS), 64_m));
+  }
+  {
+    auto dnsCache = make_unique<DNSCache>(op->getAsInt(PREF_DNS_CACHE_SIZE));
+    dnsCache->setTTL(std::chrono::seconds(op->getAsInt(PREF_DNS_CACHE_TTL)));
+    dnsCache->setNegativeTTL(
+        std::chrono::seconds(op->getAsInt(PREF_DNS_NEGATIVE_CACHE_TTL)));
+    e->setDNSCache(std::move(dnsCache));
+  }
+  e->getSocketPool()->setMaxSize(op->getAsInt(PREF_MAX_POOLED_CONNECTIONS));
+  e->getSocketPool()->setMaxSizePerHost(
+      op->getAsInt(PREF_MAX_POOLED_CONNECTIONS_PER_HOST));
   e->addRoutineCommand(
       make_unique<FillRequestGroupCommand>(e->newCUID(), e.get()));
   e->addRoutineCommand(make_unique<FileAllocationDispatcherCommand>(
@@ -167,7 +204,7 @@ std::unique_ptr<DownloadEngine> DownloadEngineFactory::newDownloadEngine(
   e->addRoutineCommand(make_unique<CheckIntegrityDispatcherCommand>(
       e->newCUID(), e->getCheckIntegrityMan().get(), e.get()));
   e->addRoutineCommand(
-      make_unique<EvictSocketPoolCommand>(e->newCUID(), e.get(), 30_s));
+      make_unique<EvictSocketPoolCommand>(e->newCUID(), e.get(), 5_s));
 
   if (op->getAsInt(PREF_AUTO_SAVE_INTERVAL) > 0) {
     e->addRoutineCommand(make_unique<AutoSaveCommand>(
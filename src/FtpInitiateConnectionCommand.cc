@@ -56,7 +56,7 @@
 #include "AuthConfig.h"
 #include "fmt.h"
 #include "SocketRecvBuffer.h"
-#include "BackupIPv4ConnectCommand.h"
+#include "BackupConnectCommand.h"
 #include "FtpNegotiationConnectChain.h"
 #include "FtpTunnelRequestConnectChain.h"
 #include "HttpRequestConnectChain.h"
@@ -0,0 +1,198 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "HashWorkerPool.h"
+
+#include <algorithm>
+
+#include "MessageDigest.h"
+#include "WakeupPipe.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+HashWorkerPool* HashWorkerPool::instance_ = nullptr;
+
+HashWorkerPool::HashWorkerPool(size_t numThreads, size_t memoryLimit)
+    : memoryLimit_(memoryLimit),
+      pendingBytes_(0),
+      numPending_(0),
+      shutdown_(false),
+      wakeupPipe_(nullptr)
+{
+  for (size_t i = 0; i < std::max(numThreads, static_cast<size_t>(1)); ++i) {
+    threads_.emplace_back(&HashWorkerPool::run, this);
+  }
+}
+
+HashWorkerPool::~HashWorkerPool()
+{
+  if (instance_ == this) {
+    instance_ = nullptr;
+  }
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    shutdown_ = true;
+  }
+  cond_.notify_all();
+  for (auto& th : threads_) {
+    th.join();
+  }
+}
+
+void HashWorkerPool::run()
+{
+  std::unique_lock<std::mutex> lk(mutex_);
+  for (;;) {
+    cond_.wait(lk, [&] { return shutdown_ || !queue_.empty(); });
+    if (shutdown_) {
+      return;
+    }
+    auto job = std::move(queue_.front());
+    queue_.pop_front();
+    running_.push_back(job.get());
+    lk.unlock();
+    auto ctx = MessageDigest::create(job->hashType);
+    ctx->update(job->data.data(), job->data.size());
+    job->digest = ctx->digest();
+    size_t length = job->data.size();
+    // Release the memory now rather than when poll() is called.
+    std::vector<unsigned char>().swap(job->data);
+    lk.lock();
+    pendingBytes_ -= length;
+    running_.erase(std::find(std::begin(running_), std::end(running_),
+                             job.get()));
+    // Cancelled jobs are also handed over to the main thread, because
+    // the callback may hold objects which must not be destroyed here.
+    done_.push_back(std::move(job));
+    if (wakeupPipe_) {
+      wakeupPipe_->notify();
+    }
+  }
+}
+
+bool HashWorkerPool::hasRoom(size_t length) const
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  return pendingBytes_ == 0 || pendingBytes_ + length <= memoryLimit_;
+}
+
+void HashWorkerPool::submit(const void* owner, std::string hashType,
+                            std::vector<unsigned char> data, Callback callback)
+{
+  auto job = make_unique<Job>();
+  job->owner = owner;
+  job->hashType = std::move(hashType);
+  job->data = std::move(data);
+  job->callback = std::move(callback);
+  job->cancelled = false;
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    pendingBytes_ += job->data.size();
+    ++numPending_;
+    queue_.push_back(std::move(job));
+  }
+  cond_.notify_one();
+}
+
+void HashWorkerPool::cancel(const void* owner)
+{
+  std::deque<std::unique_ptr<Job>> cancelled;
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    for (auto i = std::begin(queue_); i != std::end(queue_);) {
+      if ((*i)->owner == owner) {
+        pendingBytes_ -= (*i)->data.size();
+        --numPending_;
+        cancelled.push_back(std::move(*i));
+        i = queue_.erase(i);
+      }
+      else {
+        ++i;
+      }
+    }
+    for (auto job : running_) {
+      if (job->owner == owner && !job->cancelled) {
+        job->cancelled = true;
+        --numPending_;
+      }
+    }
+    for (auto& job : done_) {
+      if (job->owner == owner && !job->cancelled) {
+        job->cancelled = true;
+        --numPending_;
+      }
+    }
+  }
+}
+
+void HashWorkerPool::poll()
+{
+  // Take one job at a time, because a callback may cancel the jobs of
+  // other downloads.
+  for (;;) {
+    std::unique_ptr<Job> job;
+    {
+      std::lock_guard<std::mutex> lk(mutex_);
+      if (done_.empty()) {
+        return;
+      }
+      job = std::move(done_.front());
+      done_.pop_front();
+      if (job->cancelled) {
+        continue;
+      }
+      --numPending_;
+    }
+    job->callback(job->digest);
+  }
+}
+
+size_t HashWorkerPool::getNumPending() const
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  return numPending_;
+}
+
+void HashWorkerPool::setWakeupPipe(WakeupPipe* wakeupPipe)
+{
+  std::lock_guard<std::mutex> lk(mutex_);
+  wakeupPipe_ = wakeupPipe;
+}
+
+HashWorkerPool* HashWorkerPool::getInstance() { return instance_; }
+
+void HashWorkerPool::setInstance(HashWorkerPool* pool) { instance_ = pool; }
+
+} // namespace aria2
@@ -0,0 +1,134 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_HASH_WORKER_POOL_H
+#define D_HASH_WORKER_POOL_H
+
+#include "common.h"
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace aria2 {
+
+class WakeupPipe;
+
+// Computes message digests of piece data in worker threads so that
+// verifying a large piece does not stall the event loop.  Callbacks
+// are invoked from poll(), which DownloadEngine calls when the
+// WakeupPipe given by setWakeupPipe() is notified.
+class HashWorkerPool {
+public:
+  // Receives the raw digest of the submitted data.
+  typedef std::function<void(const std::string& digest)> Callback;
+
+  // Starts |numThreads| worker threads.  The data of jobs queued or
+  // running are limited to |memoryLimit| bytes in total.
+  HashWorkerPool(size_t numThreads, size_t memoryLimit);
+  // Discards pending jobs and joins worker threads.
+  ~HashWorkerPool();
+
+  // Don't allow copying
+  HashWorkerPool(const HashWorkerPool&) = delete;
+  HashWorkerPool& operator=(const HashWorkerPool&) = delete;
+
+  // Returns true if the data of |length| bytes can be submitted now.
+  // If this function returns false, the caller should compute the
+  // digest by itself.  A job is always accepted when the pool is
+  // idle.
+  bool hasRoom(size_t length) const;
+
+  // Computes the digest of |data| using |hashType|.  |callback| is
+  // invoked from poll() unless the jobs of |owner| are cancelled
+  // before.
+  void submit(const void* owner, std::string hashType,
+              std::vector<unsigned char> data, Callback callback);
+
+  // Cancels the jobs submitted by |owner|.  Their callbacks are never
+  // invoked.
+  void cancel(const void* owner);
+
+  // Invokes the callbacks of completed jobs.
+  void poll();
+
+  // Returns the number of jobs whose callbacks are not invoked yet.
+  size_t getNumPending() const;
+
+  // Notifies |wakeupPipe| each time a job completes.  |wakeupPipe|
+  // may be nullptr.
+  void setWakeupPipe(WakeupPipe* wakeupPipe);
+
+  // Returns the pool used to verify pieces, or nullptr if pieces are
+  // verified in the event loop.
+  static HashWorkerPool* getInstance();
+
+  static void setInstance(HashWorkerPool* pool);
+
+private:
+  struct Job {
+    const void* owner;
+    std::string hashType;
+    std::vector<unsigned char> data;
+    Callback callback;
+    std::string digest;
+    bool cancelled;
+  };
+
+  void run();
+
+  size_t memoryLimit_;
+  // The total size of data of jobs queued or running.
+  size_t pendingBytes_;
+  size_t numPending_;
+  bool shutdown_;
+  WakeupPipe* wakeupPipe_;
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::unique_ptr<Job>> queue_;
+  std::vector<Job*> running_;
+  std::deque<std::unique_ptr<Job>> done_;
+  std::vector<std::thread> threads_;
+
+  static HashWorkerPool* instance_;
+};
+
+} // namespace aria2
+
+#endif // D_HASH_WORKER_POOL_H
@@ -35,6 +35,7 @@
 #include "HttpConnection.h"
 
 #include <sstream>
+#include <algorithm>
 
 #include "util.h"
 #include "message.h"
@@ -90,7 +91,8 @@ HttpConnection::HttpConnection(
     : cuid_(cuid),
       socket_(socket),
       socketRecvBuffer_(socketRecvBuffer),
-      socketBuffer_(socket)
+      socketBuffer_(socket),
+      numResponses_(0)
 {
 }
 
@@ -126,6 +128,7 @@ void HttpConnection::sendRequest(std::unique_ptr<HttpRequest> httpRequest,
       fmt(MSG_SENDING_REQUEST, cuid_, eraseConfidentialInfo(request).c_str()));
   socketBuffer_.pushStr(std::move(request));
   socketBuffer_.send();
+  httpRequest->setPipelined(!outstandingHttpRequests_.empty());
   outstandingHttpRequests_.push_back(
       make_unique<HttpRequestEntry>(std::move(httpRequest)));
 }
@@ -150,6 +153,26 @@ std::unique_ptr<HttpResponse> HttpConnection::receiveResponse()
   if (socketRecvBuffer_->bufferEmpty()) {
     if (socketRecvBuffer_->recv() == 0 && !socket_->wantRead() &&
         !socket_->wantWrite()) {
+      const auto& req =
+          outstandingHttpRequests_.front()->getHttpRequest()->getRequest();
+      if (numResponses_ > 0 && req && req->isPipeliningEnabled() &&
+          std::any_of(std::begin(outstandingHttpRequests_),
+                      std::end(outstandingHttpRequests_),
+                      [](const std::unique_ptr<HttpRequestEntry>& ent) {
+                        return ent->getHttpRequest()->isPipelined();
+                      })) {
+        // The server answered some of pipelined requests and closed
+        // the connection.  Retry the rest one by one.  A request sent
+        // alone may just hit the keep-alive timeout, which says
+        // nothing about pipelining.
+        A2_LOG_INFO(fmt("CUID#%" PRId64 " - Server closed connection with"
+                        " %lu pipelined request(s) outstanding. Disable"
+                        " pipelining.",
+                        cuid_,
+                        static_cast<unsigned long>(
+                            outstandingHttpRequests_.size())));
+        req->disablePipelining();
+      }
       throw DL_RETRY_EX(EX_GOT_EOF);
     }
   }
@@ -173,6 +196,7 @@ std::unique_ptr<HttpResponse> HttpConnection::receiveResponse()
         outstandingHttpRequests_.front()->popHttpRequest());
     socketRecvBuffer_->drain(proc->getLastBytesProcessed());
     outstandingHttpRequests_.pop_front();
+    ++numResponses_;
     return httpResponse;
   }
 
@@ -87,6 +87,9 @@ private:
 
   HttpRequestEntries outstandingHttpRequests_;
 
+  // The number of responses received on this connection.
+  size_t numResponses_;
+
   std::string eraseConfidentialInfo(const std::string& request);
   void sendRequest(std::unique_ptr<HttpRequest> httpRequest,
                    std::string request);
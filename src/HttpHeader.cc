@@ -33,6 +33,9 @@
  */
 /* copyright --> */
 #include "HttpHeader.h"
+
+#include <algorithm>
+
 #include "Range.h"
 #include "util.h"
 #include "A2STR.h"
@@ -41,24 +44,54 @@
 
 namespace aria2 {
 
-HttpHeader::HttpHeader() : statusCode_(0) {}
+HttpHeader::HttpHeader() : statusCode_(0), authScheme_(AUTH_NONE)
+{
+  // Most of the responses have less than 8 fields we are interested
+  // in.  Reserve them up front to avoid reallocation in put().
+  table_.reserve(8);
+}
 
 HttpHeader::~HttpHeader() = default;
 
-void HttpHeader::put(int hdKey, const std::string& value)
+namespace {
+struct FieldKeyLess {
+  bool operator()(const std::pair<int, std::string>& field, int hdKey) const
+  {
+    return field.first < hdKey;
+  }
+  bool operator()(int hdKey, const std::pair<int, std::string>& field) const
+  {
+    return hdKey < field.first;
+  }
+};
+} // namespace
+
+void HttpHeader::put(int hdKey, std::string value)
 {
-  std::multimap<int, std::string>::value_type vt(hdKey, value);
-  table_.insert(vt);
+  // Insert after the fields with the same key to keep their order.
+  auto i = std::upper_bound(std::begin(table_), std::end(table_), hdKey,
+                            FieldKeyLess());
+  table_.emplace(i, hdKey, std::move(value));
 }
 
-void HttpHeader::remove(int hdKey) { table_.erase(hdKey); }
+void HttpHeader::remove(int hdKey)
+{
+  auto r = std::equal_range(std::begin(table_), std::end(table_), hdKey,
+                            FieldKeyLess());
+  table_.erase(r.first, r.second);
+}
 
-bool HttpHeader::defined(int hdKey) const { return table_.count(hdKey); }
+bool HttpHeader::defined(int hdKey) const
+{
+  return std::binary_search(std::begin(table_), std::end(table_), hdKey,
+                            FieldKeyLess());
+}
 
 const std::string& HttpHeader::find(int hdKey) const
 {
-  auto itr = table_.find(hdKey);
-  if (itr == table_.end()) {
+  auto itr = std::lower_bound(std::begin(table_), std::end(table_), hdKey,
+                              FieldKeyLess());
+  if (itr == std::end(table_) || (*itr).first != hdKey) {
     return A2STR::NIL;
   }
   else {
@@ -66,11 +99,22 @@ const std::string& HttpHeader::find(int hdKey) const
   }
 }
 
-std::pair<std::multimap<int, std::string>::const_iterator,
-          std::multimap<int, std::string>::const_iterator>
+std::vector<std::string> HttpHeader::findAll(int hdKey) const
+{
+  std::vector<std::string> v;
+  auto r = equalRange(hdKey);
+  for (auto i = r.first; i != r.second; ++i) {
+    v.push_back((*i).second);
+  }
+  return v;
+}
+
+std::pair<HttpHeader::FieldTable::const_iterator,
+          HttpHeader::FieldTable::const_iterator>
 HttpHeader::equalRange(int hdKey) const
 {
-  return table_.equal_range(hdKey);
+  return std::equal_range(std::begin(table_), std::end(table_), hdKey,
+                          FieldKeyLess());
 }
 
 Range HttpHeader::getRange() const
@@ -183,9 +227,7 @@ void HttpHeader::setReasonPhrase(const std::string& reasonPhrase)
 
 bool HttpHeader::fieldContains(int hdKey, const char* value)
 {
-  std::pair<std::multimap<int, std::string>::const_iterator,
-            std::multimap<int, std::string>::const_iterator>
-      range = equalRange(hdKey);
+  auto range = equalRange(hdKey);
   for (auto i = range.first; i != range.second; ++i) {
     std::vector<Scip> values;
     util::splitIter((*i).second.begin(), (*i).second.end(),
@@ -208,32 +250,198 @@ bool HttpHeader::isKeepAlive() const
          (version_ == "HTTP/1.1" || util::strieq(connection, "keep-alive"));
 }
 
+namespace {
+bool isAuthTokenChar(char c)
+{
+  // Be lenient here: accept everything except delimiters so that
+  // token68 and sloppy servers are tolerated.
+  return c != ' ' && c != '\t' && c != ',' && c != '=' && c != '"';
+}
+} // namespace
+
+namespace {
+template <typename InputIterator>
+InputIterator skipWs(InputIterator first, InputIterator last)
+{
+  for (; first != last && (*first == ' ' || *first == '\t'); ++first)
+    ;
+  return first;
+}
+} // namespace
+
+namespace {
+template <typename InputIterator>
+InputIterator skipWsAndComma(InputIterator first, InputIterator last)
+{
+  for (; first != last && (*first == ' ' || *first == '\t' || *first == ',');
+       ++first)
+    ;
+  return first;
+}
+} // namespace
+
+namespace {
+template <typename InputIterator>
+InputIterator readToken(InputIterator first, InputIterator last)
+{
+  for (; first != last && isAuthTokenChar(*first); ++first)
+    ;
+  return first;
+}
+
+// Parses comma separated auth-param list in [first, last) and
+// appends them to params. Returns the position where the next
+// challenge starts, that is a token not followed by '=', or last.
+template <typename InputIterator>
+InputIterator
+parseAuthParamList(InputIterator first, InputIterator last,
+                   std::vector<std::pair<std::string, std::string>>& params)
+{
+  auto p = first;
+  for (;;) {
+    p = skipWsAndComma(p, last);
+    auto nameFirst = p;
+    auto nameLast = readToken(p, last);
+    auto eq = skipWs(nameLast, last);
+    if (nameFirst == nameLast) {
+      if (p == last) {
+        return p;
+      }
+      // Stray '=' or '"'. Skip to the next list element.
+      p = std::find(p + 1, last, ',');
+      continue;
+    }
+    if (eq == last || *eq != '=') {
+      // A token without '=' starts a new challenge.
+      return nameFirst;
+    }
+    auto v = eq + 1;
+    if (v != last && *v == '=') {
+      // token68, e.g., "Negotiate abc==".  We don't use it.
+      p = std::find(v, last, ',');
+      continue;
+    }
+    v = skipWs(v, last);
+    std::string val;
+    if (v != last && *v == '"') {
+      for (++v; v != last && *v != '"'; ++v) {
+        if (*v == '\\' && v + 1 != last) {
+          ++v;
+        }
+        val += *v;
+      }
+      if (v != last) {
+        ++v;
+      }
+    }
+    else {
+      auto valLast = readToken(v, last);
+      val.assign(v, valLast);
+      v = valLast;
+    }
+    params.emplace_back(util::toLower(std::string(nameFirst, nameLast)),
+                        std::move(val));
+    // Discard anything up to the next list element.
+    p = std::find(v, last, ',');
+  }
+}
+} // namespace
+
+std::vector<AuthChallenge> parseAuthChallenges(const std::string& value)
+{
+  std::vector<AuthChallenge> res;
+  auto last = std::end(value);
+  auto p = skipWsAndComma(std::begin(value), last);
+  while (p != last) {
+    auto schemeLast = readToken(p, last);
+    if (schemeLast == p) {
+      // Garbage where auth-scheme is expected. Skip to the next
+      // list element.
+      p = skipWsAndComma(std::find(p + 1, last, ','), last);
+      continue;
+    }
+    AuthChallenge challenge;
+    challenge.scheme.assign(p, schemeLast);
+    p = parseAuthParamList(schemeLast, last, challenge.params);
+    res.push_back(std::move(challenge));
+  }
+  return res;
+}
+
+std::vector<std::pair<std::string, std::string>>
+parseAuthParams(const std::string& value)
+{
+  std::vector<std::pair<std::string, std::string>> res;
+  parseAuthParamList(std::begin(value), std::end(value), res);
+  return res;
+}
+
 void HttpHeader::parseAuthChallenge(const std::string& authChallenge)
 {
-  auto p = util::divide(std::begin(authChallenge), std::end(authChallenge), ' ');
-  if (util::streq(p.first.first, p.first.second, "Basic")) {
-    authScheme_ = AUTH_BASIC;
-  } else if (util::streq(p.first.first, p.first.second, "Digest")) {
-    authScheme_ = AUTH_DIGEST;
-    std::vector<Scip> values;
-    util::splitIter(p.first.second, std::end(authChallenge),
-                    std::back_inserter(values), ',',
-                    true // doStrip
-    );
-    digestAuthParams_ = make_unique<DigestAuthParams>();
-    for (const auto& v : values) {
-      auto p = util::divide(v.first, v.second, '=', true);
-      auto stripped = util::strip(std::string(p.second.first, p.second.second), "\"");
-      if (util::streq(p.first.first, p.first.second, "nonce")) {
-        digestAuthParams_->serverNonce  = stripped;
-      } else if (util::streq(p.first.first, p.first.second, "qop")) {
-        digestAuthParams_->qop = stripped;
-      } else if (util::streq(p.first.first, p.first.second, "algorithm")) {
-        digestAuthParams_->algorithm = stripped;
-      }  else if (util::streq(p.first.first, p.first.second, "realm")) {
-        digestAuthParams_->realm = stripped;
+  for (auto& challenge : parseAuthChallenges(authChallenge)) {
+    if (util::strieq(challenge.scheme, "Basic")) {
+      // Prefer Digest if the server offers both.
+      if (authScheme_ != AUTH_DIGEST) {
+        authScheme_ = AUTH_BASIC;
       }
+      continue;
+    }
+    if (!util::strieq(challenge.scheme, "Digest")) {
+      continue;
     }
+    auto digestAuthParams = make_unique<DigestAuthParams>();
+    for (auto& param : challenge.params) {
+      const auto& name = param.first;
+      auto& value = param.second;
+      if (name == "nonce") {
+        digestAuthParams->serverNonce = std::move(value);
+      }
+      else if (name == "qop") {
+        // Prefer qop=auth. We only send requests without entity
+        // body, so auth-int gives no extra protection.
+        std::vector<std::string> qops;
+        util::split(std::begin(value), std::end(value),
+                    std::back_inserter(qops), ',', true);
+        if (std::find(std::begin(qops), std::end(qops), "auth") !=
+            std::end(qops)) {
+          digestAuthParams->qop = "auth";
+        }
+        else if (std::find(std::begin(qops), std::end(qops), "auth-int") !=
+                 std::end(qops)) {
+          digestAuthParams->qop = "auth-int";
+        }
+      }
+      else if (name == "algorithm") {
+        digestAuthParams->algorithm = std::move(value);
+      }
+      else if (name == "realm") {
+        digestAuthParams->realm = std::move(value);
+      }
+      else if (name == "opaque") {
+        digestAuthParams->opaque = std::move(value);
+      }
+      else if (name == "stale") {
+        digestAuthParams->stale = util::strieq(value, "true");
+      }
+      else if (name == "userhash") {
+        digestAuthParams->userhash = util::strieq(value, "true");
+      }
+      else if (name == "domain") {
+        util::split(std::begin(value), std::end(value),
+                    std::back_inserter(digestAuthParams->domain), ' ', true);
+      }
+    }
+    // The server may offer several Digest challenges with different
+    // algorithms. Pick the strongest one we support.
+    auto strength = getDigestAlgorithmStrength(digestAuthParams->algorithm);
+    if (strength == -1) {
+      continue;
+    }
+    if (!digestAuthParams_ ||
+        strength > getDigestAlgorithmStrength(digestAuthParams_->algorithm)) {
+      digestAuthParams_ = std::move(digestAuthParams);
+    }
+    authScheme_ = AUTH_DIGEST;
   }
 }
 
@@ -242,6 +450,7 @@ constexpr const char* INTERESTING_HEADER_NAMES[] = {
     "accept-encoding",
     "access-control-request-headers",
     "access-control-request-method",
+    "authentication-info",
     "authorization",
     "connection",
     "content-disposition",
@@ -256,6 +465,7 @@ constexpr const char* INTERESTING_HEADER_NAMES[] = {
     "location",
     "origin",
     "port",
+    "proxy-authenticate",
     "retry-after",
     "sec-websocket-key",
     "sec-websocket-version",
@@ -37,7 +37,6 @@
 
 #include "common.h"
 
-#include <map>
 #include <vector>
 #include <string>
 
@@ -48,9 +47,14 @@ namespace aria2 {
 struct Range;
 
 class HttpHeader {
-private:
+public:
+  typedef std::vector<std::pair<int, std::string>> FieldTable;
 
-  std::multimap<int, std::string> table_;
+private:
+  // Header fields sorted by key.  Fields with the same key are kept
+  // in the order of appearance.  This is a flat array rather than
+  // std::multimap so that storing a field costs no node allocation.
+  FieldTable table_;
 
   // HTTP status code, e.g. 200
   int statusCode_;
@@ -84,6 +88,7 @@ public:
     ACCEPT_ENCODING,
     ACCESS_CONTROL_REQUEST_HEADERS,
     ACCESS_CONTROL_REQUEST_METHOD,
+    AUTHENTICATION_INFO,
     AUTHORIZATION,
     CONNECTION,
     CONTENT_DISPOSITION,
@@ -98,6 +103,7 @@ public:
     LOCATION,
     ORIGIN,
     PORT, // Used for BitTorrent LPD
+    PROXY_AUTHENTICATE,
     RETRY_AFTER,
     SEC_WEBSOCKET_KEY,
     SEC_WEBSOCKET_VERSION,
@@ -109,11 +115,11 @@ public:
   };
 
   // For all methods, use lowercased header field name.
-  void put(int hdKey, const std::string& value);
+  void put(int hdKey, std::string value);
   bool defined(int hdKey) const;
   const std::string& find(int hdKey) const;
-  std::pair<std::multimap<int, std::string>::const_iterator,
-            std::multimap<int, std::string>::const_iterator>
+  std::vector<std::string> findAll(int hdKey) const;
+  std::pair<FieldTable::const_iterator, FieldTable::const_iterator>
   equalRange(int hdKey) const;
 
   void remove(int hdKey);
@@ -179,10 +185,36 @@ public:
     return std::move(digestAuthParams_);
   }
 
+  // Returns true if Digest challenge has stale=true.  This must be
+  // called before getDigestAuthParams().
+  bool isDigestStale() const
+  {
+    return digestAuthParams_ && digestAuthParams_->stale;
+  }
+
 };
 
 int idInterestingHeader(const char* hdName);
 
+struct AuthChallenge {
+  // auth-scheme, e.g., "Digest"
+  std::string scheme;
+  // auth-param names and unquoted values in the order of appearance.
+  // Names are lowercased.
+  std::vector<std::pair<std::string, std::string>> params;
+};
+
+// Parses the value of WWW-Authenticate header field, which may
+// contain several comma separated challenges (RFC 7235, section 4.1).
+// quoted-string values are unescaped. Malformed parts are skipped
+// rather than rejecting the whole value.
+std::vector<AuthChallenge> parseAuthChallenges(const std::string& value);
+
+// Parses auth-param list without auth-scheme, such as the value of
+// Authentication-Info header field (RFC 7615). Names are lowercased.
+std::vector<std::pair<std::string, std::string>>
+parseAuthParams(const std::string& value);
+
 } // namespace aria2
 
 #endif // D_HTTP_HEADER_H
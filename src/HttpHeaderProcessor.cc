@@ -338,10 +338,11 @@ bool HttpHeaderProcessor::parse(const unsigned char* data, size_t length)
       if (!lastFieldName_.empty()) {
         if (lastFieldHdKey_ != HttpHeader::MAX_INTERESTING_HEADER) {
           auto stripped = util::strip(buf_);
-          if (lastFieldHdKey_ == HttpHeader::WWW_AUTHORIZATION_CHALLENGE) {
+          if (lastFieldHdKey_ == HttpHeader::WWW_AUTHORIZATION_CHALLENGE ||
+              lastFieldHdKey_ == HttpHeader::PROXY_AUTHENTICATE) {
             result_->parseAuthChallenge(stripped);
           }
-          result_->put(lastFieldHdKey_, stripped);
+          result_->put(lastFieldHdKey_, std::move(stripped));
         }
         lastFieldName_.clear();
         lastFieldHdKey_ = HttpHeader::MAX_INTERESTING_HEADER;
@@ -51,7 +51,7 @@
 #include "util.h"
 #include "fmt.h"
 #include "SocketRecvBuffer.h"
-#include "BackupIPv4ConnectCommand.h"
+#include "BackupConnectCommand.h"
 #include "ConnectCommand.h"
 #include "HttpRequestConnectChain.h"
 #include "HttpProxyRequestConnectChain.h"
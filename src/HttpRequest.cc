@@ -43,7 +43,6 @@
 #include "CookieStorage.h"
 #include "Option.h"
 #include "util.h"
-#include "base64.h"
 #include "prefs.h"
 #include "AuthConfigFactory.h"
 #include "AuthConfig.h"
@@ -53,6 +52,7 @@
 #include "Request.h"
 #include "DownloadHandlerConstants.h"
 #include "MessageDigest.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -68,7 +68,8 @@ HttpRequest::HttpRequest()
       acceptMetalink_(false),
       noCache_(true),
       acceptGzip_(false),
-      noWantDigest_(false)
+      noWantDigest_(false),
+      pipelined_(false)
 {
 }
 
@@ -143,27 +144,27 @@ std::string getHostText(const std::string& host, uint16_t port)
 
 std::string HttpRequest::createRequest()
 {
+  requestTime_ = global::wallclock();
   authConfig_ = authConfigFactory_->createAuthConfig(request_, option_);
-  auto requestLine = request_->getMethod();
-  requestLine += ' ';
+  std::string requestTarget;
   if (proxyRequest_) {
+    requestTarget = getCurrentURI();
     if (getProtocol() == "ftp" && request_->getUsername().empty() &&
         authConfig_) {
       // Insert user into URI, like ftp://USER@host/
-      auto uri = getCurrentURI();
-      assert(uri.size() >= 6);
-      uri.insert(6, util::percentEncode(authConfig_->getUser()) + '@');
-      requestLine += uri;
-    }
-    else {
-      requestLine += getCurrentURI();
+      assert(requestTarget.size() >= 6);
+      requestTarget.insert(6,
+                           util::percentEncode(authConfig_->getUser()) + '@');
     }
   }
   else {
-    requestLine += getDir();
-    requestLine += getFile();
-    requestLine += getQuery();
+    requestTarget = getDir();
+    requestTarget += getFile();
+    requestTarget += getQuery();
   }
+  auto requestLine = request_->getMethod();
+  requestLine += ' ';
+  requestLine += requestTarget;
   requestLine += " HTTP/1.1\r\n";
 
   std::vector<std::pair<std::string, std::string>> builtinHds;
@@ -218,8 +219,10 @@ std::string HttpRequest::createRequest()
       builtinHds.emplace_back("Connection:", "Keep-Alive");
     }
   }
+  proxyAuthConfig_.reset();
   if (proxyRequest_ && !proxyRequest_->getUsername().empty()) {
-    builtinHds.push_back(getProxyAuthString());
+    builtinHds.push_back(
+        getProxyAuthString(request_->getMethod(), requestTarget));
   }
   if (authConfig_) {
     auto authText = authConfig_->getAuthText();
@@ -284,24 +287,26 @@ std::string HttpRequest::createRequest()
   return requestLine;
 }
 
-std::string HttpRequest::createProxyRequest() const
+std::string HttpRequest::createProxyRequest()
 {
   assert(proxyRequest_);
 
+  requestTime_ = global::wallclock();
+  auto authority = getURIHost();
+  authority += ':';
+  authority += util::uitos(getPort());
+
   std::string requestLine = "CONNECT ";
-  requestLine += getURIHost();
-  requestLine += ':';
-  requestLine += util::uitos(getPort());
+  requestLine += authority;
   requestLine += " HTTP/1.1\r\nUser-Agent: ";
   requestLine += userAgent_;
   requestLine += "\r\nHost: ";
-  requestLine += getURIHost();
-  requestLine += ':';
-  requestLine += util::uitos(getPort());
+  requestLine += authority;
   requestLine += "\r\n";
 
+  proxyAuthConfig_.reset();
   if (!proxyRequest_->getUsername().empty()) {
-    auto auth = getProxyAuthString();
+    auto auth = getProxyAuthString("CONNECT", authority);
     requestLine += auth.first;
     requestLine += ' ';
     requestLine += auth.second;
@@ -313,14 +318,20 @@ std::string HttpRequest::createProxyRequest() const
   return requestLine;
 }
 
-std::pair<std::string, std::string> HttpRequest::getProxyAuthString() const
+std::pair<std::string, std::string>
+HttpRequest::getProxyAuthString(const std::string& method,
+                                const std::string& uri)
 {
-  auto authText = proxyRequest_->getUsername();
-  authText += ':';
-  authText += proxyRequest_->getPassword();
-  std::string val = "Basic ";
-  val += base64::encode(std::begin(authText), std::end(authText));
-  return std::make_pair("Proxy-Authorization:", val);
+  if (authConfigFactory_) {
+    proxyAuthConfig_ =
+        authConfigFactory_->createProxyAuthConfig(proxyRequest_, method, uri);
+  }
+  else {
+    proxyAuthConfig_ = AuthConfig::create(proxyRequest_->getUsername(),
+                                          proxyRequest_->getPassword());
+  }
+  return std::make_pair("Proxy-Authorization:",
+                        proxyAuthConfig_->getAuthText());
 }
 
 void HttpRequest::enableContentEncoding() { contentEncodingEnabled_ = true; }
@@ -356,6 +367,11 @@ void HttpRequest::setProxyRequest(std::shared_ptr<Request> proxyRequest)
 
 bool HttpRequest::isProxyRequestSet() const { return proxyRequest_.get(); }
 
+const std::unique_ptr<AuthConfig>& HttpRequest::getProxyAuthConfig() const
+{
+  return proxyAuthConfig_;
+}
+
 bool HttpRequest::authenticationUsed() const { return authConfig_.get(); }
 
 const std::unique_ptr<AuthConfig>& HttpRequest::getAuthConfig() const
@@ -43,6 +43,7 @@
 #include <memory>
 
 #include "FileEntry.h"
+#include "TimerA2.h"
 
 namespace aria2 {
 
@@ -101,7 +102,22 @@ private:
   // Don't send Want-Digest header field
   bool noWantDigest_;
 
-  std::pair<std::string, std::string> getProxyAuthString() const;
+  // The time when the last request was created, which is almost the
+  // time when it was sent.
+  Timer requestTime_;
+
+  // true if the request was sent while responses to earlier requests
+  // on the same connection were outstanding.
+  bool pipelined_;
+
+  // AuthConfig used in Proxy-Authorization in the last invocation of
+  // createRequest() or createProxyRequest().
+  std::unique_ptr<AuthConfig> proxyAuthConfig_;
+
+  // Returns Proxy-Authorization header field for method and uri, the
+  // request-target sent to the proxy.
+  std::pair<std::string, std::string>
+  getProxyAuthString(const std::string& method, const std::string& uri);
 
 public:
   HttpRequest();
@@ -160,7 +176,7 @@ public:
    * Returns string representation of http tunnel request.
    * It usually starts with "CONNECT ..." and ends with "\r\n".
    */
-  std::string createProxyRequest() const;
+  std::string createProxyRequest();
 
   void enableContentEncoding();
 
@@ -182,6 +198,12 @@ public:
   CookieStorage* getCookieStorage() const;
 
   void setAuthConfigFactory(AuthConfigFactory* factory);
+
+  AuthConfigFactory* getAuthConfigFactory() const
+  {
+    return authConfigFactory_;
+  }
+
   void setOption(const Option* option);
 
   /*
@@ -196,6 +218,26 @@ public:
    */
   bool isProxyRequestSet() const;
 
+  const std::shared_ptr<Request>& getProxyRequest() const
+  {
+    return proxyRequest_;
+  }
+
+  // Returns AuthConfig used in Proxy-Authorization in the last
+  // invocation of createRequest() or createProxyRequest().
+  const std::unique_ptr<AuthConfig>& getProxyAuthConfig() const;
+
+  // Returns the time when createRequest() or createProxyRequest() was
+  // last invoked.
+  const Timer& getRequestTime() const { return requestTime_; }
+
+  void setPipelined(bool f) { pipelined_ = f; }
+
+  // Returns true if the server may have started on this request only
+  // after answering earlier ones, so getRequestTime() does not tell
+  // when it started.
+  bool isPipelined() const { return pipelined_; }
+
   // Returns true if authentication was used in the last
   // createRequest().
   bool authenticationUsed() const;
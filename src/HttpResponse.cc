@@ -60,6 +60,7 @@
 #include "base64.h"
 #include "array_fun.h"
 #include "MessageDigest.h"
+#include "wallclock.h"
 #ifdef HAVE_ZLIB
 #  include "GZipDecodingStreamFilter.h"
 #endif // HAVE_ZLIB
@@ -142,6 +143,111 @@ void HttpResponse::retrieveCookie()
   }
 }
 
+void HttpResponse::processAuthenticationInfo()
+{
+  const auto& authConfig = httpRequest_->getAuthConfig();
+  if (!authConfig || authConfig->getAuthScheme() != AUTH_DIGEST ||
+      !httpRequest_->getAuthConfigFactory()) {
+    return;
+  }
+  const auto& authInfo = httpHeader_->find(HttpHeader::AUTHENTICATION_INFO);
+  if (authInfo.empty()) {
+    return;
+  }
+  if (!httpRequest_->getAuthConfigFactory()->updateDigestAuthInfo(
+          httpRequest_->getRequest(), *authConfig, authInfo)) {
+    throw DL_ABORT_EX2(EX_AUTH_FAILED, error_code::HTTP_AUTH_FAILED);
+  }
+}
+
+bool HttpResponse::processAuthChallenge(const Option* option)
+{
+  if (!httpRequest_->getAuthConfigFactory() ||
+      httpHeader_->getAuthScheme() != AUTH_DIGEST) {
+    return false;
+  }
+  auto digestAuthParams = httpHeader_->getDigestAuthParams();
+  const auto& authConfig = httpRequest_->getAuthConfig();
+  // If we answered with the nonce received in this very challenge
+  // round, the credentials were rejected.  Retry only if we sent
+  // Basic, reused a cached nonce or a nextnonce, or the server told us
+  // that the nonce was stale.
+  if (authConfig && authConfig->getAuthScheme() == AUTH_DIGEST &&
+      !authConfig->isPreemptive() && !digestAuthParams->stale) {
+    return false;
+  }
+  const auto& request = httpRequest_->getRequest();
+  if (!httpRequest_->getAuthConfigFactory()->activateAuthCred(
+          request->getHost(), request->getPort(), request->getDir(), option,
+          std::move(digestAuthParams))) {
+    return false;
+  }
+  A2_LOG_INFO(fmt("CUID#%" PRId64 " - Retrying with Digest"
+                  " authentication.",
+                  cuid_));
+  return true;
+}
+
+bool HttpResponse::processProxyAuthChallenge()
+{
+  if (!httpRequest_->isProxyRequestSet() ||
+      !httpRequest_->getAuthConfigFactory() ||
+      httpHeader_->getAuthScheme() != AUTH_DIGEST) {
+    return false;
+  }
+  auto digestAuthParams = httpHeader_->getDigestAuthParams();
+  const auto& authConfig = httpRequest_->getProxyAuthConfig();
+  // Like 401, answering the fresh challenge once is enough to tell
+  // that the credentials were rejected unless the nonce is stale.
+  if (authConfig && authConfig->getAuthScheme() == AUTH_DIGEST &&
+      !authConfig->isPreemptive() && !digestAuthParams->stale) {
+    return false;
+  }
+  if (!httpRequest_->getAuthConfigFactory()->activateProxyAuthCred(
+          httpRequest_->getProxyRequest(), std::move(digestAuthParams))) {
+    return false;
+  }
+  A2_LOG_INFO(fmt("CUID#%" PRId64 " - Retrying with Digest proxy"
+                  " authentication.",
+                  cuid_));
+  return true;
+}
+
+AuthStat HttpResponse::createAuthStat() const
+{
+  AuthStat stat;
+  auto statusCode = getStatusCode();
+  if (statusCode == 401 || statusCode == 407) {
+    ++stat.challenges;
+    if (httpHeader_->isDigestStale()) {
+      ++stat.staleNonceRetries;
+    }
+    stat.retryTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         httpRequest_->getRequestTime().difference(
+                             global::wallclock()))
+                         .count();
+  }
+  const auto& authConfig = httpRequest_->getAuthConfig();
+  if (authConfig && authConfig->isPreemptive()) {
+    if (statusCode == 401) {
+      ++stat.preemptiveMisses;
+    }
+    else {
+      ++stat.preemptiveHits;
+    }
+  }
+  const auto& proxyAuthConfig = httpRequest_->getProxyAuthConfig();
+  if (proxyAuthConfig && proxyAuthConfig->isPreemptive()) {
+    if (statusCode == 407) {
+      ++stat.preemptiveMisses;
+    }
+    else {
+      ++stat.preemptiveHits;
+    }
+  }
+  return stat;
+}
+
 bool HttpResponse::isRedirect() const
 {
   switch (getStatusCode()) {
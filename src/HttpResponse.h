@@ -43,6 +43,7 @@
 
 #include "TimeA2.h"
 #include "Command.h"
+#include "AuthStat.h"
 
 namespace aria2 {
 
@@ -74,6 +75,32 @@ public:
 
   void retrieveCookie();
 
+  // Processes Authentication-Info header field if the request was
+  // authenticated with Digest, so that the next request uses the
+  // nonce given in nextnonce. Throws DlAbortEx if rspauth does not
+  // match.
+  void processAuthenticationInfo();
+
+  // Processes Digest challenge in WWW-Authenticate header field of 401
+  // response. Returns true if the challenge was cached and the request
+  // should be retried with Digest Authorization.  Returns false if the
+  // server did not offer Digest, or it rejected the Digest
+  // credentials we have just created for its challenge.
+  bool processAuthChallenge(const Option* option);
+
+  // Processes Digest challenge in Proxy-Authenticate header field of
+  // 407 response. Returns true if the challenge was cached and the
+  // request should be retried with Digest Proxy-Authorization.
+  // Returns false if the proxy did not offer Digest, or it rejected
+  // the Digest credentials we have just created for its challenge.
+  bool processProxyAuthChallenge();
+
+  // Returns authentication counters for this response: challenge
+  // received, whether preemptive authorization sent in the request
+  // was accepted, and the time lost to the challenge round trip.
+  // This must be called before the challenge is processed.
+  AuthStat createAuthStat() const;
+
   /**
    * Returns true if the response header indicates redirection.
    */
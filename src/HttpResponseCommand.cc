@@ -39,6 +39,8 @@
 #include "FileEntry.h"
 #include "RequestGroup.h"
 #include "RequestGroupMan.h"
+#include "ServerStat.h"
+#include "wallclock.h"
 #include "Request.h"
 #include "HttpRequest.h"
 #include "HttpResponse.h"
@@ -155,7 +157,26 @@ bool HttpResponseCommand::executeInternal()
 
   // check HTTP status code
   httpResponse->validateResponse();
+  // Error responses say nothing about the latency of successful
+  // ones.  The request time of a pipelined request includes the
+  // transfer of the responses before it.
+  if (httpResponse->getStatusCode() < 400 &&
+      !httpResponse->getHttpRequest()->isPipelined()) {
+    getDownloadEngine()
+        ->getRequestGroupMan()
+        ->getOrCreateServerStat(getRequest()->getHost(),
+                                getRequest()->getProtocol())
+        ->addTTFB(std::chrono::duration_cast<std::chrono::milliseconds>(
+            httpResponse->getHttpRequest()->getRequestTime().difference(
+                global::wallclock())));
+  }
   httpResponse->retrieveCookie();
+  httpResponse->processAuthenticationInfo();
+  {
+    auto authStat = httpResponse->createAuthStat();
+    getRequestGroup()->getAuthStat() += authStat;
+    getDownloadEngine()->getRequestGroupMan()->getAuthStat() += authStat;
+  }
 
   const auto& httpHeader = httpResponse->getHttpHeader();
   // Disable persistent connection if:
@@ -60,6 +60,8 @@
 #include "SinkStreamFilter.h"
 #include "error_code.h"
 #include "SocketRecvBuffer.h"
+#include "RequestGroup.h"
+#include "ConnectionScaler.h"
 
 namespace aria2 {
 
@@ -204,25 +206,25 @@ bool HttpSkipResponseCommand::processResponse()
   auto statusCode = httpResponse_->getStatusCode();
   if (statusCode >= 400) {
     switch (statusCode) {
-    case 401:
-      if (getOption()->getAsBool(PREF_HTTP_AUTH_CHALLENGE) &&
-          !httpResponse_->getHttpRequest()->authenticationUsed() &&
-          getDownloadEngine()->getAuthConfigFactory()->activateAuthCred(
-              getRequest()->getHost(), getRequest()->getPort(),
-              getRequest()->getDir(), getOption().get())) {
-        return prepareForRetry(0);
-      } else if (respopnseHeader->getAuthScheme() == AUTH_DIGEST) {
-        A2_LOG_DEBUG("401 digest auth path = " + getRequest()->getDir() + getRequest()->getFile());
-        if (httpResponse_->getHttpRequest()->authenticationUsed()) {
-          A2_LOG_DEBUG("authenticationUsed = yes");
-        }
-        if (getDownloadEngine()->getAuthConfigFactory()->activateAuthCred(
-              getRequest()->getHost(), getRequest()->getPort(),
-              getRequest()->getDir(), getOption().get(),
-              std::move(respopnseHeader->getDigestAuthParams()))) {
+    case 401: {
+      if (respopnseHeader->getAuthScheme() == AUTH_DIGEST) {
+        if (httpResponse_->processAuthChallenge(getOption().get())) {
           return prepareForRetry(0);
         }
       }
+      else if (getOption()->getAsBool(PREF_HTTP_AUTH_CHALLENGE) &&
+               !httpResponse_->getHttpRequest()->authenticationUsed() &&
+               getDownloadEngine()->getAuthConfigFactory()->activateAuthCred(
+                   getRequest()->getHost(), getRequest()->getPort(),
+                   getRequest()->getDir(), getOption().get())) {
+        return prepareForRetry(0);
+      }
+      throw DL_ABORT_EX2(EX_AUTH_FAILED, error_code::HTTP_AUTH_FAILED);
+    }
+    case 407:
+      if (httpResponse_->processProxyAuthChallenge()) {
+        return prepareForRetry(0);
+      }
       throw DL_ABORT_EX2(EX_AUTH_FAILED, error_code::HTTP_AUTH_FAILED);
     case 404:
       if (getOption()->getAsInt(PREF_MAX_FILE_NOT_FOUND) == 0) {
@@ -231,8 +233,12 @@ bool HttpSkipResponseCommand::processResponse()
       }
       throw DL_RETRY_EX2(MSG_RESOURCE_NOT_FOUND,
                          error_code::RESOURCE_NOT_FOUND);
+    case 429:
     case 502:
     case 503:
+      if (statusCode != 502 && getRequestGroup()->getConnectionScaler()) {
+        getRequestGroup()->getConnectionScaler()->onServerBusy();
+      }
       // Only retry if pretry-wait > 0. Hammering 'busy' server is not
       // a good idea.
       if (getOption()->getAsInt(PREF_RETRY_WAIT) > 0) {
@@ -33,6 +33,9 @@
  */
 /* copyright --> */
 #include "InitiateConnectionCommand.h"
+
+#include <deque>
+
 #include "Request.h"
 #include "DownloadEngine.h"
 #include "Option.h"
@@ -51,7 +54,7 @@
 #include "RecoverableException.h"
 #include "fmt.h"
 #include "SocketRecvBuffer.h"
-#include "BackupIPv4ConnectCommand.h"
+#include "BackupConnectCommand.h"
 #include "ConnectCommand.h"
 
 namespace aria2 {
@@ -128,37 +131,74 @@ void InitiateConnectionCommand::setConnectedAddrInfo(
   req->setConnectedAddrInfo(hostname, endpoint.addr, endpoint.port);
 }
 
+namespace {
+// RFC 8305 section 5 recommends 250ms as Connection Attempt Delay.
+constexpr auto CONNECTION_ATTEMPT_DELAY = std::chrono::milliseconds(250);
+// The maximum number of backup connection attempts raced against
+// mainCommand.
+constexpr size_t MAX_BACKUP_CONNECTIONS = 4;
+
+bool isIPv6Addr(const std::string& addr)
+{
+  char buf[sizeof(in6_addr)];
+  return inetPton(AF_INET6, addr.c_str(), &buf) == 0;
+}
+} // namespace
+
 std::shared_ptr<BackupConnectInfo>
-InitiateConnectionCommand::createBackupIPv4ConnectCommand(
+InitiateConnectionCommand::createBackupConnectCommands(
     const std::string& hostname, const std::string& ipaddr, uint16_t port,
     Command* mainCommand)
 {
-  // Prepare IPv4 backup connection attempt in "Happy Eyeballs"
-  // fashion.
+  // Prepare backup connection attempts in "Happy Eyeballs Version 2"
+  // fashion.  The addresses other than |ipaddr| are tried in the
+  // order of preference kept by DNSCache, interleaving address
+  // families and starting with the family other than the one of
+  // |ipaddr| (RFC 8305 section 4).
   std::shared_ptr<BackupConnectInfo> info;
-  char buf[sizeof(in6_addr)];
-  if (inetPton(AF_INET6, ipaddr.c_str(), &buf) == -1) {
-    return info;
-  }
-  A2_LOG_INFO("Searching IPv4 address for backup connection attempt");
   std::vector<std::string> addrs;
   getDownloadEngine()->findAllCachedIPAddresses(std::back_inserter(addrs),
                                                 hostname, port);
-  for (std::vector<std::string>::const_iterator i = addrs.begin(),
-                                                eoi = addrs.end();
-       i != eoi; ++i) {
-    if (inetPton(AF_INET, (*i).c_str(), &buf) == 0) {
-      info = std::make_shared<BackupConnectInfo>();
-      auto command = make_unique<BackupIPv4ConnectCommand>(
-          getDownloadEngine()->newCUID(), *i, port, info, mainCommand,
-          getRequestGroup(), getDownloadEngine());
-      A2_LOG_INFO(fmt("Issue backup connection command CUID#%" PRId64
-                      ", addr=%s",
-                      command->getCuid(), (*i).c_str()));
-      getDownloadEngine()->addCommand(std::move(command));
-      return info;
+  std::deque<std::string> v4addrs, v6addrs;
+  for (auto& addr : addrs) {
+    if (addr == ipaddr) {
+      continue;
+    }
+    if (isIPv6Addr(addr)) {
+      v6addrs.push_back(addr);
+    }
+    else {
+      v4addrs.push_back(addr);
     }
   }
+  auto first = &v6addrs;
+  auto second = &v4addrs;
+  if (isIPv6Addr(ipaddr)) {
+    std::swap(first, second);
+  }
+  std::vector<std::string> backupAddrs;
+  while (backupAddrs.size() < MAX_BACKUP_CONNECTIONS &&
+         (!first->empty() || !second->empty())) {
+    if (!first->empty()) {
+      backupAddrs.push_back(first->front());
+      first->pop_front();
+    }
+    std::swap(first, second);
+  }
+  if (backupAddrs.empty()) {
+    return info;
+  }
+  info = std::make_shared<BackupConnectInfo>();
+  for (size_t i = 0; i < backupAddrs.size(); ++i) {
+    auto command = make_unique<BackupConnectCommand>(
+        getDownloadEngine()->newCUID(), hostname, backupAddrs[i], port,
+        CONNECTION_ATTEMPT_DELAY * (i + 1), info, mainCommand,
+        getRequestGroup(), getDownloadEngine());
+    A2_LOG_INFO(fmt("Issue backup connection command CUID#%" PRId64
+                    ", addr=%s",
+                    command->getCuid(), backupAddrs[i].c_str()));
+    getDownloadEngine()->addCommand(std::move(command));
+  }
   return info;
 }
 
@@ -167,7 +207,7 @@ void InitiateConnectionCommand::setupBackupConnection(
     ConnectCommand* c)
 {
   std::shared_ptr<BackupConnectInfo> backupConnectInfo =
-      createBackupIPv4ConnectCommand(hostname, addr, port, c);
+      createBackupConnectCommands(hostname, addr, port, c);
   if (backupConnectInfo) {
     c->setBackupConnectInfo(backupConnectInfo);
   }
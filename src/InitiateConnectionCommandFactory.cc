@@ -63,7 +63,8 @@ InitiateConnectionCommandFactory::createInitiateConnectionCommand(
     if (requestGroup->getOption()->getAsBool(PREF_ENABLE_HTTP_KEEP_ALIVE)) {
       req->setKeepAliveHint(true);
     }
-    if (requestGroup->getOption()->getAsBool(PREF_ENABLE_HTTP_PIPELINING)) {
+    if (requestGroup->getOption()->getAsBool(PREF_ENABLE_HTTP_PIPELINING) &&
+        !req->isPipeliningDisabled()) {
       req->setPipeliningHint(true);
     }
 
@@ -34,7 +34,7 @@
 /* copyright --> */
 #include "IteratableChunkChecksumValidator.h"
 
-#include <array>
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 
@@ -51,9 +51,21 @@
 #include "MessageDigest.h"
 #include "fmt.h"
 #include "DlAbortEx.h"
+#include "HashWorkerPool.h"
+#include "Command.h"
 
 namespace aria2 {
 
+namespace {
+// Large reads let the kernel read ahead the following data while the
+// current piece is hashed.
+constexpr size_t READ_BUFFER_LENGTH = 256_k;
+// The maximum number of bytes read in one validateChunk() call when
+// pieces are hashed in HashWorkerPool, so that the other downloads
+// are not starved.
+constexpr int64_t MAX_READ_LENGTH_PER_CALL = 16_m;
+} // namespace
+
 IteratableChunkChecksumValidator::IteratableChunkChecksumValidator(
     const std::shared_ptr<DownloadContext>& dctx,
     const std::shared_ptr<PieceStorage>& pieceStorage)
@@ -61,84 +73,173 @@ IteratableChunkChecksumValidator::IteratableChunkChecksumValidator(
       pieceStorage_(pieceStorage),
       bitfield_(make_unique<BitfieldMan>(dctx_->getPieceLength(),
                                          dctx_->getTotalLength())),
-      currentIndex_(0)
+      currentIndex_(0),
+      numPending_(0),
+      verifiedLength_(0),
+      waiter_(nullptr)
 {
 }
 
-IteratableChunkChecksumValidator::~IteratableChunkChecksumValidator() = default;
+IteratableChunkChecksumValidator::~IteratableChunkChecksumValidator()
+{
+  auto pool = HashWorkerPool::getInstance();
+  if (numPending_ > 0 && pool) {
+    pool->cancel(this);
+  }
+}
 
 void IteratableChunkChecksumValidator::validateChunk()
 {
-  if (!finished()) {
-    std::string actualChecksum;
+  if (finished()) {
+    return;
+  }
+  if (HashWorkerPool::getInstance()) {
+    submitChunks();
+  }
+  else {
+    validateChunkSync();
+  }
+}
+
+void IteratableChunkChecksumValidator::validateChunkSync()
+{
+  size_t index = currentIndex_++;
+  std::string actualChecksum;
+  try {
+    actualChecksum = digest(static_cast<int64_t>(index) *
+                                dctx_->getPieceLength(),
+                            getChunkLength(index));
+  }
+  catch (RecoverableException& ex) {
+    onReadError(index, ex);
+    return;
+  }
+  checkChunk(index, actualChecksum);
+}
+
+void IteratableChunkChecksumValidator::submitChunks()
+{
+  auto pool = HashWorkerPool::getInstance();
+  int64_t readLength = 0;
+  while (currentIndex_ < dctx_->getNumPieces() &&
+         readLength < MAX_READ_LENGTH_PER_CALL) {
+    size_t index = currentIndex_;
+    size_t length = getChunkLength(index);
+    if (!pool->hasRoom(length)) {
+      break;
+    }
+    ++currentIndex_;
+    readLength += length;
+    std::vector<unsigned char> data(length);
     try {
-      actualChecksum = calculateActualChecksum();
-      if (actualChecksum == dctx_->getPieceHashes()[currentIndex_]) {
-        bitfield_->setBit(currentIndex_);
-      }
-      else {
-        A2_LOG_INFO(
-            fmt(EX_INVALID_CHUNK_CHECKSUM,
-                static_cast<unsigned long>(currentIndex_),
-                static_cast<int64_t>(getCurrentOffset()),
-                util::toHex(dctx_->getPieceHashes()[currentIndex_]).c_str(),
-                util::toHex(actualChecksum).c_str()));
-        bitfield_->unsetBit(currentIndex_);
-      }
+      readChunk(data.data(), static_cast<int64_t>(index) *
+                                 dctx_->getPieceLength(),
+                length);
     }
     catch (RecoverableException& ex) {
-      A2_LOG_DEBUG_EX(fmt("Caught exception while validating piece index=%lu."
-                          " Some part of file may be missing."
-                          " Continue operation.",
-                          static_cast<unsigned long>(currentIndex_)),
-                      ex);
-      bitfield_->unsetBit(currentIndex_);
+      onReadError(index, ex);
+      continue;
     }
+    ++numPending_;
+    pool->submit(this, dctx_->getPieceHashType(), std::move(data),
+                 [this, index](const std::string& actualChecksum) {
+                   --numPending_;
+                   checkChunk(index, actualChecksum);
+                   if (waiter_) {
+                     waiter_->setStatusActive();
+                   }
+                 });
+  }
+}
 
-    ++currentIndex_;
-    if (finished()) {
-      pieceStorage_->setBitfield(bitfield_->getBitfield(),
-                                 bitfield_->getBitfieldLength());
-    }
+void IteratableChunkChecksumValidator::checkChunk(
+    size_t index, const std::string& actualChecksum)
+{
+  if (actualChecksum == dctx_->getPieceHashes()[index]) {
+    bitfield_->setBit(index);
+  }
+  else {
+    A2_LOG_INFO(fmt(EX_INVALID_CHUNK_CHECKSUM, static_cast<unsigned long>(index),
+                    static_cast<int64_t>(index) * dctx_->getPieceLength(),
+                    util::toHex(dctx_->getPieceHashes()[index]).c_str(),
+                    util::toHex(actualChecksum).c_str()));
+    bitfield_->unsetBit(index);
   }
+  onChunkChecked(getChunkLength(index));
 }
 
-std::string IteratableChunkChecksumValidator::calculateActualChecksum()
+void IteratableChunkChecksumValidator::onReadError(
+    size_t index, const RecoverableException& ex)
+{
+  A2_LOG_DEBUG_EX(fmt("Caught exception while validating piece index=%lu."
+                      " Some part of file may be missing."
+                      " Continue operation.",
+                      static_cast<unsigned long>(index)),
+                  ex);
+  bitfield_->unsetBit(index);
+  onChunkChecked(getChunkLength(index));
+}
+
+void IteratableChunkChecksumValidator::onChunkChecked(size_t length)
+{
+  verifiedLength_ += length;
+  if (finished()) {
+    pieceStorage_->setBitfield(bitfield_->getBitfield(),
+                               bitfield_->getBitfieldLength());
+  }
+}
+
+size_t IteratableChunkChecksumValidator::getChunkLength(size_t index) const
 {
-  int64_t offset = getCurrentOffset();
-  size_t length;
   // When validating last piece
-  if (currentIndex_ + 1 == dctx_->getNumPieces()) {
-    length = dctx_->getTotalLength() - offset;
+  if (index + 1 == dctx_->getNumPieces()) {
+    return dctx_->getTotalLength() -
+           static_cast<int64_t>(index) * dctx_->getPieceLength();
   }
   else {
-    length = dctx_->getPieceLength();
+    return dctx_->getPieceLength();
   }
-  return digest(offset, length);
 }
 
 void IteratableChunkChecksumValidator::init()
 {
+  auto pool = HashWorkerPool::getInstance();
+  if (numPending_ > 0 && pool) {
+    pool->cancel(this);
+  }
+  numPending_ = 0;
   ctx_ = MessageDigest::create(dctx_->getPieceHashType());
   bitfield_->clearAllBit();
   currentIndex_ = 0;
+  verifiedLength_ = 0;
 }
 
-std::string IteratableChunkChecksumValidator::digest(int64_t offset,
-                                                     size_t length)
+void IteratableChunkChecksumValidator::readChunk(unsigned char* data,
+                                                 int64_t offset, size_t length)
 {
-  std::array<unsigned char, 4_k> buf;
-  ctx_->reset();
   int64_t max = offset + length;
   while (offset < max) {
     size_t r = pieceStorage_->getDiskAdaptor()->readDataDropCache(
-        buf.data(), std::min(static_cast<int64_t>(buf.size()), max - offset),
-        offset);
+        data, max - offset, offset);
     if (r == 0) {
       throw DL_ABORT_EX(
           fmt(EX_FILE_READ, dctx_->getBasePath().c_str(), "data is too short"));
     }
-    ctx_->update(buf.data(), r);
+    data += r;
+    offset += r;
+  }
+}
+
+std::string IteratableChunkChecksumValidator::digest(int64_t offset,
+                                                     size_t length)
+{
+  buf_.resize(READ_BUFFER_LENGTH);
+  ctx_->reset();
+  int64_t max = offset + length;
+  while (offset < max) {
+    size_t r = std::min(static_cast<int64_t>(buf_.size()), max - offset);
+    readChunk(buf_.data(), offset, r);
+    ctx_->update(buf_.data(), r);
     offset += r;
   }
   return ctx_->digest();
@@ -146,17 +247,29 @@ std::string IteratableChunkChecksumValidator::digest(int64_t offset,
 
 bool IteratableChunkChecksumValidator::finished() const
 {
+  return currentIndex_ >= dctx_->getNumPieces() && numPending_ == 0;
+}
+
+bool IteratableChunkChecksumValidator::waiting() const
+{
+  if (numPending_ == 0) {
+    return false;
+  }
   if (currentIndex_ >= dctx_->getNumPieces()) {
     return true;
   }
-  else {
-    return false;
-  }
+  return !HashWorkerPool::getInstance()->hasRoom(
+      getChunkLength(currentIndex_));
+}
+
+void IteratableChunkChecksumValidator::setWaiter(Command* command)
+{
+  waiter_ = command;
 }
 
 int64_t IteratableChunkChecksumValidator::getCurrentOffset() const
 {
-  return static_cast<int64_t>(currentIndex_) * dctx_->getPieceLength();
+  return verifiedLength_;
 }
 
 int64_t IteratableChunkChecksumValidator::getTotalLength() const
@@ -39,6 +39,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace aria2 {
 
@@ -46,6 +47,7 @@ class DownloadContext;
 class PieceStorage;
 class BitfieldMan;
 class MessageDigest;
+class RecoverableException;
 
 class IteratableChunkChecksumValidator : public IteratableValidator {
 private:
@@ -54,11 +56,31 @@ private:
   std::unique_ptr<BitfieldMan> bitfield_;
   size_t currentIndex_;
   std::unique_ptr<MessageDigest> ctx_;
+  // Read buffer reused across pieces
+  std::vector<unsigned char> buf_;
+  // The number of pieces submitted to HashWorkerPool whose digests
+  // have not arrived yet.
+  size_t numPending_;
+  // The number of bytes whose pieces have been checked.
+  int64_t verifiedLength_;
+  Command* waiter_;
 
-  std::string calculateActualChecksum();
+  size_t getChunkLength(size_t index) const;
+
+  void readChunk(unsigned char* data, int64_t offset, size_t length);
 
   std::string digest(int64_t offset, size_t length);
 
+  void submitChunks();
+
+  void validateChunkSync();
+
+  void checkChunk(size_t index, const std::string& actualChecksum);
+
+  void onReadError(size_t index, const RecoverableException& ex);
+
+  void onChunkChecked(size_t length);
+
 public:
   IteratableChunkChecksumValidator(
       const std::shared_ptr<DownloadContext>& dctx,
@@ -72,6 +94,10 @@ public:
 
   virtual bool finished() const CXX11_OVERRIDE;
 
+  virtual bool waiting() const CXX11_OVERRIDE;
+
+  virtual void setWaiter(Command* command) CXX11_OVERRIDE;
+
   virtual int64_t getCurrentOffset() const CXX11_OVERRIDE;
 
   virtual int64_t getTotalLength() const CXX11_OVERRIDE;
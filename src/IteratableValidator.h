@@ -41,6 +41,8 @@
 
 namespace aria2 {
 
+class Command;
+
 /**
  * This class provides the interface to validate files.
  *
@@ -59,6 +61,14 @@ public:
 
   virtual bool finished() const = 0;
 
+  // Returns true if validateChunk() cannot make progress until the
+  // results computed in background arrive.
+  virtual bool waiting() const { return false; }
+
+  // Makes |command| active when a result computed in background
+  // arrives.  |command| may be nullptr.
+  virtual void setWaiter(Command* command) {}
+
   virtual int64_t getCurrentOffset() const = 0;
 
   virtual int64_t getTotalLength() const = 0;
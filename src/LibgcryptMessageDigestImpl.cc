@@ -99,6 +99,9 @@ typedef MessageDigestBase<GCRY_MD_SHA224> MessageDigestSHA224;
 typedef MessageDigestBase<GCRY_MD_SHA256> MessageDigestSHA256;
 typedef MessageDigestBase<GCRY_MD_SHA384> MessageDigestSHA384;
 typedef MessageDigestBase<GCRY_MD_SHA512> MessageDigestSHA512;
+#if GCRYPT_VERSION_NUMBER >= 0x010900
+typedef MessageDigestBase<GCRY_MD_SHA512_256> MessageDigestSHA512_256;
+#endif // GCRYPT_VERSION_NUMBER >= 0x010900
 } // namespace
 
 std::unique_ptr<MessageDigestImpl> MessageDigestImpl::sha1()
@@ -112,6 +115,9 @@ MessageDigestImpl::hashes_t MessageDigestImpl::hashes = {
     {"sha-256", make_hi<MessageDigestSHA256>()},
     {"sha-384", make_hi<MessageDigestSHA384>()},
     {"sha-512", make_hi<MessageDigestSHA512>()},
+#if GCRYPT_VERSION_NUMBER >= 0x010900
+    {"sha-512-256", make_hi<MessageDigestSHA512_256>()},
+#endif // GCRYPT_VERSION_NUMBER >= 0x010900
     {"md5", make_hi<MessageDigestMD5>()},
     ADLER32_MESSAGE_DIGEST};
 
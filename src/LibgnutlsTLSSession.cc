@@ -178,6 +178,31 @@ int GnuTLSSession::setSNIHostname(const std::string& hostname)
   return TLS_ERR_OK;
 }
 
+int GnuTLSSession::setSessionData(const std::string& data)
+{
+  rv_ = gnutls_session_set_data(sslSession_, data.data(), data.size());
+  if (rv_ != GNUTLS_E_SUCCESS) {
+    return TLS_ERR_ERROR;
+  }
+  return TLS_ERR_OK;
+}
+
+std::string GnuTLSSession::getSessionData()
+{
+  gnutls_datum_t data;
+  if (gnutls_session_get_data2(sslSession_, &data) != GNUTLS_E_SUCCESS) {
+    return "";
+  }
+  std::string res(data.data, data.data + data.size);
+  gnutls_free(data.data);
+  return res;
+}
+
+bool GnuTLSSession::isResumed()
+{
+  return gnutls_session_is_resumed(sslSession_) != 0;
+}
+
 int GnuTLSSession::closeConnection()
 {
   rv_ = gnutls_bye(sslSession_, GNUTLS_SHUT_WR);
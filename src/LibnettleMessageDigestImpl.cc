@@ -36,6 +36,7 @@
 #include "MessageDigestImpl.h"
 
 #include <nettle/nettle-meta.h>
+#include <nettle/sha2.h>
 
 #include "Adler32MessageDigestImpl.h"
 
@@ -83,6 +84,9 @@ typedef MessageDigestBase<&nettle_sha224> MessageDigestSHA224;
 typedef MessageDigestBase<&nettle_sha256> MessageDigestSHA256;
 typedef MessageDigestBase<&nettle_sha384> MessageDigestSHA384;
 typedef MessageDigestBase<&nettle_sha512> MessageDigestSHA512;
+#ifdef SHA512_256_DIGEST_SIZE
+typedef MessageDigestBase<&nettle_sha512_256> MessageDigestSHA512_256;
+#endif // SHA512_256_DIGEST_SIZE
 } // namespace
 
 std::unique_ptr<MessageDigestImpl> MessageDigestImpl::sha1()
@@ -96,6 +100,9 @@ MessageDigestImpl::hashes_t MessageDigestImpl::hashes = {
     {"sha-256", make_hi<MessageDigestSHA256>()},
     {"sha-384", make_hi<MessageDigestSHA384>()},
     {"sha-512", make_hi<MessageDigestSHA512>()},
+#ifdef SHA512_256_DIGEST_SIZE
+    {"sha-512-256", make_hi<MessageDigestSHA512_256>()},
+#endif // SHA512_256_DIGEST_SIZE
     {"md5", make_hi<MessageDigestMD5>()},
     ADLER32_MESSAGE_DIGEST};
 
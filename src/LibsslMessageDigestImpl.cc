@@ -117,6 +117,9 @@ MessageDigestImpl::hashes_t MessageDigestImpl::hashes = {
 #endif
 #ifdef HAVE_EVP_SHA224
     {"sha-512", make_hi<MessageDigestBase<EVP_sha512>>()},
+#endif
+#ifdef HAVE_EVP_SHA512_256
+    {"sha-512-256", make_hi<MessageDigestBase<EVP_sha512_256>>()},
 #endif
     {"md5", make_hi<MessageDigestMD5>()},
     ADLER32_MESSAGE_DIGEST};
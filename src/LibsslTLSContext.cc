@@ -141,6 +141,9 @@ OpenSSLTLSContext::OpenSSLTLSContext(TLSSessionSide side, TLSVersion minVer)
   );
   SSL_CTX_set_mode(sslCtx_, SSL_MODE_AUTO_RETRY);
   SSL_CTX_set_mode(sslCtx_, SSL_MODE_ENABLE_PARTIAL_WRITE);
+  // SocketCore::writeVector() retries a write from a different buffer
+  // with the same contents.
+  SSL_CTX_set_mode(sslCtx_, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
 #ifdef SSL_MODE_RELEASE_BUFFERS
   /* keep memory usage low */
   SSL_CTX_set_mode(sslCtx_, SSL_MODE_RELEASE_BUFFERS);
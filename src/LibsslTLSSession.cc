@@ -96,6 +96,48 @@ int OpenSSLTLSSession::setSNIHostname(const std::string& hostname)
   return TLS_ERR_OK;
 }
 
+int OpenSSLTLSSession::setSessionData(const std::string& data)
+{
+  ERR_clear_error();
+  auto p = reinterpret_cast<const unsigned char*>(data.data());
+  auto session = d2i_SSL_SESSION(nullptr, &p, data.size());
+  if (!session) {
+    return TLS_ERR_ERROR;
+  }
+  // SSL_set_session() takes its own reference.
+  auto rv = SSL_set_session(ssl_, session);
+  SSL_SESSION_free(session);
+  if (rv != 1) {
+    return TLS_ERR_ERROR;
+  }
+  return TLS_ERR_OK;
+}
+
+std::string OpenSSLTLSSession::getSessionData()
+{
+  auto session = SSL_get_session(ssl_);
+  if (!session) {
+    return "";
+  }
+#if OPENSSL_111_API
+  // TLSv1.3 session can be resumed only after the server sent a
+  // ticket, which may arrive after handshake.
+  if (!SSL_SESSION_is_resumable(session)) {
+    return "";
+  }
+#endif // OPENSSL_111_API
+  auto len = i2d_SSL_SESSION(session, nullptr);
+  if (len <= 0) {
+    return "";
+  }
+  std::string res(len, '\0');
+  auto p = reinterpret_cast<unsigned char*>(&res[0]);
+  i2d_SSL_SESSION(session, &p);
+  return res;
+}
+
+bool OpenSSLTLSSession::isResumed() { return SSL_session_reused(ssl_) == 1; }
+
 int OpenSSLTLSSession::closeConnection()
 {
   ERR_clear_error();
@@ -412,6 +412,8 @@ ssize_t MultiDiskAdaptor::readData(unsigned char* data, size_t len,
 
 void MultiDiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
 {
+  // Adjacent cells are not merged here.  DiskIOEngine merges them
+  // when it is enabled; otherwise each cell is one write.
   for (auto& d : entry->getDataSet()) {
     A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", d->goff,
                      static_cast<unsigned long>(d->len)));
@@ -421,6 +423,7 @@ void MultiDiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
 
 void MultiDiskAdaptor::flushOSBuffers()
 {
+  drainWrites();
   for (auto& dwent : openedDiskWriterEntries_) {
     auto& dw = dwent->getDiskWriter();
     if (!dw) {
@@ -430,6 +433,18 @@ void MultiDiskAdaptor::flushOSBuffers()
   }
 }
 
+void MultiDiskAdaptor::drainWrites()
+{
+  // Files closed to limit the number of open files may have pending
+  // errors too.
+  for (auto& dwent : diskWriterEntries_) {
+    auto& dw = dwent->getDiskWriter();
+    if (dw) {
+      dw->drainWrites();
+    }
+  }
+}
+
 bool MultiDiskAdaptor::fileExists()
 {
   return std::find_if(std::begin(getFileEntries()), std::end(getFileEntries()),
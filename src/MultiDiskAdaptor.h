@@ -137,6 +137,8 @@ public:
 
   virtual void flushOSBuffers() CXX11_OVERRIDE;
 
+  virtual void drainWrites() CXX11_OVERRIDE;
+
   virtual bool fileExists() CXX11_OVERRIDE;
 
   virtual int64_t size() CXX11_OVERRIDE;
@@ -45,6 +45,8 @@ class NameResolver {
 private:
   int socktype_;
   int family_;
+  std::string lastError_;
+  bool negativeAnswer_;
 
 public:
   NameResolver();
@@ -60,6 +62,13 @@ public:
 
   // specify protocol family
   void setFamily(int family) { family_ = family; }
+
+  // Returns the cause of the last failure of resolve().
+  const std::string& getLastError() const { return lastError_; }
+
+  // Returns true if the last failure says the name has no address,
+  // as opposed to a temporary failure such as a timeout.
+  bool isNegativeAnswer() const { return negativeAnswer_; }
 };
 
 } // namespace aria2
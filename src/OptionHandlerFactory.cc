@@ -108,6 +108,25 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
   }
 #  endif // HAVE_ARES_SET_SERVERS && HAVE_ARES_ADDR_NODE
 #endif   // ENABLE_ASYNC_DNS
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_DNS_CACHE_SIZE, TEXT_DNS_CACHE_SIZE, "1024", 1));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_DNS_CACHE_TTL, TEXT_DNS_CACHE_TTL, "300", 0, 86400));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(new NumberOptionHandler(PREF_DNS_NEGATIVE_CACHE_TTL,
+                                              TEXT_DNS_NEGATIVE_CACHE_TTL,
+                                              "30", 0, 3600));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new BooleanOptionHandler(
         PREF_AUTO_FILE_RENAMING, TEXT_AUTO_FILE_RENAMING, A2_V_TRUE,
@@ -185,6 +204,26 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_ADVANCED);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_DISK_IO_QUEUE_DEPTH, TEXT_DISK_IO_QUEUE_DEPTH, "8", 0, 256));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_HASH_WORKER_THREADS, TEXT_HASH_WORKER_THREADS, "2", 0, 64));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_BITTORRENT);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_MAX_CONCURRENT_CHECKS, TEXT_MAX_CONCURRENT_CHECKS, "1", 1, 64));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_CHECKSUM);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new ParameterOptionHandler(
         PREF_CONSOLE_LOG_LEVEL, TEXT_CONSOLE_LOG_LEVEL, V_NOTICE,
@@ -478,6 +517,19 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_MAX_POOLED_CONNECTIONS, TEXT_MAX_POOLED_CONNECTIONS, "128", 0));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_MAX_POOLED_CONNECTIONS_PER_HOST,
+        TEXT_MAX_POOLED_CONNECTIONS_PER_HOST, "16", 1));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(
         new UnitNumberOptionHandler(PREF_MAX_OVERALL_DOWNLOAD_LIMIT,
@@ -706,6 +758,19 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_ADVANCED);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new UnitNumberOptionHandler(
+        PREF_RECV_BUFFER_SIZE, TEXT_RECV_BUFFER_SIZE, "16K", 16_k, 16_m));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
+  {
+    OptionHandler* op(new UnitNumberOptionHandler(PREF_RECV_BUFFER_MEMORY_LIMIT,
+                                                  TEXT_RECV_BUFFER_MEMORY_LIMIT,
+                                                  "64M", 0, 1_g));
+    op->addTag(TAG_ADVANCED);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new BooleanOptionHandler(
         PREF_STDERR, TEXT_STDERR, A2_V_FALSE, OptionHandler::OPT_ARG));
@@ -934,6 +999,18 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new BooleanOptionHandler(PREF_ADAPTIVE_SPLIT,
+                                               TEXT_ADAPTIVE_SPLIT, A2_V_FALSE,
+                                               OptionHandler::OPT_ARG));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_FTP);
+    op->addTag(TAG_HTTP);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new BooleanOptionHandler(
         PREF_REUSE_URI, TEXT_REUSE_URI, A2_V_TRUE, OptionHandler::OPT_ARG));
@@ -1010,7 +1087,7 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
   {
     OptionHandler* op(new ParameterOptionHandler(
         PREF_URI_SELECTOR, TEXT_URI_SELECTOR, V_FEEDBACK,
-        {V_INORDER, V_FEEDBACK, V_ADAPTIVE}));
+        {V_INORDER, V_FEEDBACK, V_ADAPTIVE, V_PREDICTIVE}));
     op->addTag(TAG_FTP);
     op->addTag(TAG_HTTP);
     op->setInitialOption(true);
@@ -36,6 +36,7 @@
 
 #include <array>
 #include <cassert>
+#include <cstring>
 
 #include "util.h"
 #include "BitfieldMan.h"
@@ -274,6 +275,42 @@ Piece::getDigestWithWrCache(size_t pieceLength,
   return mdctx->digest();
 }
 
+namespace {
+void readFully(unsigned char* buf, const std::shared_ptr<DiskAdaptor>& adaptor,
+               int64_t offset, size_t len)
+{
+  while (len > 0) {
+    ssize_t nread = adaptor->readData(buf, len, offset);
+    if (nread <= 0) {
+      throw DL_ABORT_EX(fmt(EX_FILE_READ, "n/a", "data is too short"));
+    }
+    buf += nread;
+    len -= nread;
+    offset += nread;
+  }
+}
+} // namespace
+
+std::vector<unsigned char>
+Piece::getDataWithWrCache(size_t pieceLength,
+                          const std::shared_ptr<DiskAdaptor>& adaptor)
+{
+  std::vector<unsigned char> buf(length_);
+  int64_t start = static_cast<int64_t>(index_) * pieceLength;
+  int64_t goff = start;
+  if (wrCache_) {
+    for (auto& d : wrCache_->getDataSet()) {
+      if (goff < d->goff) {
+        readFully(buf.data() + (goff - start), adaptor, goff, d->goff - goff);
+      }
+      memcpy(buf.data() + (d->goff - start), d->data + d->offset, d->len);
+      goff = d->goff + d->len;
+    }
+  }
+  readFully(buf.data() + (goff - start), adaptor, goff, start + length_ - goff);
+  return buf;
+}
+
 void Piece::destroyHashContext()
 {
   mdctx_.reset();
@@ -318,6 +355,7 @@ void Piece::flushWrCache(WrDiskCache* diskCache)
   ssize_t size = static_cast<ssize_t>(wrCache_->getSize());
   diskCache->update(wrCache_.get(), -size);
   wrCache_->writeToDisk();
+  wrCache_->waitWrites();
 }
 
 void Piece::clearWrCache(WrDiskCache* diskCache)
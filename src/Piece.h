@@ -162,6 +162,14 @@ public:
   // cached data and data on disk.
   std::string getDigestWithWrCache(size_t pieceLength,
                                    const std::shared_ptr<DiskAdaptor>& adaptor);
+
+  // Returns the copy of the whole piece data.  Cached data are used
+  // where available, and the rest is read from disk.
+  std::vector<unsigned char>
+  getDataWithWrCache(size_t pieceLength,
+                     const std::shared_ptr<DiskAdaptor>& adaptor);
+
+  const std::string& getHashType() const { return hashType_; }
   /**
    * Loses current bitfield state.
    */
@@ -176,6 +184,9 @@ public:
 
   void initWrCache(WrDiskCache* diskCache,
                    const std::shared_ptr<DiskAdaptor>& diskAdaptor);
+  // Writes the cached data to the disk and waits for the writes to
+  // complete, so that their error is available from
+  // getWrDiskCacheEntry()->getError().
   void flushWrCache(WrDiskCache* diskCache);
   void clearWrCache(WrDiskCache* diskCache);
   void updateWrCache(WrDiskCache* diskCache, unsigned char* data, size_t offset,
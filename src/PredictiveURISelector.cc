@@ -0,0 +1,206 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "PredictiveURISelector.h"
+
+#include <algorithm>
+
+#include "ServerStatMan.h"
+#include "ServerStat.h"
+#include "A2STR.h"
+#include "FileEntry.h"
+#include "Logger.h"
+#include "LogFactory.h"
+#include "a2algo.h"
+#include "a2functional.h"
+#include "uri.h"
+#include "fmt.h"
+#include "TimeA2.h"
+
+namespace aria2 {
+
+namespace {
+// Length assumed when the file size is not known yet.
+constexpr int64_t DEFAULT_LENGTH = 1_m;
+// Error rate is capped so that a flaky server is still preferred to
+// one which is known to be very slow.
+constexpr double MAX_ERROR_RATE = 0.9;
+
+bool isProfiled(const std::shared_ptr<ServerStat>& ss)
+{
+  return ss && ss->getThroughputEwma() > 0;
+}
+
+bool hasLatency(const std::shared_ptr<ServerStat>& ss)
+{
+  return ss && (!ss->getConnectTime().empty() || !ss->getTTFB().empty());
+}
+
+// Returns latency in seconds.
+double getLatency(const ServerStat& ss)
+{
+  return (ss.getConnectTime().percentile(0.5) + ss.getTTFB().percentile(0.5)) /
+         1000;
+}
+} // namespace
+
+PredictiveURISelector::PredictiveURISelector(
+    const std::shared_ptr<ServerStatMan>& serverStatMan)
+    : serverStatMan_(serverStatMan), explored_(false)
+{
+}
+
+PredictiveURISelector::~PredictiveURISelector() = default;
+
+std::string PredictiveURISelector::select(
+    FileEntry* fileEntry,
+    const std::vector<std::pair<size_t, std::string>>& usedHosts)
+{
+  auto& uris = fileEntry->getRemainingUris();
+  if (uris.empty()) {
+    return A2STR::NIL;
+  }
+  auto length = fileEntry->getLength();
+  if (length <= 0) {
+    length = DEFAULT_LENGTH;
+  }
+  // Prefer hosts not used yet, so that connections are spread over
+  // mirrors.  If all of them are used, pick the best one regardless.
+  auto uri = selectBest(uris, length, usedHosts);
+  if (uri.empty()) {
+    uri = selectBest(uris, length, {});
+  }
+  if (uri.empty()) {
+    uri = uris.front();
+  }
+  uris.erase(std::find(std::begin(uris), std::end(uris), uri));
+  if (!explored_) {
+    uri_split_result us;
+    if (uri_split(&us, uri.c_str()) == 0) {
+      auto host = uri::getFieldString(us, USR_HOST, uri.c_str());
+      auto protocol = uri::getFieldString(us, USR_SCHEME, uri.c_str());
+      explored_ = !isProfiled(serverStatMan_->find(host, protocol));
+    }
+  }
+  A2_LOG_DEBUG(fmt("PredictiveURISelector selected %s", uri.c_str()));
+  return uri;
+}
+
+std::string PredictiveURISelector::selectBest(
+    const std::deque<std::string>& uris, int64_t length,
+    const std::vector<std::pair<size_t, std::string>>& usedHosts)
+{
+  auto now = Time();
+  // pair of ServerStat (may be null) and URI
+  std::vector<std::pair<std::shared_ptr<ServerStat>, std::string>> cands;
+  int prior = 0;
+  for (const auto& u : uris) {
+    uri_split_result us;
+    if (uri_split(&us, u.c_str()) == -1) {
+      continue;
+    }
+    auto host = uri::getFieldString(us, USR_HOST, u.c_str());
+    if (findSecond(std::begin(usedHosts), std::end(usedHosts), host) !=
+        std::end(usedHosts)) {
+      continue;
+    }
+    auto protocol = uri::getFieldString(us, USR_SCHEME, u.c_str());
+    auto ss = serverStatMan_->find(host, protocol);
+    if (ss && ss->isError()) {
+      A2_LOG_DEBUG(fmt("Error not considered: %s", u.c_str()));
+      continue;
+    }
+    if (explored_ && !isProfiled(ss)) {
+      A2_LOG_DEBUG(fmt("Already explored one server, not considered: %s",
+                       u.c_str()));
+      continue;
+    }
+    if (ss) {
+      prior = std::max(prior, ss->getThroughputEwma());
+    }
+    cands.emplace_back(std::move(ss), u);
+  }
+  if (cands.empty()) {
+    return A2STR::NIL;
+  }
+  // Servers without latency samples get the median latency of the
+  // known ones instead of zero.
+  std::vector<double> latencies;
+  for (const auto& c : cands) {
+    if (hasLatency(c.first)) {
+      latencies.push_back(getLatency(*c.first));
+    }
+  }
+  double defaultLatency = 0;
+  if (!latencies.empty()) {
+    auto mid = std::begin(latencies) + latencies.size() / 2;
+    std::nth_element(std::begin(latencies), mid, std::end(latencies));
+    defaultLatency = *mid;
+  }
+  auto best = std::end(cands);
+  double bestTime = 0;
+  for (auto i = std::begin(cands), eoi = std::end(cands); i != eoi; ++i) {
+    const auto& ss = (*i).first;
+    double speed = prior;
+    // in seconds
+    double latency = defaultLatency;
+    double errorRate = 0;
+    if (ss) {
+      // Old statistics are blended with the prior, so that a server
+      // which was slow long time ago gets another chance.
+      auto w = ss->getRecencyWeight(now);
+      if (ss->getThroughputEwma() > 0) {
+        speed = w * ss->getThroughputEwma() + (1 - w) * prior;
+      }
+      if (hasLatency(ss)) {
+        latency = getLatency(*ss);
+      }
+      errorRate = std::min(MAX_ERROR_RATE, w * ss->getErrorRate());
+    }
+    double t = latency;
+    if (speed > 0) {
+      t += length / speed;
+    }
+    t /= 1 - errorRate;
+    A2_LOG_DEBUG(fmt("Expected completion time of %s is %.3fs",
+                     (*i).second.c_str(), t));
+    if (best == eoi || t < bestTime) {
+      best = i;
+      bestTime = t;
+    }
+  }
+  return (*best).second;
+}
+
+} // namespace aria2
@@ -0,0 +1,75 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_PREDICTIVE_URI_SELECTOR_H
+#define D_PREDICTIVE_URI_SELECTOR_H
+#include "URISelector.h"
+
+#include <memory>
+
+namespace aria2 {
+
+class ServerStatMan;
+
+// Selects the URI whose server is expected to finish the download
+// first.  The expected time is estimated from throughput, connect
+// time and TTFB percentiles and error rate recorded in ServerStat.
+// Servers without statistics are assumed to be as fast as the best
+// known one and to have the median latency, so that they get explored.
+// At most one such server is explored per download.
+class PredictiveURISelector : public URISelector {
+private:
+  std::shared_ptr<ServerStatMan> serverStatMan_;
+
+  // true if a server without throughput statistics has been selected.
+  bool explored_;
+
+  std::string
+  selectBest(const std::deque<std::string>& uris, int64_t length,
+             const std::vector<std::pair<size_t, std::string>>& usedHosts);
+
+public:
+  PredictiveURISelector(const std::shared_ptr<ServerStatMan>& serverStatMan);
+
+  virtual ~PredictiveURISelector();
+
+  virtual std::string
+  select(FileEntry* fileEntry,
+         const std::vector<std::pair<size_t, std::string>>& usedHosts)
+      CXX11_OVERRIDE;
+};
+
+} // namespace aria2
+
+#endif // D_PREDICTIVE_URI_SELECTOR_H
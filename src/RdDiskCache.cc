@@ -0,0 +1,137 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "RdDiskCache.h"
+
+#include <cstring>
+
+#include "WrDiskCache.h"
+#include "DiskAdaptor.h"
+#include "DlAbortEx.h"
+#include "LogFactory.h"
+#include "message.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+RdDiskCache* RdDiskCache::instance_ = nullptr;
+
+RdDiskCache::RdDiskCache(size_t limit, const WrDiskCache* wrDiskCache)
+    : limit_(limit), wrDiskCache_(wrDiskCache), total_(0)
+{
+}
+
+RdDiskCache::~RdDiskCache()
+{
+  if (instance_ == this) {
+    instance_ = nullptr;
+  }
+}
+
+bool RdDiskCache::readData(unsigned char* data, size_t len, size_t begin,
+                           const void* owner, size_t index,
+                           int64_t pieceOffset, size_t pieceLength,
+                           DiskAdaptor* diskAdaptor)
+{
+  if (begin + len > pieceLength) {
+    return false;
+  }
+  auto i = index_.find(Key(owner, index));
+  if (i != std::end(index_)) {
+    ++stat_.hits;
+    // Move to the front
+    lru_.splice(std::begin(lru_), lru_, (*i).second);
+    memcpy(data, (*i).second->data.data() + begin, len);
+    return true;
+  }
+  ++stat_.misses;
+  // Don't let one piece take more than half of the cache.
+  if (pieceLength > limit_ / 2) {
+    return false;
+  }
+  std::vector<unsigned char> buf(pieceLength);
+  for (size_t off = 0; off < pieceLength;) {
+    ssize_t r = diskAdaptor->readData(buf.data() + off, pieceLength - off,
+                                      pieceOffset + off);
+    if (r <= 0) {
+      throw DL_ABORT_EX(EX_DATA_READ);
+    }
+    off += r;
+  }
+  memcpy(data, buf.data() + begin, len);
+  A2_LOG_DEBUG(fmt("Cached piece for read index=%lu, length=%lu",
+                   static_cast<unsigned long>(index),
+                   static_cast<unsigned long>(pieceLength)));
+  lru_.push_front(Entry{Key(owner, index), std::move(buf)});
+  index_.insert(std::make_pair(Key(owner, index), std::begin(lru_)));
+  total_ += pieceLength;
+  ensureLimit();
+  return true;
+}
+
+void RdDiskCache::remove(const void* owner)
+{
+  for (auto i = std::begin(lru_); i != std::end(lru_);) {
+    if ((*i).key.first == owner) {
+      total_ -= (*i).data.size();
+      index_.erase((*i).key);
+      i = lru_.erase(i);
+    }
+    else {
+      ++i;
+    }
+  }
+}
+
+void RdDiskCache::ensureLimit()
+{
+  size_t wrSize = wrDiskCache_ ? wrDiskCache_->getSize() : 0;
+  size_t limit = limit_ > wrSize ? limit_ - wrSize : 0;
+  while (total_ > limit) {
+    auto& ent = lru_.back();
+    A2_LOG_DEBUG(fmt("Evict read cache index=%lu, length=%lu",
+                     static_cast<unsigned long>(ent.key.second),
+                     static_cast<unsigned long>(ent.data.size())));
+    total_ -= ent.data.size();
+    index_.erase(ent.key);
+    lru_.pop_back();
+    ++stat_.evictions;
+  }
+}
+
+RdDiskCache* RdDiskCache::getInstance() { return instance_; }
+
+void RdDiskCache::setInstance(RdDiskCache* cache) { instance_ = cache; }
+
+} // namespace aria2
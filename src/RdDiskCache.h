@@ -0,0 +1,127 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_RD_DISK_CACHE_H
+#define D_RD_DISK_CACHE_H
+
+#include "common.h"
+
+#include <list>
+#include <map>
+#include <vector>
+#include <memory>
+
+namespace aria2 {
+
+class DiskAdaptor;
+class WrDiskCache;
+
+struct RdDiskCacheStat {
+  RdDiskCacheStat() : hits(0), misses(0), evictions(0) {}
+
+  // The number of reads served from the cache.
+  int64_t hits;
+  // The number of reads which went to the disk.
+  int64_t misses;
+  // The number of pieces evicted to keep the cache within its limit.
+  int64_t evictions;
+};
+
+// Caches whole pieces read to serve peers.  When a block of a piece
+// not in the cache is requested, the whole piece is read, so that the
+// requests for the following blocks from the same or other peers do
+// not touch the disk.  The least recently used pieces are evicted
+// first.
+//
+// The cache shares its limit with WrDiskCache: it uses only the part
+// the write cache does not use.
+class RdDiskCache {
+public:
+  // |wrDiskCache| may be null.
+  RdDiskCache(size_t limit, const WrDiskCache* wrDiskCache);
+
+  ~RdDiskCache();
+
+  // Copies |len| bytes at |begin| in the piece |index| of |owner| to
+  // |data|.  If the piece is not cached, reads the whole piece, which
+  // is |pieceLength| bytes at |pieceOffset| in |diskAdaptor|, and
+  // caches it.  Returns false without reading anything if the piece is
+  // too large to cache or the block is not in the piece.  Throws DlAbortEx if the data cannot be read.
+  bool readData(unsigned char* data, size_t len, size_t begin,
+                const void* owner, size_t index, int64_t pieceOffset,
+                size_t pieceLength, DiskAdaptor* diskAdaptor);
+
+  // Drops the pieces of |owner|.
+  void remove(const void* owner);
+
+  // Evicts pieces until the cache fits in the part of the limit the
+  // write cache does not use.
+  void ensureLimit();
+
+  // Returns the number of bytes cached.
+  size_t getSize() const { return total_; }
+
+  size_t getNumPieces() const { return lru_.size(); }
+
+  const RdDiskCacheStat& getStat() const { return stat_; }
+
+  // Returns the cache used by BtPieceMessage, or nullptr.
+  static RdDiskCache* getInstance();
+
+  static void setInstance(RdDiskCache* cache);
+
+private:
+  typedef std::pair<const void*, size_t> Key;
+
+  struct Entry {
+    Key key;
+    std::vector<unsigned char> data;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  size_t limit_;
+  const WrDiskCache* wrDiskCache_;
+  size_t total_;
+  // The most recently used piece first
+  EntryList lru_;
+  std::map<Key, EntryList::iterator> index_;
+  RdDiskCacheStat stat_;
+
+  static RdDiskCache* instance_;
+};
+
+} // namespace aria2
+
+#endif // D_RD_DISK_CACHE_H
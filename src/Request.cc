@@ -59,6 +59,7 @@ Request::Request()
       supportsPersistentConnection_(true),
       keepAliveHint_(false),
       pipeliningHint_(false),
+      pipeliningDisabled_(false),
       maxPipelinedRequest_(1),
       removalRequested_(false),
       connectedPort_(0),
@@ -163,6 +164,13 @@ void Request::resetRedirectCount() { redirectCount_ = 0; }
 
 void Request::setMaxPipelinedRequest(int num) { maxPipelinedRequest_ = num; }
 
+void Request::disablePipelining()
+{
+  pipeliningHint_ = false;
+  pipeliningDisabled_ = true;
+  maxPipelinedRequest_ = 1;
+}
+
 const std::shared_ptr<PeerStat>& Request::initPeerStat()
 {
   // Use host and protocol in original URI, because URI selector
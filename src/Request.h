@@ -67,6 +67,8 @@ private:
   bool keepAliveHint_;
   // enable pipelining if possible.
   bool pipeliningHint_;
+  // true if the server turned out to break pipelined requests.
+  bool pipeliningDisabled_;
   // maximum number of pipelined requests
   int maxPipelinedRequest_;
   std::shared_ptr<PeerStat> peerStat_;
@@ -133,6 +135,13 @@ public:
 
   bool isPipeliningHint() const { return pipeliningHint_; }
 
+  // Disables pipelining for this Request for good, so that
+  // pipeliningHint_ is not turned on again when the next connection
+  // is made.
+  void disablePipelining();
+
+  bool isPipeliningDisabled() const { return pipeliningDisabled_; }
+
   void setMaxPipelinedRequest(int num);
 
   int getMaxPipelinedRequest() const { return maxPipelinedRequest_; }
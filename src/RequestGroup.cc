@@ -58,6 +58,8 @@
 #include "DownloadContext.h"
 #include "DlAbortEx.h"
 #include "DownloadFailureException.h"
+#include "HashWorkerPool.h"
+#include "RdDiskCache.h"
 #include "RequestGroupMan.h"
 #include "DefaultBtProgressInfoFile.h"
 #include "DefaultPieceStorage.h"
@@ -72,6 +74,7 @@
 #include "A2STR.h"
 #include "URISelector.h"
 #include "InorderURISelector.h"
+#include "ConnectionScaler.h"
 #include "PieceSelector.h"
 #include "a2functional.h"
 #include "SocketCore.h"
@@ -152,7 +155,8 @@ RequestGroup::RequestGroup(const std::shared_ptr<GroupId>& gid,
       pauseRequested_(false),
       restartRequested_(false),
       inMemoryDownload_(false),
-      seedOnly_(false)
+      seedOnly_(false),
+      writeFailed_(false)
 {
   fileAllocationEnabled_ = option_->get(PREF_FILE_ALLOCATION) != V_NONE;
   if (!option_->getAsBool(PREF_DRY_RUN)) {
@@ -173,7 +177,7 @@ bool RequestGroup::isCheckIntegrityReady()
 
 bool RequestGroup::downloadFinished() const
 {
-  if (!pieceStorage_) {
+  if (!pieceStorage_ || writeFailed_) {
     return false;
   }
   return pieceStorage_->downloadFinished();
@@ -181,7 +185,7 @@ bool RequestGroup::downloadFinished() const
 
 bool RequestGroup::allDownloadFinished() const
 {
-  if (!pieceStorage_) {
+  if (!pieceStorage_ || writeFailed_) {
     return false;
   }
   return pieceStorage_->allDownloadFinished();
@@ -210,8 +214,17 @@ std::pair<error_code::Value, std::string> RequestGroup::downloadResult() const
 void RequestGroup::closeFile()
 {
   if (pieceStorage_) {
-    pieceStorage_->flushWrDiskCacheEntry(true);
-    pieceStorage_->getDiskAdaptor()->flushOSBuffers();
+    try {
+      pieceStorage_->flushWrDiskCacheEntry(true);
+      pieceStorage_->getDiskAdaptor()->flushOSBuffers();
+    }
+    catch (RecoverableException& e) {
+      A2_LOG_ERROR_EX(EX_EXCEPTION_CAUGHT, e);
+      // The data of completed pieces may not be on the disk, so the
+      // download must not be reported as finished.
+      writeFailed_ = true;
+      setLastErrorCode(e.getErrorCode(), e.what());
+    }
     pieceStorage_->getDiskAdaptor()->closeFile();
   }
 }
@@ -618,6 +631,7 @@ void RequestGroup::initPieceStorage()
   segmentMan_ =
       std::make_shared<SegmentMan>(downloadContext_, tempPieceStorage);
   pieceStorage_ = tempPieceStorage;
+  writeFailed_ = false;
 
 #ifdef __MINGW32__
   // Windows build: --file-allocation=falloc uses SetFileValidData
@@ -1023,6 +1037,12 @@ void RequestGroup::setRestartRequested(bool f) { restartRequested_ = f; }
 
 void RequestGroup::releaseRuntimeResource(DownloadEngine* e)
 {
+  if (e->getHashWorkerPool()) {
+    e->getHashWorkerPool()->cancel(this);
+  }
+  if (e->getRdDiskCache()) {
+    e->getRdDiskCache()->remove(this);
+  }
 #ifdef ENABLE_BITTORRENT
   e->getBtRegistry()->remove(gid_->getNumericId());
   btRuntime_ = nullptr;
@@ -1031,6 +1051,12 @@ void RequestGroup::releaseRuntimeResource(DownloadEngine* e)
   if (pieceStorage_) {
     pieceStorage_->removeAdvertisedPiece(Timer::zero());
   }
+  if (connectionScaler_) {
+    // A new scaler and ConnectionScalingCommand are created when the
+    // download is restarted.
+    numConcurrentCommand_ = connectionScaler_->getMaxConnections();
+    connectionScaler_.reset();
+  }
   // Don't reset segmentMan_ and pieceStorage_ here to provide
   // progress information via RPC
   progressInfoFile_ = std::make_shared<NullProgressInfoFile>();
@@ -1238,6 +1264,12 @@ void RequestGroup::setURISelector(std::unique_ptr<URISelector> uriSelector)
   uriSelector_ = std::move(uriSelector);
 }
 
+void RequestGroup::setConnectionScaler(
+    std::unique_ptr<ConnectionScaler> connectionScaler)
+{
+  connectionScaler_ = std::move(connectionScaler);
+}
+
 void RequestGroup::applyLastModifiedTimeToLocalFiles()
 {
   if (!pieceStorage_ || !lastModifiedTime_.good()) {
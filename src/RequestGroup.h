@@ -44,6 +44,7 @@
 #include <utility>
 
 #include "TransferStat.h"
+#include "AuthStat.h"
 #include "TimeA2.h"
 #include "Request.h"
 #include "error_code.h"
@@ -68,6 +69,7 @@ class RequestGroup;
 class CheckIntegrityEntry;
 struct DownloadResult;
 class URISelector;
+class ConnectionScaler;
 class URIResult;
 class RequestGroupMan;
 #ifdef ENABLE_BITTORRENT
@@ -113,6 +115,9 @@ private:
 
   std::unique_ptr<URISelector> uriSelector_;
 
+  // Non-null if the number of connections is adjusted dynamically.
+  std::unique_ptr<ConnectionScaler> connectionScaler_;
+
   std::shared_ptr<MetadataInfo> metadataInfo_;
 
   RequestGroupMan* requestGroupMan_;
@@ -155,6 +160,8 @@ private:
 
   int numCommand_;
 
+  AuthStat authStat_;
+
   int fileNotFoundCount_;
 
   int maxDownloadSpeedLimit_;
@@ -192,6 +199,10 @@ private:
 
   bool seedOnly_;
 
+  // true if the data could not be written when the files were
+  // closed.  Set by closeFile().
+  bool writeFailed_;
+
   void validateFilename(const std::string& expectedFilename,
                         const std::string& actualFilename) const;
 
@@ -245,6 +256,9 @@ public:
 
   bool allDownloadFinished() const;
 
+  // Flushes the cached data and closes the files.  If the data cannot
+  // be written, the download is failed with the error instead of
+  // being reported as finished.
   void closeFile();
 
   std::string getFirstFilePath() const;
@@ -274,6 +288,8 @@ public:
 
   int getNumConcurrentCommand() const { return numConcurrentCommand_; }
 
+  int getNumStreamCommand() const { return numStreamCommand_; }
+
   a2_gid_t getGID() const { return gid_->getNumericId(); }
 
   const std::shared_ptr<GroupId>& getGroupId() const { return gid_; }
@@ -316,6 +332,10 @@ public:
 
   int getNumCommand() const { return numCommand_; }
 
+  AuthStat& getAuthStat() { return authStat_; }
+
+  const AuthStat& getAuthStat() const { return authStat_; }
+
   // TODO is it better to move the following 2 methods to
   // SingleFileDownloadContext?
   void setDiskWriterFactory(
@@ -405,6 +425,13 @@ public:
 
   void setURISelector(std::unique_ptr<URISelector> uriSelector);
 
+  void setConnectionScaler(std::unique_ptr<ConnectionScaler> connectionScaler);
+
+  const std::unique_ptr<ConnectionScaler>& getConnectionScaler() const
+  {
+    return connectionScaler_;
+  }
+
   const std::unique_ptr<URISelector>& getURISelector() const
   {
     return uriSelector_;
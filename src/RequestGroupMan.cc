@@ -58,6 +58,7 @@
 #include "FeedbackURISelector.h"
 #include "InorderURISelector.h"
 #include "AdaptiveURISelector.h"
+#include "PredictiveURISelector.h"
 #include "Option.h"
 #include "prefs.h"
 #include "File.h"
@@ -499,6 +500,10 @@ void RequestGroupMan::configureRequestGroup(
     requestGroup->setURISelector(
         make_unique<AdaptiveURISelector>(serverStatMan_, requestGroup.get()));
   }
+  else if (uriSelectorValue == V_PREDICTIVE) {
+    requestGroup->setURISelector(
+        make_unique<PredictiveURISelector>(serverStatMan_));
+  }
 }
 
 namespace {
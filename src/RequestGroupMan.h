@@ -45,6 +45,7 @@
 
 #include "DownloadResult.h"
 #include "TransferStat.h"
+#include "AuthStat.h"
 #include "RequestGroup.h"
 #include "NetStat.h"
 #include "IndexedList.h"
@@ -101,6 +102,9 @@ private:
 
   NetStat netStat_;
 
+  // HTTP authentication counters of all downloads in this session.
+  AuthStat authStat_;
+
   // true if download engine should keep running even if there is no
   // download to perform.
   bool keepRunning_;
@@ -341,6 +345,10 @@ public:
 
   NetStat& getNetStat() { return netStat_; }
 
+  AuthStat& getAuthStat() { return authStat_; }
+
+  const AuthStat& getAuthStat() const { return authStat_; }
+
   WrDiskCache* getWrDiskCache() const { return wrDiskCache_.get(); }
 
   // Initializes WrDiskCache according to PREF_DISK_CACHE option.  If
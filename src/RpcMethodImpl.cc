@@ -69,6 +69,10 @@
 #include "MessageDigest.h"
 #include "message_digest_helper.h"
 #include "OpenedFileCounter.h"
+#include "SocketPool.h"
+#include "RdDiskCache.h"
+#include "ConnectionScaler.h"
+#include "SocketCore.h"
 #ifdef ENABLE_BITTORRENT
 #  include "bittorrent_helper.h"
 #  include "BtRegistry.h"
@@ -77,6 +81,9 @@
 #  include "BtRuntime.h"
 #  include "BtAnnounce.h"
 #endif // ENABLE_BITTORRENT
+#ifdef ENABLE_SSL
+#  include "TLSContext.h"
+#endif // ENABLE_SSL
 #include "CheckIntegrityEntry.h"
 
 namespace aria2 {
@@ -138,6 +145,25 @@ const char KEY_INFO[] = "info";
 const char KEY_NAME[] = "name";
 const char KEY_ANNOUNCE_LIST[] = "announceList";
 const char KEY_COMMENT[] = "comment";
+const char KEY_AUTH_STAT[] = "authStat";
+const char KEY_CHALLENGES[] = "challenges";
+const char KEY_PREEMPTIVE_HITS[] = "preemptiveHits";
+const char KEY_PREEMPTIVE_MISSES[] = "preemptiveMisses";
+const char KEY_STALE_NONCE_RETRIES[] = "staleNonceRetries";
+const char KEY_AUTH_RETRY_TIME[] = "authRetryTime";
+const char KEY_SOCKET_POOL_STAT[] = "socketPoolStat";
+const char KEY_POOLED_CONNECTIONS[] = "pooledConnections";
+const char KEY_HITS[] = "hits";
+const char KEY_MISSES[] = "misses";
+const char KEY_TIMEOUTS[] = "timeouts";
+const char KEY_EVICTIONS[] = "evictions";
+const char KEY_TLS_STAT[] = "tlsStat";
+const char KEY_FULL_HANDSHAKES[] = "fullHandshakes";
+const char KEY_RESUMED_HANDSHAKES[] = "resumedHandshakes";
+const char KEY_CACHED_SESSIONS[] = "cachedSessions";
+const char KEY_READ_CACHE_STAT[] = "readCacheStat";
+const char KEY_CACHED_PIECES[] = "cachedPieces";
+const char KEY_CACHED_LENGTH[] = "cachedLength";
 const char KEY_CREATION_DATE[] = "creationDate";
 const char KEY_MODE[] = "mode";
 const char KEY_SERVERS[] = "servers";
@@ -147,6 +173,7 @@ const char KEY_NUM_ACTIVE[] = "numActive";
 const char KEY_NUM_STOPPED_TOTAL[] = "numStoppedTotal";
 const char KEY_VERIFIED_LENGTH[] = "verifiedLength";
 const char KEY_VERIFY_PENDING[] = "verifyIntegrityPending";
+const char KEY_VERIFY_SPEED[] = "verifySpeed";
 } // namespace
 
 namespace {
@@ -613,6 +640,60 @@ bool requested_key(const std::vector<std::string>& keys, const std::string& k)
 }
 } // namespace
 
+namespace {
+std::unique_ptr<Dict> createAuthStatDict(const AuthStat& stat)
+{
+  auto dict = Dict::g();
+  dict->put(KEY_CHALLENGES, util::itos(stat.challenges));
+  dict->put(KEY_PREEMPTIVE_HITS, util::itos(stat.preemptiveHits));
+  dict->put(KEY_PREEMPTIVE_MISSES, util::itos(stat.preemptiveMisses));
+  dict->put(KEY_STALE_NONCE_RETRIES, util::itos(stat.staleNonceRetries));
+  dict->put(KEY_AUTH_RETRY_TIME, util::itos(stat.retryTime));
+  return dict;
+}
+} // namespace
+
+namespace {
+std::unique_ptr<Dict> createSocketPoolStatDict(const SocketPool& pool)
+{
+  auto dict = Dict::g();
+  const auto& stat = pool.getStat();
+  dict->put(KEY_POOLED_CONNECTIONS, util::uitos(pool.size()));
+  dict->put(KEY_HITS, util::itos(stat.hits));
+  dict->put(KEY_MISSES, util::itos(stat.misses));
+  dict->put(KEY_TIMEOUTS, util::itos(stat.timeouts));
+  dict->put(KEY_EVICTIONS, util::itos(stat.evictions));
+  return dict;
+}
+} // namespace
+
+namespace {
+std::unique_ptr<Dict> createReadCacheStatDict(const RdDiskCache& cache)
+{
+  auto dict = Dict::g();
+  const auto& stat = cache.getStat();
+  dict->put(KEY_CACHED_PIECES, util::uitos(cache.getNumPieces()));
+  dict->put(KEY_CACHED_LENGTH, util::uitos(cache.getSize()));
+  dict->put(KEY_HITS, util::itos(stat.hits));
+  dict->put(KEY_MISSES, util::itos(stat.misses));
+  dict->put(KEY_EVICTIONS, util::itos(stat.evictions));
+  return dict;
+}
+} // namespace
+
+#ifdef ENABLE_SSL
+namespace {
+std::unique_ptr<Dict> createTLSStatDict(const TLSSessionCache& cache)
+{
+  auto dict = Dict::g();
+  dict->put(KEY_FULL_HANDSHAKES, util::itos(cache.getFullHandshakes()));
+  dict->put(KEY_RESUMED_HANDSHAKES, util::itos(cache.getResumedHandshakes()));
+  dict->put(KEY_CACHED_SESSIONS, util::uitos(cache.size()));
+  return dict;
+}
+} // namespace
+#endif // ENABLE_SSL
+
 void gatherProgressCommon(Dict* entryDict,
                           const std::shared_ptr<RequestGroup>& group,
                           const std::vector<std::string>& keys)
@@ -688,6 +769,9 @@ void gatherProgressCommon(Dict* entryDict,
   if (requested_key(keys, KEY_DIR)) {
     entryDict->put(KEY_DIR, group->getOption()->get(PREF_DIR));
   }
+  if (requested_key(keys, KEY_AUTH_STAT)) {
+    entryDict->put(KEY_AUTH_STAT, createAuthStatDict(group->getAuthStat()));
+  }
 }
 
 #ifdef ENABLE_BITTORRENT
@@ -798,14 +882,14 @@ void gatherProgress(Dict* entryDict, const std::shared_ptr<RequestGroup>& group,
   }
 #endif // ENABLE_BITTORRENT
   if (e->getCheckIntegrityMan()) {
-    if (e->getCheckIntegrityMan()->isPicked(
-            [&group](const CheckIntegrityEntry& ent) {
-              return ent.getRequestGroup() == group.get();
-            })) {
-      entryDict->put(
-          KEY_VERIFIED_LENGTH,
-          util::itos(
-              e->getCheckIntegrityMan()->getPickedEntry()->getCurrentLength()));
+    auto entry = e->getCheckIntegrityMan()->findPickedEntry(
+        [&group](const CheckIntegrityEntry& ent) {
+          return ent.getRequestGroup() == group.get();
+        });
+    if (entry) {
+      entryDict->put(KEY_VERIFIED_LENGTH,
+                     util::itos(entry->getCurrentLength()));
+      entryDict->put(KEY_VERIFY_SPEED, util::itos(entry->getVerifySpeed()));
     }
     if (e->getCheckIntegrityMan()->isQueued(
             [&group](const CheckIntegrityEntry& ent) {
@@ -1390,6 +1474,20 @@ GetGlobalStatRpcMethod::process(const RpcRequest& req, DownloadEngine* e)
   res->put(KEY_NUM_STOPPED, util::uitos(rgman->getDownloadResults().size()));
   res->put(KEY_NUM_STOPPED_TOTAL, util::uitos(rgman->getNumStoppedTotal()));
   res->put(KEY_NUM_ACTIVE, util::uitos(rgman->getRequestGroups().size()));
+  res->put(KEY_AUTH_STAT, createAuthStatDict(rgman->getAuthStat()));
+  res->put(KEY_SOCKET_POOL_STAT,
+           createSocketPoolStatDict(*e->getSocketPool()));
+  if (e->getRdDiskCache()) {
+    res->put(KEY_READ_CACHE_STAT,
+             createReadCacheStatDict(*e->getRdDiskCache()));
+  }
+#ifdef ENABLE_SSL
+  const auto& tlsContext = SocketCore::getClientTLSContext();
+  if (tlsContext) {
+    res->put(KEY_TLS_STAT,
+             createTLSStatDict(tlsContext->getSessionCache()));
+  }
+#endif // ENABLE_SSL
   return std::move(res);
 }
 
@@ -1568,7 +1666,14 @@ void changeOption(const std::shared_ptr<RequestGroup>& group,
     dctx->setFileFilter(std::move(sgl));
   }
   if (option.defined(PREF_SPLIT)) {
-    group->setNumConcurrentCommand(grOption->getAsInt(PREF_SPLIT));
+    const auto& scaler = group->getConnectionScaler();
+    if (scaler) {
+      scaler->setMaxConnections(grOption->getAsInt(PREF_SPLIT));
+      group->setNumConcurrentCommand(scaler->getTarget());
+    }
+    else {
+      group->setNumConcurrentCommand(grOption->getAsInt(PREF_SPLIT));
+    }
   }
   if (option.defined(PREF_MAX_CONNECTION_PER_SERVER)) {
     int maxConn = grOption->getAsInt(PREF_MAX_CONNECTION_PER_SERVER);
@@ -242,6 +242,30 @@ void SegmentMan::getSegment(std::vector<std::shared_ptr<Segment>>& segments,
   }
 }
 
+void SegmentMan::getPipelinedSegment(
+    std::vector<std::shared_ptr<Segment>>& segments, cuid_t cuid,
+    size_t minSplitSize, size_t maxSegments)
+{
+  while (segments.size() < maxSegments) {
+    std::shared_ptr<Segment> segment;
+    if (!segments.empty()) {
+      // ignoreBitfield_ has the bits set for ignored pieces.
+      auto index = segments.back()->getIndex() + 1;
+      if (index < ignoreBitfield_.countBlock() &&
+          !ignoreBitfield_.isFilterBitSet(index)) {
+        segment = getSegmentWithIndex(cuid, index);
+      }
+    }
+    if (!segment) {
+      segment = getSegment(cuid, minSplitSize);
+      if (!segment) {
+        break;
+      }
+    }
+    segments.push_back(segment);
+  }
+}
+
 std::shared_ptr<Segment> SegmentMan::getSegmentWithIndex(cuid_t cuid,
                                                          size_t index)
 {
@@ -455,6 +479,60 @@ void SegmentMan::updateFastestPeerStat(
   }
 }
 
+std::shared_ptr<Segment> SegmentMan::stealSegment(cuid_t cuid)
+{
+  // The run may extend over files which are not selected.
+  if (pieceStorage_->isSelectiveDownloadingMode()) {
+    return nullptr;
+  }
+  size_t numPieces = downloadContext_->getNumPieces();
+  auto self = getPeerStat(cuid);
+  // A slow connection must not take work from faster ones.
+  int selfSpeed = self ? self->calculateDownloadSpeed() : 0;
+  size_t bestIndex = 0;
+  size_t bestRun = 0;
+  double bestTime = -1;
+  for (auto& segmentEntry : usedSegmentEntries_) {
+    if (segmentEntry->cuid == cuid) {
+      continue;
+    }
+    auto& segment = segmentEntry->segment;
+    size_t run = 0;
+    for (size_t i = segment->getIndex() + 1;
+         i < numPieces && !pieceStorage_->hasPiece(i) &&
+         !pieceStorage_->isPieceUsed(i) && !ignoreBitfield_.isFilterBitSet(i);
+         ++i, ++run)
+      ;
+    if (run < 2) {
+      continue;
+    }
+    int64_t remaining = segment->getLength() - segment->getWrittenLength() +
+                        static_cast<int64_t>(run) * downloadContext_->getPieceLength();
+    auto ps = getPeerStat(segmentEntry->cuid);
+    int speed = ps ? ps->calculateDownloadSpeed() : 0;
+    if (selfSpeed > 0 && speed > selfSpeed) {
+      continue;
+    }
+    // Connection which has not received data yet is treated as slow.
+    double t = static_cast<double>(remaining) / std::max(1, speed);
+    if (t > bestTime) {
+      bestTime = t;
+      bestIndex = segment->getIndex();
+      bestRun = run;
+    }
+  }
+  if (bestRun == 0) {
+    return nullptr;
+  }
+  size_t index = bestIndex + 1 + bestRun / 2;
+  A2_LOG_DEBUG(fmt("CUID#%" PRId64 " - Stealing piece %lu from the run of %lu"
+                   " pieces after piece %lu",
+                   cuid, static_cast<unsigned long>(index),
+                   static_cast<unsigned long>(bestRun),
+                   static_cast<unsigned long>(bestIndex)));
+  return getSegmentWithIndex(cuid, index);
+}
+
 size_t SegmentMan::countFreePieceFrom(size_t index) const
 {
   size_t numPieces = downloadContext_->getNumPieces();
@@ -139,6 +139,16 @@ public:
                   const std::shared_ptr<FileEntry>& fileEntry,
                   size_t maxSegments);
 
+  // Checkouts segments for pipelined requests on one connection and
+  // push back to segments until segments.size() < maxSegments holds
+  // false.  The segment following the last one in segments is
+  // preferred, so that the server can answer the requests with
+  // contiguous reads.  If it is not available, falls back to
+  // getSegment(cuid, minSplitSize).
+  void getPipelinedSegment(std::vector<std::shared_ptr<Segment>>& segments,
+                           cuid_t cuid, size_t minSplitSize,
+                           size_t maxSegments);
+
   /**
    * Returns a segment whose index is index.
    * If it has already assigned
@@ -154,6 +164,17 @@ public:
   std::shared_ptr<Segment> getCleanSegmentIfOwnerIsIdle(cuid_t cuid,
                                                         size_t index);
 
+  // Takes over the second half of the remaining work of the slowest
+  // connection.  Each connection downloads the free pieces following
+  // its segment in order, so the remaining work is its segment plus
+  // that run of free pieces.  The connection which is expected to
+  // finish last is chosen, and the piece in the middle of its run is
+  // assigned to cuid.  The owner stops when it reaches that piece.
+  // This is meant for the end of download, where getSegment() finds
+  // no piece because no free range is as large as minSplitSize.
+  // Returns null if no run has 2 or more pieces.
+  std::shared_ptr<Segment> stealSegment(cuid_t cuid);
+
   /**
    * Updates download status.
    */
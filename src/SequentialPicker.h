@@ -43,26 +43,66 @@
 
 namespace aria2 {
 
+// Hands out queued entries in FIFO order.  At most maxPicked_
+// entries are picked, i.e., processed, at the same time.
 template <typename T> class SequentialPicker {
 private:
   std::deque<std::unique_ptr<T>> entries_;
-  std::unique_ptr<T> pickedEntry_;
+  std::deque<std::unique_ptr<T>> pickedEntries_;
+  // Always null.  Returned by getPickedEntry() if nothing is picked.
+  std::unique_ptr<T> noEntry_;
+  size_t maxPicked_;
 
 public:
-  bool isPicked() const { return pickedEntry_.get(); }
+  SequentialPicker() : maxPicked_(1) {}
 
-  const std::unique_ptr<T>& getPickedEntry() const { return pickedEntry_; }
+  bool isPicked() const { return !pickedEntries_.empty(); }
 
-  void dropPickedEntry() { pickedEntry_.reset(); }
+  // Returns the entry picked first, or null.
+  const std::unique_ptr<T>& getPickedEntry() const
+  {
+    return pickedEntries_.empty() ? noEntry_ : pickedEntries_.front();
+  }
+
+  const std::deque<std::unique_ptr<T>>& getPickedEntries() const
+  {
+    return pickedEntries_;
+  }
+
+  // Drops the entry picked first.
+  void dropPickedEntry()
+  {
+    if (!pickedEntries_.empty()) {
+      pickedEntries_.pop_front();
+    }
+  }
+
+  void dropPickedEntry(const T* entry)
+  {
+    for (auto i = std::begin(pickedEntries_); i != std::end(pickedEntries_);
+         ++i) {
+      if ((*i).get() == entry) {
+        pickedEntries_.erase(i);
+        return;
+      }
+    }
+  }
 
   bool hasNext() const { return !entries_.empty(); }
 
+  // Returns true if the next entry can be picked without exceeding
+  // the maximum number of picked entries.
+  bool canPickNext() const
+  {
+    return hasNext() && pickedEntries_.size() < maxPicked_;
+  }
+
   T* pickNext()
   {
     if (hasNext()) {
-      pickedEntry_ = std::move(entries_.front());
+      pickedEntries_.push_back(std::move(entries_.front()));
       entries_.pop_front();
-      return pickedEntry_.get();
+      return pickedEntries_.back().get();
     }
     return nullptr;
   }
@@ -74,9 +114,24 @@ public:
 
   size_t countEntryInQueue() const { return entries_.size(); }
 
+  void setMaxPicked(size_t maxPicked) { maxPicked_ = maxPicked; }
+
+  size_t getMaxPicked() const { return maxPicked_; }
+
   bool isPicked(const std::function<bool(const T&)>& pred) const
   {
-    return pickedEntry_ && pred(*pickedEntry_);
+    return findPickedEntry(pred);
+  }
+
+  // Returns the picked entry which satisfies |pred|, or nullptr.
+  T* findPickedEntry(const std::function<bool(const T&)>& pred) const
+  {
+    for (auto& e : pickedEntries_) {
+      if (pred(*e)) {
+        return e.get();
+      }
+    }
+    return nullptr;
   }
 
   bool isQueued(const std::function<bool(const T&)>& pred) const
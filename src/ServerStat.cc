@@ -36,6 +36,9 @@
 
 #include <ostream>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
 
 #include "array_fun.h"
 #include "Logger.h"
@@ -50,6 +53,91 @@ namespace {
 const char* STATUS_STRING[] = {"OK", "ERROR"};
 } // namespace
 
+namespace {
+// Weight of the newest sample in throughputEwma_ and errorRate_.
+constexpr double EWMA_ALPHA = 0.3;
+constexpr auto RECENCY_HALF_LIFE = std::chrono::hours(7 * 24);
+} // namespace
+
+constexpr size_t LatencySketch::NUM_BUCKETS;
+constexpr uint32_t LatencySketch::AGE_THRESHOLD;
+
+LatencySketch::LatencySketch() : total_(0) { counts_.fill(0); }
+
+void LatencySketch::add(const std::chrono::milliseconds& t)
+{
+  size_t idx = 0;
+  for (auto ms = t.count(); ms > 0 && idx < NUM_BUCKETS - 1; ms >>= 1) {
+    ++idx;
+  }
+  ++counts_[idx];
+  if (++total_ >= AGE_THRESHOLD) {
+    total_ = 0;
+    for (auto& c : counts_) {
+      c /= 2;
+      total_ += c;
+    }
+  }
+}
+
+double LatencySketch::percentile(double q) const
+{
+  if (total_ == 0) {
+    return 0;
+  }
+  double target = std::max(0.0, std::min(1.0, q)) * total_;
+  double cum = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+    if (counts_[i] == 0) {
+      continue;
+    }
+    if (cum + counts_[i] >= target) {
+      double lo = i == 0 ? 0 : static_cast<double>(1 << (i - 1));
+      double hi = static_cast<double>(1 << i);
+      return lo + (hi - lo) * (target - cum) / counts_[i];
+    }
+    cum += counts_[i];
+  }
+  return static_cast<double>(1 << (NUM_BUCKETS - 1));
+}
+
+std::string LatencySketch::toString() const
+{
+  std::string res;
+  size_t last = NUM_BUCKETS;
+  for (; last > 0 && counts_[last - 1] == 0; --last)
+    ;
+  for (size_t i = 0; i < last; ++i) {
+    if (i > 0) {
+      res += ':';
+    }
+    res += util::uitos(counts_[i]);
+  }
+  return res;
+}
+
+bool LatencySketch::parse(const std::string& s)
+{
+  std::vector<std::string> items;
+  util::split(s.begin(), s.end(), std::back_inserter(items), ':', false,
+              true);
+  if (items.size() > NUM_BUCKETS) {
+    return false;
+  }
+  std::array<uint32_t, NUM_BUCKETS> counts;
+  counts.fill(0);
+  uint32_t total = 0;
+  for (size_t i = 0; i < items.size(); ++i) {
+    if (!util::parseUIntNoThrow(counts[i], items[i])) {
+      return false;
+    }
+    total += counts[i];
+  }
+  counts_ = counts;
+  total_ = total;
+  return true;
+}
+
 ServerStat::ServerStat(const std::string& hostname, const std::string& protocol)
     : hostname_(hostname),
       protocol_(protocol),
@@ -57,7 +145,9 @@ ServerStat::ServerStat(const std::string& hostname, const std::string& protocol)
       singleConnectionAvgSpeed_(0),
       multiConnectionAvgSpeed_(0),
       counter_(0),
-      status_(OK)
+      status_(OK),
+      throughputEwma_(0),
+      errorRate_(0)
 {
 }
 
@@ -75,10 +165,53 @@ void ServerStat::updateDownloadSpeed(int downloadSpeed)
   downloadSpeed_ = downloadSpeed;
   if (downloadSpeed > 0) {
     status_ = OK;
+    if (throughputEwma_ == 0) {
+      throughputEwma_ = downloadSpeed;
+    }
+    else {
+      throughputEwma_ = static_cast<int>(EWMA_ALPHA * downloadSpeed +
+                                         (1 - EWMA_ALPHA) * throughputEwma_);
+    }
+    errorRate_ *= 1 - EWMA_ALPHA;
   }
   lastUpdated_.reset();
 }
 
+void ServerStat::setThroughputEwma(int speed) { throughputEwma_ = speed; }
+
+void ServerStat::setErrorRate(double rate)
+{
+  errorRate_ = std::max(0.0, std::min(1.0, rate));
+}
+
+void ServerStat::setConnectTime(const LatencySketch& sketch)
+{
+  connectTime_ = sketch;
+}
+
+void ServerStat::addConnectTime(const std::chrono::milliseconds& t)
+{
+  connectTime_.add(t);
+}
+
+void ServerStat::setTTFB(const LatencySketch& sketch) { ttfb_ = sketch; }
+
+void ServerStat::addTTFB(const std::chrono::milliseconds& t)
+{
+  ttfb_.add(t);
+}
+
+double ServerStat::getRecencyWeight(const Time& now) const
+{
+  auto age = lastUpdated_.difference(now);
+  if (age.count() <= 0) {
+    return 1;
+  }
+  return std::pow(0.5, std::chrono::duration<double>(age).count() /
+                           std::chrono::duration<double>(RECENCY_HALF_LIFE)
+                               .count());
+}
+
 void ServerStat::setSingleConnectionAvgSpeed(int singleConnectionAvgSpeed)
 {
   singleConnectionAvgSpeed_ = singleConnectionAvgSpeed;
@@ -166,7 +299,11 @@ void ServerStat::setStatusInternal(STATUS status)
 
 void ServerStat::setOK() { setStatusInternal(OK); }
 
-void ServerStat::setError() { setStatusInternal(A2_ERROR); }
+void ServerStat::setError()
+{
+  setStatusInternal(A2_ERROR);
+  errorRate_ = EWMA_ALPHA + (1 - EWMA_ALPHA) * errorRate_;
+}
 
 bool ServerStat::operator<(const ServerStat& serverStat) const
 {
@@ -182,13 +319,31 @@ bool ServerStat::operator==(const ServerStat& serverStat) const
 
 std::string ServerStat::toString() const
 {
-  return fmt("host=%s, protocol=%s, dl_speed=%d, sc_avg_speed=%d,"
-             " mc_avg_speed=%d, last_updated=%" PRId64
-             ", counter=%d, status=%s",
-             getHostname().c_str(), getProtocol().c_str(), getDownloadSpeed(),
-             getSingleConnectionAvgSpeed(), getMultiConnectionAvgSpeed(),
-             static_cast<int64_t>(getLastUpdated().getTimeFromEpoch()),
-             getCounter(), STATUS_STRING[getStatus()]);
+  // Fields added later are written only if they carry some data, so
+  // that lines for servers we have little knowledge about stay short.
+  auto res = fmt("host=%s, protocol=%s, dl_speed=%d, sc_avg_speed=%d,"
+                 " mc_avg_speed=%d, last_updated=%" PRId64
+                 ", counter=%d, status=%s",
+                 getHostname().c_str(), getProtocol().c_str(),
+                 getDownloadSpeed(), getSingleConnectionAvgSpeed(),
+                 getMultiConnectionAvgSpeed(),
+                 static_cast<int64_t>(getLastUpdated().getTimeFromEpoch()),
+                 getCounter(), STATUS_STRING[getStatus()]);
+  if (throughputEwma_ > 0) {
+    res += fmt(", ewma_speed=%d", throughputEwma_);
+  }
+  if (errorRate_ > 0) {
+    res += fmt(", error_rate=%.4f", errorRate_);
+  }
+  if (!connectTime_.empty()) {
+    res += ", connect_time=";
+    res += connectTime_.toString();
+  }
+  if (!ttfb_.empty()) {
+    res += ", ttfb=";
+    res += ttfb_.toString();
+  }
+  return res;
 }
 
 } // namespace aria2
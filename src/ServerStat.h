@@ -39,11 +39,48 @@
 #include <string>
 #include <iosfwd>
 #include <memory>
+#include <array>
+#include <chrono>
 
 #include "TimeA2.h"
 
 namespace aria2 {
 
+// Compact latency distribution.  Samples are counted in power-of-two
+// millisecond buckets: bucket 0 holds samples under 1ms and bucket i
+// holds [2^(i-1), 2^i) ms.  The last bucket also takes everything
+// longer.  Once the total count reaches AGE_THRESHOLD, all counts are
+// halved so that old samples fade out.
+class LatencySketch {
+public:
+  static constexpr size_t NUM_BUCKETS = 16;
+  static constexpr uint32_t AGE_THRESHOLD = 64;
+
+  LatencySketch();
+
+  void add(const std::chrono::milliseconds& t);
+
+  // Returns q-quantile (0 <= q <= 1) in milliseconds, interpolated
+  // linearly inside the bucket.  Returns 0 if there is no sample.
+  double percentile(double q) const;
+
+  uint32_t getCount() const { return total_; }
+
+  bool empty() const { return total_ == 0; }
+
+  // Returns counts joined with ':'. Trailing empty buckets are
+  // omitted.
+  std::string toString() const;
+
+  // Parses the string produced by toString().  Returns false if |s|
+  // is malformed, leaving this object unchanged.
+  bool parse(const std::string& s);
+
+private:
+  std::array<uint32_t, NUM_BUCKETS> counts_;
+  uint32_t total_;
+};
+
 // ServerStatMan: has many ServerStat
 // URISelector: interface
 // ServerStatURISelector: Has a reference of ServerStatMan
@@ -100,6 +137,40 @@ public:
 
   bool isOK() const { return status_ == OK; }
 
+  // Exponentially weighted moving average of download speed, updated
+  // by updateDownloadSpeed().
+  int getThroughputEwma() const { return throughputEwma_; }
+
+  void setThroughputEwma(int speed);
+
+  // Exponentially weighted moving average of failures: setError()
+  // pulls it towards 1, and successful downloads and responses pull
+  // it towards 0.
+  double getErrorRate() const { return errorRate_; }
+
+  void setErrorRate(double rate);
+
+  const LatencySketch& getConnectTime() const { return connectTime_; }
+
+  void setConnectTime(const LatencySketch& sketch);
+
+  // Records time taken to establish TCP connection.
+  void addConnectTime(const std::chrono::milliseconds& t);
+
+  // Time between sending a request and receiving the response
+  // header.
+  const LatencySketch& getTTFB() const { return ttfb_; }
+
+  void setTTFB(const LatencySketch& sketch);
+
+  // Records time to first byte.
+  void addTTFB(const std::chrono::milliseconds& t);
+
+  // Returns how much the statistics can be trusted at |now|, from 1
+  // for fresh ones down to 0 for ones not updated for a long time.
+  // The weight halves every 7 days.
+  double getRecencyWeight(const Time& now) const;
+
   // set status OK and update lastUpdated_
   void setOK();
 
@@ -131,6 +202,14 @@ private:
 
   Time lastUpdated_;
 
+  int throughputEwma_;
+
+  double errorRate_;
+
+  LatencySketch connectTime_;
+
+  LatencySketch ttfb_;
+
   void setStatusInternal(STATUS status);
 };
 
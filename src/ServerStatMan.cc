@@ -119,20 +119,25 @@ bool ServerStatMan::save(const std::string& filename) const
 namespace {
 // Field and FIELD_NAMES must have same order except for MAX_FIELD.
 enum Field {
+  S_CONNECT_TIME,
   S_COUNTER,
   S_DL_SPEED,
+  S_ERROR_RATE,
+  S_EWMA_SPEED,
   S_HOST,
   S_LAST_UPDATED,
   S_MC_AVG_SPEED,
   S_PROTOCOL,
   S_SC_AVG_SPEED,
   S_STATUS,
+  S_TTFB,
   MAX_FIELD
 };
 
 const char* FIELD_NAMES[] = {
-    "counter",      "dl_speed", "host",         "last_updated",
-    "mc_avg_speed", "protocol", "sc_avg_speed", "status",
+    "connect_time", "counter",      "dl_speed", "error_rate",
+    "ewma_speed",   "host",         "last_updated", "mc_avg_speed",
+    "protocol",     "sc_avg_speed", "status",   "ttfb",
 };
 } // namespace
 
@@ -219,6 +224,34 @@ bool ServerStatMan::load(const std::string& filename)
       }
       sstat->setCounter(uintval);
     }
+    // The following fields are omitted if there is no data.
+    if (!m[S_EWMA_SPEED].empty()) {
+      if (!util::parseUIntNoThrow(uintval, m[S_EWMA_SPEED])) {
+        continue;
+      }
+      sstat->setThroughputEwma(uintval);
+    }
+    if (!m[S_ERROR_RATE].empty()) {
+      double dblval;
+      if (!util::parseDoubleNoThrow(dblval, m[S_ERROR_RATE])) {
+        continue;
+      }
+      sstat->setErrorRate(dblval);
+    }
+    if (!m[S_CONNECT_TIME].empty()) {
+      LatencySketch sketch;
+      if (!sketch.parse(m[S_CONNECT_TIME])) {
+        continue;
+      }
+      sstat->setConnectTime(sketch);
+    }
+    if (!m[S_TTFB].empty()) {
+      LatencySketch sketch;
+      if (!sketch.parse(m[S_TTFB])) {
+        continue;
+      }
+      sstat->setTTFB(sketch);
+    }
     int32_t intval;
     if (!util::parseIntNoThrow(intval, m[S_LAST_UPDATED])) {
       continue;
@@ -132,67 +132,45 @@ ssize_t SocketBuffer::send()
   a2iovec iov[A2_IOV_MAX];
   size_t totalslen = 0;
   while (!bufq_.empty()) {
-    size_t num;
-    size_t bufqlen = bufq_.size();
-    ssize_t amount = 24_k;
-    ssize_t firstlen = bufq_.front()->getLength() - offset_;
-    amount -= firstlen;
-    iov[0].A2IOVEC_BASE = reinterpret_cast<char*>(
-        const_cast<unsigned char*>(bufq_.front()->getData() + offset_));
-    iov[0].A2IOVEC_LEN = firstlen;
-    num = 1;
-    for (auto i = std::begin(bufq_) + 1, eoi = std::end(bufq_);
-         i != eoi && num < A2_IOV_MAX && num < bufqlen && amount > 0;
-         ++i, ++num) {
-
-      ssize_t len = (*i)->getLength();
-
-      if (amount < len) {
-        break;
-      }
-
-      amount -= len;
-      iov[num].A2IOVEC_BASE =
-          reinterpret_cast<char*>(const_cast<unsigned char*>((*i)->getData()));
+    // Gather as many entries as possible into one writev() call.
+    // Kernel sends what fits in its buffer and we track where it
+    // stopped.
+    size_t num = 0;
+    size_t amount = 0;
+    for (auto i = std::begin(bufq_), eoi = std::end(bufq_);
+         i != eoi && num < A2_IOV_MAX; ++i, ++num) {
+      size_t offset = num == 0 ? offset_ : 0;
+      size_t len = (*i)->getLength() - offset;
+      iov[num].A2IOVEC_BASE = reinterpret_cast<char*>(
+          const_cast<unsigned char*>((*i)->getData() + offset));
       iov[num].A2IOVEC_LEN = len;
+      amount += len;
     }
     ssize_t slen = socket_->writeVector(iov, num);
     if (slen == 0 && !socket_->wantRead() && !socket_->wantWrite()) {
       throw DL_ABORT_EX(fmt(EX_SOCKET_SEND, "Connection closed."));
     }
-    // A2_LOG_NOTICE(fmt("num=%zu, amount=%d, bufq.size()=%zu, SEND=%d",
-    //                   num, amount, bufq_.size(), slen));
     totalslen += slen;
 
-    if (firstlen > slen) {
-      offset_ += slen;
-      bufq_.front()->progressUpdate(slen, false);
-      if (socket_->wantRead() || socket_->wantWrite()) {
-        goto fin;
-      }
-      continue;
-    }
-
-    slen -= firstlen;
-    bufq_.front()->progressUpdate(firstlen, true);
-    bufq_.pop_front();
-    offset_ = 0;
-
-    for (size_t i = 1; i < num; ++i) {
+    size_t rest = slen;
+    while (rest > 0) {
       auto& buf = bufq_.front();
-      ssize_t len = buf->getLength();
-      if (len > slen) {
-        offset_ = slen;
-        bufq_.front()->progressUpdate(slen, false);
-        goto fin;
+      size_t len = buf->getLength() - offset_;
+      if (len > rest) {
+        offset_ += rest;
+        buf->progressUpdate(rest, false);
+        break;
       }
-
-      slen -= len;
-      bufq_.front()->progressUpdate(len, true);
+      rest -= len;
+      buf->progressUpdate(len, true);
       bufq_.pop_front();
+      offset_ = 0;
+    }
+    if (static_cast<size_t>(slen) < amount) {
+      // Socket buffer is full.  Try again when it gets writable.
+      break;
     }
   }
-fin:
   return totalslen;
 }
 
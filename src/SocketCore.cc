@@ -48,6 +48,7 @@
 #include <cassert>
 #include <sstream>
 #include <array>
+#include <algorithm>
 
 #include "message.h"
 #include "DlRetryEx.h"
@@ -171,6 +172,10 @@ void SocketCore::init()
 
   wantRead_ = false;
   wantWrite_ = false;
+
+#ifdef ENABLE_SSL
+  tlsSessionPort_ = 0;
+#endif // ENABLE_SSL
 }
 
 SocketCore::~SocketCore() { closeConnection(); }
@@ -635,6 +640,11 @@ void SocketCore::closeConnection()
 {
 #ifdef ENABLE_SSL
   if (tlsSession_) {
+    if (secure_ == A2_TLS_CONNECTED) {
+      // With TLSv1.3, the ticket to resume the session may have
+      // arrived after handshake.
+      storeTLSSession();
+    }
     tlsSession_->closeConnection();
     tlsSession_.reset();
   }
@@ -783,14 +793,46 @@ ssize_t SocketCore::writeVector(a2iovec* iov, size_t iovcnt)
     }
   }
   else {
-    // For SSL/TLS, we could not use writev, so just iterate vector
-    // and write the data in normal way.
-    for (size_t i = 0; i < iovcnt; ++i) {
-      ssize_t rv = writeData(iov[i].A2IOVEC_BASE, iov[i].A2IOVEC_LEN);
+    // For SSL/TLS, we could not use writev.  Small buffers are copied
+    // into one buffer, so that they are sent in one TLS record instead
+    // of one record each.  Large buffers are written as they are.
+    // After a short write, the retry starts with the same bytes, which
+    // TLS libraries require.
+    unsigned char buf[16_k];
+    size_t i = 0;
+    size_t offset = 0;
+    while (i < iovcnt) {
+      auto data =
+          reinterpret_cast<const unsigned char*>(iov[i].A2IOVEC_BASE) + offset;
+      size_t len = iov[i].A2IOVEC_LEN - offset;
+      if (len < sizeof(buf) && i + 1 < iovcnt) {
+        memcpy(buf, data, len);
+        for (size_t j = i + 1; j < iovcnt && len < sizeof(buf); ++j) {
+          size_t n = std::min(sizeof(buf) - len,
+                              static_cast<size_t>(iov[j].A2IOVEC_LEN));
+          memcpy(buf + len, iov[j].A2IOVEC_BASE, n);
+          len += n;
+        }
+        data = buf;
+      }
+      ssize_t rv = writeData(data, len);
       if (rv == 0) {
         break;
       }
       ret += rv;
+      if (static_cast<size_t>(rv) < len) {
+        break;
+      }
+      while (len > 0) {
+        size_t rest = iov[i].A2IOVEC_LEN - offset;
+        if (len < rest) {
+          offset += len;
+          break;
+        }
+        len -= rest;
+        ++i;
+        offset = 0;
+      }
     }
   }
   return ret;
@@ -903,15 +945,25 @@ void SocketCore::readData(void* data, size_t& len)
 
 bool SocketCore::tlsAccept()
 {
-  return tlsHandshake(svTlsContext_.get(), A2STR::NIL);
+  return tlsHandshake(svTlsContext_.get(), A2STR::NIL, 0);
 }
 
-bool SocketCore::tlsConnect(const std::string& hostname)
+bool SocketCore::tlsConnect(const std::string& hostname, uint16_t port)
 {
-  return tlsHandshake(clTlsContext_.get(), hostname);
+  return tlsHandshake(clTlsContext_.get(), hostname, port);
 }
 
-bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
+void SocketCore::storeTLSSession()
+{
+  if (tlsSessionPort_ == 0 || !clTlsContext_) {
+    return;
+  }
+  clTlsContext_->getSessionCache().put(tlsSessionHost_, tlsSessionPort_,
+                                       tlsSession_->getSessionData());
+}
+
+bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname,
+                              uint16_t port)
 {
   wantRead_ = false;
   wantWrite_ = false;
@@ -941,6 +993,18 @@ bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
                               tlsSession_->getLastErrorString().c_str()));
       }
     }
+    if (tlsctx->getSide() == TLS_CLIENT) {
+      tlsSessionHost_ = hostname;
+      tlsSessionPort_ = port;
+      auto& sessionCache = tlsctx->getSessionCache();
+      const auto& data = sessionCache.find(tlsSessionHost_, tlsSessionPort_);
+      if (!data.empty() && tlsSession_->setSessionData(data) != TLS_ERR_OK) {
+        A2_LOG_DEBUG(fmt("Discarding unusable TLS session for %s: %s",
+                         tlsSessionHost_.c_str(),
+                         tlsSession_->getLastErrorString().c_str()));
+        sessionCache.remove(tlsSessionHost_, tlsSessionPort_);
+      }
+    }
     // Done with the setup, now let handshaking begin immediately.
     secure_ = A2_TLS_HANDSHAKING;
     A2_LOG_DEBUG("TLS Handshaking");
@@ -990,11 +1054,25 @@ bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
 
       auto peerInfo = ss.str();
 
-      A2_LOG_DEBUG(fmt("Securely connected to %s with %s", peerInfo.c_str(),
-                       tlsVersion.c_str()));
+      bool resumed = false;
+      if (tlsctx->getSide() == TLS_CLIENT) {
+        resumed = tlsSession_->isResumed();
+        tlsctx->getSessionCache().countHandshake(resumed);
+        if (!resumed) {
+          // This is a new session.  Drop the entry of an older one,
+          // so that the new session gets its own lifetime.
+          tlsctx->getSessionCache().remove(tlsSessionHost_, tlsSessionPort_);
+        }
+      }
+
+      A2_LOG_DEBUG(fmt("Securely connected to %s with %s%s", peerInfo.c_str(),
+                       tlsVersion.c_str(), resumed ? ", session resumed" : ""));
 
       // 2. We're connected now!
       secure_ = A2_TLS_CONNECTED;
+      if (tlsctx->getSide() == TLS_CLIENT) {
+        storeTLSSession();
+      }
       return true;
     }
 
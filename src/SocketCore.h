@@ -93,13 +93,23 @@ private:
 
   std::shared_ptr<TLSSession> tlsSession_;
 
+  // The origin server name and port under which the client side TLS
+  // session is stored in the session cache of clTlsContext_.  The
+  // port is 0 unless this is a client side TLS connection.
+  std::string tlsSessionHost_;
+  uint16_t tlsSessionPort_;
+
+  // Stores the current client side TLS session in the session cache.
+  void storeTLSSession();
+
   /**
    * Makes this socket secure. The connection must be established
    * before calling this method.
    *
    * If you are going to verify peer's certificate, hostname must be supplied.
    */
-  bool tlsHandshake(TLSContext* tlsctx, const std::string& hostname);
+  bool tlsHandshake(TLSContext* tlsctx, const std::string& hostname,
+                    uint16_t port);
 #endif // ENABLE_SSL
 
 #ifdef HAVE_LIBSSH2
@@ -294,8 +304,10 @@ public:
   // returns true. If handshake has not been done yet, returns false.
   //
   // If you are going to verify peer's certificate, hostname must be
-  // supplied.
-  bool tlsConnect(const std::string& hostname);
+  // supplied.  The session is cached under |hostname| and |port| of
+  // the origin server, which differ from the peer when tunneling
+  // through a proxy.
+  bool tlsConnect(const std::string& hostname, uint16_t port);
 #endif // ENABLE_SSL
 
 #ifdef HAVE_LIBSSH2
@@ -347,6 +359,11 @@ public:
   setClientTLSContext(const std::shared_ptr<TLSContext>& tlsContext);
   static void
   setServerTLSContext(const std::shared_ptr<TLSContext>& tlsContext);
+
+  static const std::shared_ptr<TLSContext>& getClientTLSContext()
+  {
+    return clTlsContext_;
+  }
 #endif // ENABLE_SSL
 
   static void setProtocolFamily(int protocolFamily)
@@ -0,0 +1,184 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "SocketPool.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "SocketCore.h"
+#include "wallclock.h"
+#include "LogFactory.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+SocketPoolKey::SocketPoolKey(const std::string& host, uint16_t port,
+                             const std::string& username,
+                             const std::string& proxyHost, uint16_t proxyPort)
+    : host(host),
+      port(port),
+      username(username),
+      proxyHost(proxyHost),
+      proxyPort(proxyPort)
+{
+}
+
+bool SocketPoolKey::operator==(const SocketPoolKey& key) const
+{
+  return port == key.port && proxyPort == key.proxyPort && host == key.host &&
+         username == key.username && proxyHost == key.proxyHost;
+}
+
+bool SocketPoolKey::operator<(const SocketPoolKey& key) const
+{
+  return std::tie(host, port, username, proxyHost, proxyPort) <
+         std::tie(key.host, key.port, key.username, key.proxyHost,
+                  key.proxyPort);
+}
+
+SocketPool::SocketPool(size_t maxSize, size_t maxSizePerHost)
+    : maxSize_(maxSize), maxSizePerHost_(maxSizePerHost)
+{
+}
+
+SocketPool::~SocketPool() = default;
+
+void SocketPool::setMaxSize(size_t maxSize) { maxSize_ = maxSize; }
+
+void SocketPool::setMaxSizePerHost(size_t maxSizePerHost)
+{
+  maxSizePerHost_ = maxSizePerHost;
+}
+
+void SocketPool::add(const SocketPoolKey& key,
+                     const std::shared_ptr<SocketCore>& socket,
+                     const std::string& options, std::chrono::seconds timeout)
+{
+  if (maxSize_ == 0 || maxSizePerHost_ == 0) {
+    return;
+  }
+  A2_LOG_INFO(fmt("Pool socket for %s(%u)", key.host.c_str(), key.port));
+  auto host = hosts_.find(key);
+  if (host != hosts_.end() && host->second.size() >= maxSizePerHost_) {
+    A2_LOG_DEBUG(fmt("Too many pooled sockets for %s(%u). Closing the oldest"
+                     " one.",
+                     key.host.c_str(), key.port));
+    ++stat_.evictions;
+    erase(host->second.front());
+  }
+  if (entries_.size() >= maxSize_) {
+    A2_LOG_DEBUG("Socket pool is full. Closing the oldest socket.");
+    ++stat_.evictions;
+    erase(entries_.begin());
+  }
+  host = hosts_.insert(HostIndex::value_type(key, HostIndex::mapped_type()))
+             .first;
+  Timer expiry = global::wallclock();
+  expiry.advance(timeout);
+  entries_.push_back(Entry());
+  auto i = std::prev(entries_.end());
+  i->socket = socket;
+  i->options = options;
+  i->host = host;
+  i->expiry = expiries_.insert(ExpiryIndex::value_type(expiry, i));
+  host->second.push_back(i);
+}
+
+std::shared_ptr<SocketCore> SocketPool::pop(std::string& options,
+                                            const SocketPoolKey& key)
+{
+  std::shared_ptr<SocketCore> socket;
+  auto host = hosts_.find(key);
+  if (host != hosts_.end()) {
+    auto& v = host->second;
+    // Prefer the most recently pooled connection, which is the least
+    // likely to have been closed by the peer.
+    while (!v.empty()) {
+      auto i = v.back();
+      // We assume that if socket is readable it means peer shutdowns
+      // connection and the socket will receive EOF. So skip it.
+      if ((*i).expiry->first <= global::wallclock() ||
+          (*i).socket->isReadable(0)) {
+        ++stat_.timeouts;
+        // The last erase() may remove host from hosts_.
+        bool last = v.size() == 1;
+        erase(i);
+        if (last) {
+          break;
+        }
+        continue;
+      }
+      A2_LOG_INFO(fmt("Found socket for %s(%u)", key.host.c_str(), key.port));
+      socket = (*i).socket;
+      options = (*i).options;
+      erase(i);
+      break;
+    }
+  }
+  if (socket) {
+    ++stat_.hits;
+  }
+  else {
+    ++stat_.misses;
+  }
+  return socket;
+}
+
+void SocketPool::evictExpired()
+{
+  size_t n = 0;
+  while (!expiries_.empty() &&
+         expiries_.begin()->first <= global::wallclock()) {
+    erase(expiries_.begin()->second);
+    ++n;
+  }
+  stat_.timeouts += n;
+  A2_LOG_DEBUG(fmt("%lu timed out pooled sockets removed.",
+                   static_cast<unsigned long>(n)));
+}
+
+void SocketPool::erase(EntryList::iterator i)
+{
+  auto host = (*i).host;
+  auto& v = host->second;
+  v.erase(std::find(v.begin(), v.end(), i));
+  if (v.empty()) {
+    hosts_.erase(host);
+  }
+  expiries_.erase((*i).expiry);
+  entries_.erase(i);
+}
+
+} // namespace aria2
@@ -0,0 +1,154 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_SOCKET_POOL_H
+#define D_SOCKET_POOL_H
+
+#include "common.h"
+
+#include <string>
+#include <memory>
+#include <list>
+#include <deque>
+#include <map>
+#include <chrono>
+
+#include "TimerA2.h"
+
+namespace aria2 {
+
+class SocketCore;
+
+// Identifies connections which can be used interchangeably.  host is
+// the IP address of the peer, or the hostname of the origin server
+// if the connection goes through proxy.
+struct SocketPoolKey {
+  std::string host;
+  uint16_t port;
+  std::string username;
+  std::string proxyHost;
+  uint16_t proxyPort;
+
+  SocketPoolKey(const std::string& host, uint16_t port,
+                const std::string& username, const std::string& proxyHost,
+                uint16_t proxyPort);
+
+  bool operator==(const SocketPoolKey& key) const;
+
+  bool operator<(const SocketPoolKey& key) const;
+};
+
+struct SocketPoolStat {
+  SocketPoolStat() : hits(0), misses(0), timeouts(0), evictions(0) {}
+
+  // The number of lookups which found a reusable connection.
+  int64_t hits;
+  // The number of lookups which found none.
+  int64_t misses;
+  // The number of connections closed because they timed out or were
+  // closed by the peer.
+  int64_t timeouts;
+  // The number of connections closed to keep the pool within its
+  // limits.
+  int64_t evictions;
+};
+
+// Keeps idle connections for reuse.  The number of connections is
+// bounded per key and in total.  When either bound is exceeded, the
+// least recently pooled connection is closed.
+class SocketPool {
+public:
+  static const size_t DEFAULT_MAX_SIZE = 128;
+  static const size_t DEFAULT_MAX_SIZE_PER_HOST = 16;
+
+  SocketPool(size_t maxSize = DEFAULT_MAX_SIZE,
+             size_t maxSizePerHost = DEFAULT_MAX_SIZE_PER_HOST);
+  ~SocketPool();
+
+  void setMaxSize(size_t maxSize);
+
+  void setMaxSizePerHost(size_t maxSizePerHost);
+
+  // Pools |socket| for |timeout|.  |options| is a protocol specific
+  // string returned by pop().
+  void add(const SocketPoolKey& key, const std::shared_ptr<SocketCore>& socket,
+           const std::string& options, std::chrono::seconds timeout);
+
+  // Removes the most recently pooled connection for |key| and returns
+  // it, storing its options in |options|.  Connections which have
+  // timed out or have been shut down by the peer are closed along the
+  // way.  Returns nullptr if no usable connection is found.
+  std::shared_ptr<SocketCore> pop(std::string& options,
+                                  const SocketPoolKey& key);
+
+  // Closes connections which have timed out.  This does not look at
+  // the connections which have not.
+  void evictExpired();
+
+  size_t size() const { return entries_.size(); }
+
+  const SocketPoolStat& getStat() const { return stat_; }
+
+private:
+  struct Entry;
+
+  typedef std::list<Entry> EntryList;
+  typedef std::multimap<Timer, EntryList::iterator> ExpiryIndex;
+  // Entries keep iterators into it, so it must not invalidate them
+  // on insertion.
+  typedef std::map<SocketPoolKey, std::deque<EntryList::iterator>> HostIndex;
+
+  struct Entry {
+    std::shared_ptr<SocketCore> socket;
+    std::string options;
+    HostIndex::iterator host;
+    ExpiryIndex::iterator expiry;
+  };
+
+  // All connections, the least recently pooled one first.
+  EntryList entries_;
+  // Connections for each key, the least recently pooled one first.
+  HostIndex hosts_;
+  // Connections ordered by the time they expire at.
+  ExpiryIndex expiries_;
+  size_t maxSize_;
+  size_t maxSizePerHost_;
+  SocketPoolStat stat_;
+
+  void erase(EntryList::iterator i);
+};
+
+} // namespace aria2
+
+#endif // D_SOCKET_POOL_H
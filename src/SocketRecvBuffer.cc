@@ -36,29 +36,113 @@
 
 #include <cstring>
 #include <cassert>
+#include <algorithm>
 
 #include "SocketCore.h"
 #include "LogFactory.h"
+#include "a2functional.h"
 
 namespace aria2 {
 
+const size_t SocketRecvBuffer::MIN_CAPACITY = 16_k;
+
+const size_t SocketRecvBuffer::MAX_CAPACITY = 1_m;
+
+const int SocketRecvBuffer::SHRINK_ROUNDS = 16;
+
+size_t SocketRecvBuffer::defaultCapacity_ = SocketRecvBuffer::MIN_CAPACITY;
+
+size_t SocketRecvBuffer::memoryLimit_ = 64_m;
+
+size_t SocketRecvBuffer::totalCapacity_ = 0;
+
 SocketRecvBuffer::SocketRecvBuffer(std::shared_ptr<SocketCore> socket)
-    : socket_(std::move(socket)), pos_(buf_.data()), last_(pos_)
+    : SocketRecvBuffer(std::move(socket), defaultCapacity_)
 {
+  growable_ = true;
 }
 
-SocketRecvBuffer::~SocketRecvBuffer() = default;
+SocketRecvBuffer::SocketRecvBuffer(std::shared_ptr<SocketCore> socket,
+                                   size_t capacity)
+    : capacity_(std::max(capacity, MIN_CAPACITY)),
+      initialCapacity_(capacity_),
+      growable_(false),
+      idleRounds_(0),
+      buf_(new unsigned char[capacity_]),
+      socket_(std::move(socket)),
+      pos_(buf_.get()),
+      last_(pos_)
+{
+  totalCapacity_ += capacity_;
+}
+
+SocketRecvBuffer::~SocketRecvBuffer() { totalCapacity_ -= capacity_; }
 
 ssize_t SocketRecvBuffer::recv()
 {
-  size_t n = std::end(buf_) - last_;
-  if (n == 0) {
+  if (idleRounds_ >= SHRINK_ROUNDS) {
+    idleRounds_ = 0;
+    if (capacity_ > initialCapacity_ && getBufferLength() <= capacity_ / 2) {
+      resize(std::max(initialCapacity_, capacity_ / 2));
+    }
+  }
+  size_t total = 0;
+  for (;;) {
+    if (last_ == buf_.get() + capacity_) {
+      if (pos_ != buf_.get()) {
+        // Move unread data to the beginning of the buffer to make
+        // room for incoming data.
+        auto len = last_ - pos_;
+        memmove(buf_.get(), pos_, len);
+        pos_ = buf_.get();
+        last_ = pos_ + len;
+      }
+      else if (total == 0 || !growable_ || capacity_ >= MAX_CAPACITY ||
+               !resize(std::min(capacity_ * 2, MAX_CAPACITY))) {
+        // Unless this call has just filled the buffer, the caller
+        // has not consumed buffered data.  Don't grow for it.
+        break;
+      }
+    }
+    size_t len = buf_.get() + capacity_ - last_;
+    size_t n = len;
+    socket_->readData(last_, n);
+    last_ += n;
+    total += n;
+    if (n < len) {
+      break;
+    }
+  }
+  if (total == 0 && last_ == buf_.get() + capacity_) {
     A2_LOG_DEBUG("Buffer full");
-    return 0;
   }
-  socket_->readData(last_, n);
-  last_ += n;
-  return n;
+  if (growable_) {
+    if (total < capacity_ / 4) {
+      ++idleRounds_;
+    }
+    else {
+      idleRounds_ = 0;
+    }
+  }
+  return total;
+}
+
+bool SocketRecvBuffer::resize(size_t capacity)
+{
+  if (capacity > capacity_ &&
+      totalCapacity_ + (capacity - capacity_) > memoryLimit_) {
+    return false;
+  }
+  auto len = getBufferLength();
+  assert(len <= capacity);
+  std::unique_ptr<unsigned char[]> buf(new unsigned char[capacity]);
+  memcpy(buf.get(), pos_, len);
+  buf_ = std::move(buf);
+  totalCapacity_ = totalCapacity_ - capacity_ + capacity;
+  capacity_ = capacity;
+  pos_ = buf_.get();
+  last_ = pos_ + len;
+  return true;
 }
 
 void SocketRecvBuffer::drain(size_t n)
@@ -70,6 +154,19 @@ void SocketRecvBuffer::drain(size_t n)
   }
 }
 
-void SocketRecvBuffer::truncateBuffer() { pos_ = last_ = buf_.data(); }
+void SocketRecvBuffer::truncateBuffer() { pos_ = last_ = buf_.get(); }
+
+void SocketRecvBuffer::setDefaultCapacity(size_t capacity)
+{
+  defaultCapacity_ = std::max(capacity, MIN_CAPACITY);
+}
+
+size_t SocketRecvBuffer::getDefaultCapacity() { return defaultCapacity_; }
+
+void SocketRecvBuffer::setMemoryLimit(size_t limit) { memoryLimit_ = limit; }
+
+size_t SocketRecvBuffer::getMemoryLimit() { return memoryLimit_; }
+
+size_t SocketRecvBuffer::getTotalCapacity() { return totalCapacity_; }
 
 } // namespace aria2
@@ -38,9 +38,6 @@
 #include "common.h"
 
 #include <memory>
-#include <array>
-
-#include "a2functional.h"
 
 namespace aria2 {
 
@@ -48,10 +45,19 @@ class SocketCore;
 
 class SocketRecvBuffer {
 public:
+  // Creates buffer with the capacity given by setDefaultCapacity().
+  // The buffer grows while the socket keeps filling it, up to
+  // MAX_CAPACITY, and shrinks back when the connection slows down.
   SocketRecvBuffer(std::shared_ptr<SocketCore> socket);
+  // Creates buffer with the fixed capacity.
+  SocketRecvBuffer(std::shared_ptr<SocketCore> socket, size_t capacity);
   ~SocketRecvBuffer();
   // Reads data from socket as much as capacity allows. Returns the
-  // number of bytes read.
+  // number of bytes read.  If there is no room left at the end of
+  // buffer, buffered data is moved to the beginning of the buffer
+  // first.  If a read fills the buffer and the buffer can grow, it is
+  // enlarged and the socket is read again, until the socket has no
+  // more data or the buffer cannot grow any more.
   ssize_t recv();
   // Truncates the contents of buffer to 0.
   void truncateBuffer();
@@ -68,8 +74,46 @@ public:
 
   bool bufferEmpty() const { return pos_ == last_; }
 
+  size_t getCapacity() const { return capacity_; }
+
+  // Sets the capacity of buffers created after this call.
+  static void setDefaultCapacity(size_t capacity);
+
+  static size_t getDefaultCapacity();
+
+  // Sets the upper limit of the total capacity of all buffers.  A
+  // buffer does not grow if it would exceed this limit.  Buffers are
+  // always created with their initial capacity regardless of it.
+  static void setMemoryLimit(size_t limit);
+
+  static size_t getMemoryLimit();
+
+  // Returns the sum of the capacity of all buffers.
+  static size_t getTotalCapacity();
+
+  static const size_t MIN_CAPACITY;
+
+  static const size_t MAX_CAPACITY;
+
+  // The number of consecutive recv() calls which use less than a
+  // quarter of the capacity before the buffer is halved.
+  static const int SHRINK_ROUNDS;
+
 private:
-  std::array<unsigned char, 16_k> buf_;
+  // Reallocates buffer with the given capacity, keeping buffered
+  // data.  Returns false if the memory limit does not allow it.
+  bool resize(size_t capacity);
+
+  static size_t defaultCapacity_;
+  static size_t memoryLimit_;
+  static size_t totalCapacity_;
+
+  size_t capacity_;
+  // The capacity the buffer shrinks back to.
+  size_t initialCapacity_;
+  bool growable_;
+  int idleRounds_;
+  std::unique_ptr<unsigned char[]> buf_;
   std::shared_ptr<SocketCore> socket_;
   unsigned char* pos_;
   unsigned char* last_;
@@ -47,6 +47,9 @@
 #include "PieceStorage.h"
 #include "DiskAdaptor.h"
 #include "LogFactory.h"
+#include "ConnectionScaler.h"
+#include "ConnectionScalingCommand.h"
+#include "a2functional.h"
 
 namespace aria2 {
 
@@ -75,6 +78,17 @@ void StreamFileAllocationEntry::prepareForNextAction(
       diskAdaptor->size() <= option->getAsLLInt(PREF_MAX_MMAP_LIMIT)) {
     diskAdaptor->enableMmap();
   }
+  if (option->getAsBool(PREF_ADAPTIVE_SPLIT) && rg->getTotalLength() > 0 &&
+      !rg->getConnectionScaler()) {
+    // Start with a few connections, and let ConnectionScalingCommand
+    // add more.  --split is the upper bound.
+    auto scaler =
+        make_unique<ConnectionScaler>(1, option->getAsInt(PREF_SPLIT));
+    rg->setNumConcurrentCommand(scaler->getTarget());
+    rg->setConnectionScaler(std::move(scaler));
+    commands.push_back(make_unique<ConnectionScalingCommand>(
+        e->newCUID(), rg, e, std::chrono::seconds(3)));
+  }
   if (getNextCommand()) {
     // Reset download start time of PeerStat because it is started
     // before file allocation begins.
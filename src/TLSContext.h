@@ -39,6 +39,8 @@
 
 #include "common.h"
 
+#include "TLSSessionCache.h"
+
 namespace aria2 {
 
 enum TLSSessionSide { TLS_CLIENT, TLS_SERVER };
@@ -69,6 +71,13 @@ public:
   virtual TLSSessionSide getSide() const = 0;
   virtual bool getVerifyPeer() const = 0;
   virtual void setVerifyPeer(bool) = 0;
+
+  // Client side sessions established with this context, kept for
+  // resumption.
+  TLSSessionCache& getSessionCache() { return sessionCache_; }
+
+private:
+  TLSSessionCache sessionCache_;
 };
 
 } // namespace aria2
@@ -36,6 +36,9 @@
 #define TLS_SESSION_H
 
 #include "common.h"
+
+#include <string>
+
 #include "a2netcompat.h"
 #include "TLSContext.h"
 
@@ -68,6 +71,23 @@ public:
   // succeeds, or TLS_ERR_ERROR.
   virtual int setSNIHostname(const std::string& hostname) = 0;
 
+  // Sets |data|, which getSessionData() returned for the earlier
+  // session with the same server, so that handshake resumes that
+  // session.  This is only meaningful for client side session and
+  // must be called before tlsConnect().  Backends which lack session
+  // resumption ignore |data|.  If the server declines to resume,
+  // handshake falls back to full one.  This function returns
+  // TLS_ERR_OK if it succeeds, or TLS_ERR_ERROR.
+  virtual int setSessionData(const std::string& data) = 0;
+
+  // Returns the serialized parameters of this session which can be
+  // given to setSessionData() later, or empty string if they are not
+  // available.
+  virtual std::string getSessionData() = 0;
+
+  // Returns true if handshake resumed the earlier session.
+  virtual bool isResumed() = 0;
+
   // Closes the SSL/TLS session. Don't close underlying transport
   // socket. This function returns TLS_ERR_OK if it succeeds, or
   // TLS_ERR_ERROR.
@@ -0,0 +1,124 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "TLSSessionCache.h"
+#include "A2STR.h"
+#include "wallclock.h"
+
+namespace aria2 {
+
+TLSSessionCache::TLSSessionCache(size_t maxSize, std::chrono::seconds timeout)
+    : maxSize_(maxSize),
+      timeout_(std::move(timeout)),
+      accessCounter_(0),
+      fullHandshakes_(0),
+      resumedHandshakes_(0)
+{
+}
+
+void TLSSessionCache::put(const std::string& hostname, uint16_t port,
+                          const std::string& data)
+{
+  if (data.empty() || maxSize_ == 0) {
+    return;
+  }
+  auto key = std::make_pair(hostname, port);
+  auto i = entries_.find(key);
+  if (i == entries_.end()) {
+    evict();
+    i = entries_.insert(EntryMap::value_type(key, Entry())).first;
+    (*i).second.expiry = global::wallclock();
+    (*i).second.expiry.advance(timeout_);
+  }
+  auto& entry = (*i).second;
+  entry.data = data;
+  entry.lastAccess = ++accessCounter_;
+}
+
+const std::string& TLSSessionCache::find(const std::string& hostname,
+                                         uint16_t port)
+{
+  auto i = entries_.find(std::make_pair(hostname, port));
+  if (i == entries_.end()) {
+    return A2STR::NIL;
+  }
+  if ((*i).second.expiry < global::wallclock()) {
+    entries_.erase(i);
+    return A2STR::NIL;
+  }
+  (*i).second.lastAccess = ++accessCounter_;
+  return (*i).second.data;
+}
+
+void TLSSessionCache::remove(const std::string& hostname, uint16_t port)
+{
+  entries_.erase(std::make_pair(hostname, port));
+}
+
+void TLSSessionCache::countHandshake(bool resumed)
+{
+  if (resumed) {
+    ++resumedHandshakes_;
+  }
+  else {
+    ++fullHandshakes_;
+  }
+}
+
+void TLSSessionCache::evict()
+{
+  if (entries_.size() < maxSize_) {
+    return;
+  }
+  for (auto i = entries_.begin(); i != entries_.end();) {
+    if ((*i).second.expiry < global::wallclock()) {
+      i = entries_.erase(i);
+    }
+    else {
+      ++i;
+    }
+  }
+  if (entries_.size() < maxSize_) {
+    return;
+  }
+  auto lru = entries_.begin();
+  for (auto i = entries_.begin(), eoi = entries_.end(); i != eoi; ++i) {
+    if ((*i).second.lastAccess < (*lru).second.lastAccess) {
+      lru = i;
+    }
+  }
+  entries_.erase(lru);
+}
+
+} // namespace aria2
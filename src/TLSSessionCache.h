@@ -0,0 +1,104 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_TLS_SESSION_CACHE_H
+#define D_TLS_SESSION_CACHE_H
+
+#include "common.h"
+
+#include <string>
+#include <map>
+#include <chrono>
+
+#include "TimerA2.h"
+
+namespace aria2 {
+
+// Remembers serialized TLS sessions per server so that the next
+// connection to the same server can resume the session with
+// abbreviated handshake.  The number of sessions is bounded, and each
+// of them expires after a fixed period.
+class TLSSessionCache {
+public:
+  static const size_t DEFAULT_MAX_SIZE = 256;
+
+  TLSSessionCache(size_t maxSize = DEFAULT_MAX_SIZE,
+                  std::chrono::seconds timeout = std::chrono::seconds(600));
+
+  // Stores |data|, which is returned by TLSSession::getSessionData(),
+  // for |hostname| and |port|, replacing the older one.  Replacing
+  // does not extend the expiry set when the entry was first stored,
+  // so that a resumed session is not kept alive forever.
+  void put(const std::string& hostname, uint16_t port,
+           const std::string& data);
+
+  // Returns the session data stored for |hostname| and |port|, or
+  // empty string if it does not exist or has expired.
+  const std::string& find(const std::string& hostname, uint16_t port);
+
+  void remove(const std::string& hostname, uint16_t port);
+
+  size_t size() const { return entries_.size(); }
+
+  // Counts a completed client handshake.  |resumed| tells whether it
+  // resumed the earlier session.
+  void countHandshake(bool resumed);
+
+  int64_t getFullHandshakes() const { return fullHandshakes_; }
+
+  int64_t getResumedHandshakes() const { return resumedHandshakes_; }
+
+private:
+  struct Entry {
+    std::string data;
+    Timer expiry;
+    uint64_t lastAccess;
+  };
+
+  typedef std::map<std::pair<std::string, uint16_t>, Entry> EntryMap;
+  EntryMap entries_;
+  size_t maxSize_;
+  std::chrono::seconds timeout_;
+  uint64_t accessCounter_;
+  int64_t fullHandshakes_;
+  int64_t resumedHandshakes_;
+
+  // Removes expired entries, and then the least recently used one if
+  // the number of entries is still not less than maxSize_.
+  void evict();
+};
+
+} // namespace aria2
+
+#endif // D_TLS_SESSION_CACHE_H
@@ -0,0 +1,98 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "WakeupPipe.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "a2io.h"
+#include "DlAbortEx.h"
+#include "util.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+WakeupPipe::WakeupPipe() : notified_(false)
+{
+#ifndef __MINGW32__
+  if (pipe(fds_) == -1) {
+    int errNum = errno;
+    throw DL_ABORT_EX(fmt("Failed to create pipe: %s",
+                          util::safeStrerror(errNum).c_str()));
+  }
+  for (auto fd : fds_) {
+    util::make_fd_cloexec(fd);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  }
+#else  // __MINGW32__
+  // EventPoll on Windows only accepts sockets.
+  throw DL_ABORT_EX("Pipe is not supported.");
+#endif // __MINGW32__
+}
+
+WakeupPipe::~WakeupPipe()
+{
+#ifndef __MINGW32__
+  close(fds_[0]);
+  close(fds_[1]);
+#endif // !__MINGW32__
+}
+
+void WakeupPipe::notify()
+{
+#ifndef __MINGW32__
+  if (!notified_.exchange(true)) {
+    char c = 0;
+    while (write(fds_[1], &c, 1) == -1 && errno == EINTR)
+      ;
+  }
+#endif // !__MINGW32__
+}
+
+void WakeupPipe::drain()
+{
+#ifndef __MINGW32__
+  if (!notified_.exchange(false)) {
+    return;
+  }
+  char buf[64];
+  ssize_t n;
+  while ((n = read(fds_[0], buf, sizeof(buf))) > 0 ||
+         (n == -1 && errno == EINTR))
+    ;
+#endif // !__MINGW32__
+}
+
+} // namespace aria2
@@ -0,0 +1,80 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2013 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_WAKEUP_PIPE_H
+#define D_WAKEUP_PIPE_H
+
+#include "common.h"
+
+#include <atomic>
+
+#include "a2netcompat.h"
+
+namespace aria2 {
+
+// A pipe which worker threads write to in order to wake up the event
+// loop blocked in EventPoll.  The read end is registered to
+// EventPoll, and becomes readable after notify() until drain() is
+// called.
+class WakeupPipe {
+public:
+  // Throws DlAbortEx if the pipe cannot be created, which is always
+  // the case on Windows.
+  WakeupPipe();
+  ~WakeupPipe();
+
+  // Don't allow copying
+  WakeupPipe(const WakeupPipe&) = delete;
+  WakeupPipe& operator=(const WakeupPipe&) = delete;
+
+  // Makes the read end readable.  This function may be called from
+  // any thread.
+  void notify();
+
+  // Consumes the notifications.  The work notified before this call
+  // must be looked up after it.
+  void drain();
+
+  sock_t getReadFd() const { return fds_[0]; }
+
+private:
+  int fds_[2];
+  // true if a byte has been written and not read yet.  Avoids filling
+  // the pipe when many jobs complete at once.
+  std::atomic<bool> notified_;
+};
+
+} // namespace aria2
+
+#endif // D_WAKEUP_PIPE_H
@@ -166,6 +166,16 @@ int WinTLSSession::setSNIHostname(const std::string& hostname)
   return TLS_ERR_OK;
 }
 
+int WinTLSSession::setSessionData(const std::string& data)
+{
+  // Schannel caches sessions on its own.
+  return TLS_ERR_OK;
+}
+
+std::string WinTLSSession::getSessionData() { return ""; }
+
+bool WinTLSSession::isResumed() { return false; }
+
 int WinTLSSession::closeConnection()
 {
   if (state_ != st_connected && state_ != st_closing) {
@@ -42,7 +42,10 @@
 
 namespace aria2 {
 
-WrDiskCache::WrDiskCache(size_t limit) : limit_(limit), total_(0), clock_(0) {}
+WrDiskCache::WrDiskCache(size_t limit)
+    : limit_(limit), total_(0), nonEmptyBuckets_(0), clock_(0)
+{
+}
 
 WrDiskCache::~WrDiskCache()
 {
@@ -52,53 +55,95 @@ WrDiskCache::~WrDiskCache()
   }
 }
 
-bool WrDiskCache::add(WrDiskCacheEntry* ent)
+size_t WrDiskCache::getBucket(size_t size)
+{
+  size_t bucket = 0;
+  while (size >>= 1) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+void WrDiskCache::link(WrDiskCacheEntry* ent)
 {
   ent->setSizeKey(ent->getSize());
   ent->setLastUpdate(++clock_);
-  std::pair<EntrySet::iterator, bool> rv = set_.insert(ent);
-  if (rv.second) {
-    total_ += ent->getSize();
-    ensureLimit();
-    return true;
+  size_t b = getBucket(ent->getSizeKey());
+  buckets_[b].push_back(ent);
+  nonEmptyBuckets_ |= static_cast<size_t>(1) << b;
+  ent->setCachePos(--std::end(buckets_[b]));
+  ent->setCached(true);
+}
+
+void WrDiskCache::relink(WrDiskCacheEntry* ent)
+{
+  size_t from = getBucket(ent->getSizeKey());
+  ent->setSizeKey(ent->getSize());
+  ent->setLastUpdate(++clock_);
+  size_t to = getBucket(ent->getSizeKey());
+  // splice() keeps the iterator valid and does not allocate.
+  buckets_[to].splice(std::end(buckets_[to]), buckets_[from],
+                      ent->getCachePos());
+  if (buckets_[from].empty()) {
+    nonEmptyBuckets_ &= ~(static_cast<size_t>(1) << from);
+  }
+  nonEmptyBuckets_ |= static_cast<size_t>(1) << to;
+}
+
+void WrDiskCache::unlink(WrDiskCacheEntry* ent)
+{
+  size_t b = getBucket(ent->getSizeKey());
+  buckets_[b].erase(ent->getCachePos());
+  if (buckets_[b].empty()) {
+    nonEmptyBuckets_ &= ~(static_cast<size_t>(1) << b);
   }
-  else {
-    A2_LOG_WARN(fmt("Found duplicate cache entry a.{size=%lu,clock=%" PRId64
-                    "} b{size=%lu,clock=%" PRId64 "}",
-                    static_cast<unsigned long>((*rv.first)->getSize()),
-                    (*rv.first)->getLastUpdate(),
+  ent->setCached(false);
+}
+
+WrDiskCacheEntry* WrDiskCache::findVictim() const
+{
+  // Sizes differ by less than a factor of 2 in the largest bucket.
+  // Pick the least recently updated one of them, which is the front.
+  return buckets_[getBucket(nonEmptyBuckets_)].front();
+}
+
+bool WrDiskCache::add(WrDiskCacheEntry* ent)
+{
+  if (ent->isCached()) {
+    A2_LOG_WARN(fmt("Found duplicate cache entry size=%lu,clock=%" PRId64,
                     static_cast<unsigned long>(ent->getSize()),
                     ent->getLastUpdate()));
     return false;
   }
+  link(ent);
+  total_ += ent->getSize();
+  ensureLimit();
+  return true;
 }
 
 bool WrDiskCache::remove(WrDiskCacheEntry* ent)
 {
-  if (set_.erase(ent)) {
-    A2_LOG_DEBUG(fmt("Removed cache entry size=%lu, clock=%" PRId64,
-                     static_cast<unsigned long>(ent->getSize()),
-                     ent->getLastUpdate()));
-    total_ -= ent->getSize();
-    return true;
-  }
-  else {
+  if (!ent->isCached()) {
     return false;
   }
+  unlink(ent);
+  A2_LOG_DEBUG(fmt("Removed cache entry size=%lu, clock=%" PRId64,
+                   static_cast<unsigned long>(ent->getSize()),
+                   ent->getLastUpdate()));
+  total_ -= ent->getSize();
+  return true;
 }
 
 bool WrDiskCache::update(WrDiskCacheEntry* ent, ssize_t delta)
 {
-  if (!set_.erase(ent)) {
+  if (!ent->isCached()) {
     return false;
   }
   A2_LOG_DEBUG(fmt("Update cache entry size=%lu, delta=%ld, clock=%" PRId64,
                    static_cast<unsigned long>(ent->getSize()),
                    static_cast<long>(delta), ent->getLastUpdate()));
 
-  ent->setSizeKey(ent->getSize());
-  ent->setLastUpdate(++clock_);
-  set_.insert(ent);
+  relink(ent);
 
   if (delta < 0) {
     assert(total_ >= static_cast<size_t>(-delta));
@@ -111,18 +156,13 @@ bool WrDiskCache::update(WrDiskCacheEntry* ent, ssize_t delta)
 void WrDiskCache::ensureLimit()
 {
   while (total_ > limit_) {
-    auto i = set_.begin();
-    WrDiskCacheEntry* ent = *i;
+    WrDiskCacheEntry* ent = findVictim();
     A2_LOG_DEBUG(fmt("Force flush cache entry size=%lu, clock=%" PRId64,
                      static_cast<unsigned long>(ent->getSizeKey()),
                      ent->getLastUpdate()));
     total_ -= ent->getSize();
     ent->writeToDisk();
-    set_.erase(i);
-
-    ent->setSizeKey(ent->getSize());
-    ent->setLastUpdate(++clock_);
-    set_.insert(ent);
+    relink(ent);
   }
 }
 
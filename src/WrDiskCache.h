@@ -37,9 +37,8 @@
 
 #include "common.h"
 
-#include <set>
-
-#include "a2functional.h"
+#include <array>
+#include <list>
 
 namespace aria2 {
 
@@ -60,17 +59,35 @@ public:
   // negative value.
   bool update(WrDiskCacheEntry* ent, ssize_t delta);
   // Evicts entries from storage so that total size of cache is kept
-  // under the limit.
+  // under the limit.  Entries in the largest size class, whose sizes
+  // differ by less than a factor of 2, are evicted first, the least
+  // recently updated one first.
   void ensureLimit();
   size_t getSize() const { return total_; }
 
 private:
-  typedef std::set<WrDiskCacheEntry*, DerefLess<WrDiskCacheEntry*>> EntrySet;
+  typedef std::list<WrDiskCacheEntry*> EntryList;
+  // The entry whose size is in [2**i, 2**(i+1)) goes to bucket i.
+  // Empty entries go to bucket 0.
+  static const size_t NUM_BUCKETS = sizeof(size_t) * 8;
+  static size_t getBucket(size_t size);
+  // Appends |ent| to the bucket for its current size.
+  void link(WrDiskCacheEntry* ent);
+  // Moves |ent| to the end of the bucket for its current size.
+  void relink(WrDiskCacheEntry* ent);
+  void unlink(WrDiskCacheEntry* ent);
+  // Returns the entry to evict next in O(1).
+  WrDiskCacheEntry* findVictim() const;
+
   // Maximum number of bytes the storage can cache.
   size_t limit_;
   // Current number of bytes cached.
   size_t total_;
-  EntrySet set_;
+  // Each bucket is ordered by the last update, the least recent
+  // first.
+  std::array<EntryList, NUM_BUCKETS> buckets_;
+  // Bit i is set if bucket i is not empty.
+  size_t nonEmptyBuckets_;
   int64_t clock_;
 };
 
@@ -35,12 +35,14 @@
 #include "WrDiskCacheEntry.h"
 
 #include <cstring>
+#include <algorithm>
 
 #include "DiskAdaptor.h"
 #include "RecoverableException.h"
 #include "DownloadFailureException.h"
 #include "LogFactory.h"
 #include "fmt.h"
+#include "DiskIOEngine.h"
 
 namespace aria2 {
 
@@ -48,6 +50,7 @@ WrDiskCacheEntry::WrDiskCacheEntry(
     const std::shared_ptr<DiskAdaptor>& diskAdaptor)
     : sizeKey_(0),
       lastUpdate_(0),
+      cached_(false),
       size_(0),
       error_(CACHE_ERR_SUCCESS),
       errorCode_(error_code::UNDEFINED),
@@ -76,7 +79,30 @@ void WrDiskCacheEntry::deleteDataCells()
 
 void WrDiskCacheEntry::writeToDisk()
 {
+  if (!DiskIOEngine::getInstance()) {
+    try {
+      diskAdaptor_->writeCache(this);
+    }
+    catch (RecoverableException& e) {
+      A2_LOG_ERROR_EX("Error when trying to flush write cache", e);
+      error_ = CACHE_ERR_ERROR;
+      errorCode_ = e.getErrorCode();
+    }
+    deleteDataCells();
+    return;
+  }
+  // The data cells are handed over to the writes in flight and freed
+  // when the last of them completes.
+  auto cells = std::shared_ptr<DataCellSet>(new DataCellSet(set_),
+                                            [](DataCellSet* cells) {
+                                              for (auto& e : *cells) {
+                                                delete[] e->data;
+                                                delete e;
+                                              }
+                                              delete cells;
+                                            });
   try {
+    DiskIOEngine::BufferScope scope(cells);
     diskAdaptor_->writeCache(this);
   }
   catch (RecoverableException& e) {
@@ -84,7 +110,23 @@ void WrDiskCacheEntry::writeToDisk()
     error_ = CACHE_ERR_ERROR;
     errorCode_ = e.getErrorCode();
   }
-  deleteDataCells();
+  set_.clear();
+  size_ = 0;
+}
+
+void WrDiskCacheEntry::waitWrites()
+{
+  if (!DiskIOEngine::getInstance() || error_ != CACHE_ERR_SUCCESS) {
+    return;
+  }
+  try {
+    diskAdaptor_->drainWrites();
+  }
+  catch (RecoverableException& e) {
+    A2_LOG_ERROR_EX("Error when trying to flush write cache", e);
+    error_ = CACHE_ERR_ERROR;
+    errorCode_ = e.getErrorCode();
+  }
 }
 
 void WrDiskCacheEntry::clear() { deleteDataCells(); }
@@ -93,13 +135,17 @@ bool WrDiskCacheEntry::cacheData(DataCell* dataCell)
 {
   A2_LOG_DEBUG(fmt("WrDiskCacheEntry cache goff=%" PRId64 ", len=%lu",
                    dataCell->goff, static_cast<unsigned long>(dataCell->len)));
-  if (set_.insert(dataCell).second) {
-    size_ += dataCell->len;
-    return true;
-  }
-  else {
-    return false;
+  auto i = std::end(set_);
+  if (!set_.empty() && dataCell->goff <= set_.back()->goff) {
+    i = std::lower_bound(std::begin(set_), std::end(set_), dataCell,
+                         DerefLess<DataCell*>());
+    if ((*i)->goff == dataCell->goff) {
+      return false;
+    }
   }
+  set_.insert(i, dataCell);
+  size_ += dataCell->len;
+  return true;
 }
 
 size_t WrDiskCacheEntry::append(int64_t goff, const unsigned char* data,
@@ -108,12 +154,11 @@ size_t WrDiskCacheEntry::append(int64_t goff, const unsigned char* data,
   if (set_.empty()) {
     return 0;
   }
-  auto i = set_.end();
-  --i;
-  if (static_cast<int64_t>((*i)->goff + (*i)->len) == goff) {
-    size_t wlen = std::min((*i)->capacity - (*i)->len, len);
-    memcpy((*i)->data + (*i)->offset + (*i)->len, data, wlen);
-    (*i)->len += wlen;
+  auto& cell = set_.back();
+  if (static_cast<int64_t>(cell->goff + cell->len) == goff) {
+    size_t wlen = std::min(cell->capacity - cell->len, len);
+    memcpy(cell->data + cell->offset + cell->len, data, wlen);
+    cell->len += wlen;
     size_ += wlen;
     return wlen;
   }
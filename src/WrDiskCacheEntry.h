@@ -37,7 +37,8 @@
 
 #include "common.h"
 
-#include <set>
+#include <vector>
+#include <list>
 #include <memory>
 
 #include "a2functional.h"
@@ -63,13 +64,19 @@ public:
     bool operator<(const DataCell& rhs) const { return goff < rhs.goff; }
   };
 
-  typedef std::set<DataCell*, DerefLess<DataCell*>> DataCellSet;
+  // Sorted by goff.  Cells are usually cached in ascending order, so
+  // that insertion is an append.
+  typedef std::vector<DataCell*> DataCellSet;
 
   WrDiskCacheEntry(const std::shared_ptr<DiskAdaptor>& diskAdaptor);
   ~WrDiskCacheEntry();
 
   // Flushes the cached data to the disk and deletes them.
   void writeToDisk();
+  // Waits for the writes of the file performed in background to
+  // complete.  If one of them failed, getError() returns
+  // CACHE_ERR_ERROR.
+  void waitWrites();
   // Deletes cached data without flushing to the disk.
   void clear();
 
@@ -85,11 +92,18 @@ public:
   size_t getSizeKey() const { return sizeKey_; }
   void setLastUpdate(int64_t clock) { lastUpdate_ = clock; }
   int64_t getLastUpdate() const { return lastUpdate_; }
-  bool operator<(const WrDiskCacheEntry& rhs) const
+  // The position in the bucket of WrDiskCache.  Valid only while
+  // isCached() is true.
+  void setCachePos(std::list<WrDiskCacheEntry*>::iterator pos)
   {
-    return sizeKey_ > rhs.sizeKey_ ||
-           (sizeKey_ == rhs.sizeKey_ && lastUpdate_ < rhs.lastUpdate_);
+    cachePos_ = pos;
   }
+  std::list<WrDiskCacheEntry*>::iterator getCachePos() const
+  {
+    return cachePos_;
+  }
+  void setCached(bool cached) { cached_ = cached; }
+  bool isCached() const { return cached_; }
 
   enum { CACHE_ERR_SUCCESS, CACHE_ERR_ERROR };
 
@@ -103,6 +117,8 @@ private:
 
   size_t sizeKey_;
   int64_t lastUpdate_;
+  std::list<WrDiskCacheEntry*>::iterator cachePos_;
+  bool cached_;
 
   size_t size_;
 
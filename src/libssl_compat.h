@@ -47,4 +47,7 @@
   ((!LIBRESSL_IN_USE && OPENSSL_VERSION_NUMBER >= 0x1010000fL) ||              \
    (LIBRESSL_IN_USE && LIBRESSL_VERSION_NUMBER >= 0x20700000L))
 
+#define OPENSSL_111_API                                                        \
+  (!LIBRESSL_IN_USE && OPENSSL_VERSION_NUMBER >= 0x1010100fL)
+
 #endif // LIBSSL_COMPAT_H
@@ -135,6 +135,7 @@ const std::string V_INORDER("inorder");
 const std::string A2_V_RANDOM("random");
 const std::string V_FEEDBACK("feedback");
 const std::string V_ADAPTIVE("adaptive");
+const std::string V_PREDICTIVE("predictive");
 const std::string V_LIBUV("libuv");
 const std::string V_EPOLL("epoll");
 const std::string V_KQUEUE("kqueue");
@@ -179,6 +180,8 @@ PrefPtr PREF_OUT = makePref("out");
 // values: 1*digit
 PrefPtr PREF_SPLIT = makePref("split");
 // value: true | false
+PrefPtr PREF_ADAPTIVE_SPLIT = makePref("adaptive-split");
+// value: true | false
 PrefPtr PREF_DAEMON = makePref("daemon");
 // value: a string
 PrefPtr PREF_REFERER = makePref("referer");
@@ -203,6 +206,8 @@ PrefPtr PREF_ALLOW_OVERWRITE = makePref("allow-overwrite");
 PrefPtr PREF_REALTIME_CHUNK_CHECKSUM = makePref("realtime-chunk-checksum");
 // value: true | false
 PrefPtr PREF_CHECK_INTEGRITY = makePref("check-integrity");
+// value: 1*digit
+PrefPtr PREF_MAX_CONCURRENT_CHECKS = makePref("max-concurrent-checks");
 // value: string that your file system recognizes as a file name.
 PrefPtr PREF_NETRC_PATH = makePref("netrc-path");
 // value:
@@ -352,6 +357,10 @@ PrefPtr PREF_FORCE_SAVE = makePref("force-save");
 PrefPtr PREF_SAVE_NOT_FOUND = makePref("save-not-found");
 // value: 1*digit
 PrefPtr PREF_DISK_CACHE = makePref("disk-cache");
+// value: 1*digit
+PrefPtr PREF_DISK_IO_QUEUE_DEPTH = makePref("disk-io-queue-depth");
+// value: 1*digit
+PrefPtr PREF_HASH_WORKER_THREADS = makePref("hash-worker-threads");
 // value: string
 PrefPtr PREF_GID = makePref("gid");
 // values: 1*digit
@@ -370,7 +379,22 @@ PrefPtr PREF_MIN_TLS_VERSION = makePref("min-tls-version");
 // value: 1*digit
 PrefPtr PREF_SOCKET_RECV_BUFFER_SIZE = makePref("socket-recv-buffer-size");
 // value: 1*digit
+PrefPtr PREF_RECV_BUFFER_SIZE = makePref("recv-buffer-size");
+// value: 1*digit
+PrefPtr PREF_RECV_BUFFER_MEMORY_LIMIT = makePref("recv-buffer-memory-limit");
+// value: 1*digit
+PrefPtr PREF_DNS_CACHE_SIZE = makePref("dns-cache-size");
+// value: 1*digit
+PrefPtr PREF_DNS_CACHE_TTL = makePref("dns-cache-ttl");
+// value: 1*digit
+PrefPtr PREF_DNS_NEGATIVE_CACHE_TTL = makePref("dns-negative-cache-ttl");
+// value: 1*digit
 PrefPtr PREF_MAX_MMAP_LIMIT = makePref("max-mmap-limit");
+// value: 1*digit
+PrefPtr PREF_MAX_POOLED_CONNECTIONS = makePref("max-pooled-connections");
+// value: 1*digit
+PrefPtr PREF_MAX_POOLED_CONNECTIONS_PER_HOST =
+    makePref("max-pooled-connections-per-host");
 // value: true | false
 PrefPtr PREF_STDERR = makePref("stderr");
 // value: true | false
@@ -92,6 +92,7 @@ extern const std::string V_INORDER;
 extern const std::string A2_V_RANDOM;
 extern const std::string V_FEEDBACK;
 extern const std::string V_ADAPTIVE;
+extern const std::string V_PREDICTIVE;
 extern const std::string V_LIBUV;
 extern const std::string V_EPOLL;
 extern const std::string V_KQUEUE;
@@ -136,6 +137,8 @@ extern PrefPtr PREF_OUT;
 // values: 1*digit
 extern PrefPtr PREF_SPLIT;
 // value: true | false
+extern PrefPtr PREF_ADAPTIVE_SPLIT;
+// value: true | false
 extern PrefPtr PREF_DAEMON;
 // value: a string
 extern PrefPtr PREF_REFERER;
@@ -157,6 +160,8 @@ extern PrefPtr PREF_ALLOW_OVERWRITE;
 extern PrefPtr PREF_REALTIME_CHUNK_CHECKSUM;
 // value: true | false
 extern PrefPtr PREF_CHECK_INTEGRITY;
+// value: 1*digit
+extern PrefPtr PREF_MAX_CONCURRENT_CHECKS;
 // value: string that your file system recognizes as a file name.
 extern PrefPtr PREF_NETRC_PATH;
 // value:
@@ -305,6 +310,10 @@ extern PrefPtr PREF_FORCE_SAVE;
 extern PrefPtr PREF_SAVE_NOT_FOUND;
 // value: 1*digit
 extern PrefPtr PREF_DISK_CACHE;
+// value: 1*digit
+extern PrefPtr PREF_DISK_IO_QUEUE_DEPTH;
+// value: 1*digit
+extern PrefPtr PREF_HASH_WORKER_THREADS;
 // value: string
 extern PrefPtr PREF_GID;
 // values: 1*digit
@@ -324,7 +333,21 @@ extern PrefPtr PREF_MIN_TLS_VERSION;
 // value: 1*digit
 extern PrefPtr PREF_SOCKET_RECV_BUFFER_SIZE;
 // value: 1*digit
+extern PrefPtr PREF_RECV_BUFFER_SIZE;
+// value: 1*digit
+extern PrefPtr PREF_RECV_BUFFER_MEMORY_LIMIT;
+// value: 1*digit
+extern PrefPtr PREF_DNS_CACHE_SIZE;
+// value: 1*digit
+extern PrefPtr PREF_DNS_CACHE_TTL;
+// value: 1*digit
+extern PrefPtr PREF_DNS_NEGATIVE_CACHE_TTL;
+// value: 1*digit
 extern PrefPtr PREF_MAX_MMAP_LIMIT;
+// value: 1*digit
+extern PrefPtr PREF_MAX_POOLED_CONNECTIONS;
+// value: 1*digit
+extern PrefPtr PREF_MAX_POOLED_CONNECTIONS_PER_HOST;
 // value: true | false
 extern PrefPtr PREF_STDERR;
 // value: true | false
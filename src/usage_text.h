@@ -60,6 +60,14 @@
     "                              same host is restricted by the \n"        \
     "                              --max-connection-per-server option. See also the\n" \
     "                              --min-split-size option.")
+#define TEXT_ADAPTIVE_SPLIT                                             \
+  _(" --adaptive-split[=true|false] Start a download with a few connections and\n" \
+    "                              add more while the download speed grows, up to\n" \
+    "                              the number given by --split option. The slowest\n" \
+    "                              connections are closed when adding connections\n" \
+    "                              does not improve the speed any more, and the\n" \
+    "                              number of connections is halved when the server\n" \
+    "                              responds with 429 or 503.")
 #define TEXT_RETRY_WAIT                                                 \
   _(" --retry-wait=SEC             Set the seconds to wait between retries. \n" \
     "                              With SEC > 0, aria2 will retry download when the\n" \
@@ -206,6 +214,9 @@
     "                              re-downloaded from scratch. If both piece hashes\n" \
     "                              and a hash of entire file are provided, only\n" \
     "                              piece hashes are used.")
+#define TEXT_MAX_CONCURRENT_CHECKS                                      \
+  _(" --max-concurrent-checks=NUM  Set the maximum number of downloads whose\n" \
+    "                              integrity is checked at the same time.")
 #define TEXT_BT_HASH_CHECK_SEED                                         \
   _(" --bt-hash-check-seed[=true|false] If true is given, after hash check using\n" \
     "                              --check-integrity option and file is complete,\n" \
@@ -495,7 +506,13 @@
     "                              already been tested, returns mirrors which has to\n" \
     "                              be tested again. Otherwise, it doesn't select\n" \
     "                              anymore mirrors. Like 'feedback', it uses a\n" \
-    "                              performance profile of servers.")
+    "                              performance profile of servers.\n"   \
+    "                              If 'predictive' is given, selects the mirror\n" \
+    "                              which is expected to finish the download first,\n" \
+    "                              estimated from throughput, connection and\n" \
+    "                              response latencies and error rate in the\n" \
+    "                              performance profile. Mirrors without profile\n" \
+    "                              are tried as if they were the fastest one.")
 #define TEXT_SERVER_STAT_OF                                             \
   _(" --server-stat-of=FILE        Specify the filename to which performance profile\n" \
     "                              of the servers is saved. You can load saved data\n" \
@@ -820,6 +837,22 @@
     "                              option is useful when the system does not have\n" \
     "                              /etc/resolv.conf and user does not have the\n" \
     "                              permission to create it.")
+#define TEXT_DNS_CACHE_SIZE                                             \
+  _(" --dns-cache-size=NUM         Set the maximum number of host names whose\n" \
+    "                              addresses are cached. When the cache is full,\n" \
+    "                              the least recently used entry is evicted.")
+#define TEXT_DNS_CACHE_TTL                                              \
+  _(" --dns-cache-ttl=SEC          Set the maximum time in seconds resolved\n" \
+    "                              addresses are cached. If asynchronous DNS tells\n" \
+    "                              the TTL of the DNS records and it is shorter,\n" \
+    "                              the TTL is used instead.")
+#define TEXT_DNS_NEGATIVE_CACHE_TTL                                     \
+  _(" --dns-negative-cache-ttl=SEC Set the time in seconds name resolution which\n" \
+    "                              failed because the name has no address is\n" \
+    "                              cached. During this period, downloads from\n" \
+    "                              the host fail without querying DNS again.\n" \
+    "                              Timeouts are not cached.\n" \
+    "                              Specify 0 to disable negative caching.")
 #define TEXT_ENABLE_RPC                                               \
   _(" --enable-rpc[=true|false]    Enable JSON-RPC/XML-RPC server.\n" \
     "                              It is strongly recommended to set secret\n" \
@@ -1002,6 +1035,23 @@
     "                              cached in memory, we don't need to read them\n" \
     "                              from the disk.\n"                    \
     "                              SIZE can include K or M(1K = 1024, 1M = 1024K).")
+#define TEXT_DISK_IO_QUEUE_DEPTH                \
+  _(" --disk-io-queue-depth=NUM    Write the disk cache to files in background\n" \
+    "                              threads, one per device, so that slow disks do\n" \
+    "                              not stall network I/O. NUM is the maximum\n" \
+    "                              number of writes queued per device. When the\n" \
+    "                              queue is full, aria2 waits for the disk. Writes\n" \
+    "                              of adjacent blocks are merged. If NUM is 0,\n" \
+    "                              files are written synchronously, one block at\n" \
+    "                              a time. This option has no effect if\n" \
+    "                              --disk-cache is 0.")
+#define TEXT_HASH_WORKER_THREADS                \
+  _(" --hash-worker-threads=NUM    Set the number of threads which verify the hash\n" \
+    "                              of completed BitTorrent pieces and the pieces\n" \
+    "                              checked by --check-integrity in background.\n" \
+    "                              While a piece is verified, the other connections\n" \
+    "                              keep transferring data. If NUM is 0, pieces are\n" \
+    "                              verified synchronously.")
 #define TEXT_GID                                \
   _(" --gid=GID                    Set GID manually. aria2 identifies each\n" \
     "                              download by the ID called GID. The GID must be\n" \
@@ -1093,6 +1143,21 @@
     "                              Specifying 0 will disable this option. This value\n" \
     "                              will be set to socket file descriptor using\n" \
     "                              SO_RCVBUF socket option with setsockopt() call.")
+#define TEXT_RECV_BUFFER_SIZE                                           \
+  _(" --recv-buffer-size=SIZE      Set the size of the buffer each connection\n" \
+    "                              reads received data into before it is written\n" \
+    "                              to disk. Larger value reduces the number of\n" \
+    "                              system calls on fast links at the cost of\n" \
+    "                              memory per connection. This is not the kernel\n" \
+    "                              socket buffer; see --socket-recv-buffer-size.\n" \
+    "                              This is the initial size. The buffer of a busy\n" \
+    "                              connection grows up to 1M and shrinks back when\n" \
+    "                              it slows down.")
+#define TEXT_RECV_BUFFER_MEMORY_LIMIT                                   \
+  _(" --recv-buffer-memory-limit=SIZE Set the upper limit of the total size of\n" \
+    "                              receive buffers of all connections. Buffers do\n" \
+    "                              not grow beyond --recv-buffer-size once the limit\n" \
+    "                              is reached.")
 #define TEXT_BT_ENABLE_HOOK_AFTER_HASH_CHECK                            \
   _(" --bt-enable-hook-after-hash-check[=true|false] Allow hook command invocation\n" \
     "                              after hash check (see -V option) in BitTorrent\n" \
@@ -1109,6 +1174,14 @@
     "                              size of those files. If file size is strictly\n" \
     "                              greater than the size specified in this option,\n" \
     "                              mmap will be disabled.")
+#define TEXT_MAX_POOLED_CONNECTIONS                                     \
+  _(" --max-pooled-connections=NUM Set the maximum number of idle connections kept\n" \
+    "                              for reuse. When the limit is reached, the least\n" \
+    "                              recently used connection is closed. Specify 0 to\n" \
+    "                              disable connection reuse.")
+#define TEXT_MAX_POOLED_CONNECTIONS_PER_HOST                            \
+  _(" --max-pooled-connections-per-host=NUM Set the maximum number of idle\n" \
+    "                              connections kept for reuse per host.")
 #define TEXT_STDERR \
   _(" --stderr[=true|false]        Redirect all console output that would be\n" \
     "                              otherwise printed in stdout to stderr.")
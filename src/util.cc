@@ -296,9 +296,6 @@ bool isIso8859p1(unsigned char c)
   return (0x20u <= c && c <= 0x7eu) || 0xa0u <= c;
 }
 
-bool isLws(const char c) { return c == ' ' || c == '\t'; }
-bool isCRLF(const char c) { return c == '\r' || c == '\n'; }
-
 namespace {
 
 bool isUtf8Tail(unsigned char ch) { return in(ch, 0x80u, 0xbfu); }
@@ -409,9 +409,11 @@ bool isHexDigit(const char c);
 
 bool isHexDigit(const std::string& s);
 
-bool isLws(const char c);
+// isLws() and isCRLF() are called for every byte of HTTP headers, so
+// they are defined here to be inlined.
+inline bool isLws(const char c) { return c == ' ' || c == '\t'; }
 
-bool isCRLF(const char c);
+inline bool isCRLF(const char c) { return c == '\r' || c == '\n'; }
 
 template <typename InputIterator>
 bool isLowercase(InputIterator first, InputIterator last)
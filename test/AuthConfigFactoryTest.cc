@@ -7,6 +7,9 @@
 #include "Request.h"
 #include "AuthConfig.h"
 #include "Option.h"
+#include "HttpHeader.h"
+#include "MessageDigest.h"
+#include "util.h"
 
 namespace aria2 {
 
@@ -16,6 +19,13 @@ class AuthConfigFactoryTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testCreateAuthConfig_http);
   CPPUNIT_TEST(testCreateAuthConfig_httpNoChallenge);
   CPPUNIT_TEST(testCreateAuthConfig_ftp);
+  CPPUNIT_TEST(testCreateAuthConfig_digest);
+  CPPUNIT_TEST(testCreateDigestAuthConfig_rfc2617);
+  CPPUNIT_TEST(testCreateDigestAuthConfig_rfc7616);
+  CPPUNIT_TEST(testGetDigestAlgorithmStrength);
+  CPPUNIT_TEST(testActivateAuthCred_digestDomain);
+  CPPUNIT_TEST(testUpdateDigestAuthInfo);
+  CPPUNIT_TEST(testUpdateDigestAuthInfo_sessNextnonceFirst);
   CPPUNIT_TEST(testUpdateBasicCred);
   CPPUNIT_TEST_SUITE_END();
 
@@ -23,6 +33,13 @@ public:
   void testCreateAuthConfig_http();
   void testCreateAuthConfig_httpNoChallenge();
   void testCreateAuthConfig_ftp();
+  void testCreateAuthConfig_digest();
+  void testCreateDigestAuthConfig_rfc2617();
+  void testCreateDigestAuthConfig_rfc7616();
+  void testGetDigestAlgorithmStrength();
+  void testActivateAuthCred_digestDomain();
+  void testUpdateDigestAuthInfo();
+  void testUpdateDigestAuthInfo_sessNextnonceFirst();
   void testUpdateBasicCred();
 };
 
@@ -188,6 +205,200 @@ void AuthConfigFactoryTest::testCreateAuthConfig_ftp()
                        factory.createAuthConfig(req, &option)->getAuthText());
 }
 
+void AuthConfigFactoryTest::testCreateAuthConfig_digest()
+{
+  std::shared_ptr<Request> req(new Request());
+  req->setUri("http://localhost/download/aria2-1.0.0.tar.bz2");
+
+  Option option;
+  option.put(PREF_NO_NETRC, A2_V_TRUE);
+  option.put(PREF_HTTP_USER, "aria2user");
+  option.put(PREF_HTTP_PASSWD, "aria2password");
+
+  AuthConfigFactory factory;
+
+  auto params = make_unique<DigestAuthParams>();
+  params->realm = "aria2";
+  params->serverNonce = "dcd98b7102dd2f0e8b11d0f600bfb0c093";
+  params->qop = "auth";
+  params->algorithm = "MD5";
+  CPPUNIT_ASSERT(factory.activateAuthCred("localhost", 80, "/download/",
+                                          &option, std::move(params)));
+
+  // The cached nonce is used preemptively and nonce-count is
+  // incremented for each request.
+  auto authConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL(AUTH_DIGEST, authConfig->getAuthScheme());
+  CPPUNIT_ASSERT_EQUAL((uint32_t)1, authConfig->getNonceCount());
+  auto authText = authConfig->getAuthText();
+  CPPUNIT_ASSERT(util::startsWith(authText, "Digest username=\"aria2user\""));
+  CPPUNIT_ASSERT(authText.find("uri=\"/download/aria2-1.0.0.tar.bz2\"") !=
+                 std::string::npos);
+  CPPUNIT_ASSERT(authText.find("nc=00000001") != std::string::npos);
+
+  authConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL((uint32_t)2, authConfig->getNonceCount());
+  CPPUNIT_ASSERT(authConfig->getAuthText().find("nc=00000002") !=
+                 std::string::npos);
+
+  // Other path in the same protection space
+  req->setUri("http://localhost/download/sub/README");
+  authConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL(AUTH_DIGEST, authConfig->getAuthScheme());
+  CPPUNIT_ASSERT_EQUAL((uint32_t)3, authConfig->getNonceCount());
+
+  // New nonce resets nonce-count
+  params = make_unique<DigestAuthParams>();
+  params->realm = "aria2";
+  params->serverNonce = "0a4f113b";
+  params->qop = "auth";
+  params->stale = true;
+  CPPUNIT_ASSERT(factory.activateAuthCred("localhost", 80, "/download/",
+                                          &option, std::move(params)));
+  authConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL((uint32_t)1, authConfig->getNonceCount());
+  CPPUNIT_ASSERT(authConfig->getAuthText().find("nonce=\"0a4f113b\"") !=
+                 std::string::npos);
+
+  // Outside of protection space
+  req->setUri("http://localhost/other/README");
+  CPPUNIT_ASSERT_EQUAL(AUTH_BASIC,
+                       factory.createAuthConfig(req, &option)->getAuthScheme());
+}
+
+void AuthConfigFactoryTest::testCreateDigestAuthConfig_rfc2617()
+{
+  // Example in RFC 2617, section 3.5
+  DigestAuthParams params;
+  params.realm = "testrealm@host.com";
+  params.serverNonce = "dcd98b7102dd2f0e8b11d0f600bfb0c093";
+  params.qop = "auth";
+  params.nonceCount = 1;
+  params.clientNonce = "0a4f113b";
+
+  auto md = MessageDigest::create("md5");
+  auto ha1 = AuthConfig::createDigestHA1(*md, "Mufasa", params.realm,
+                                         "Circle Of Life");
+  CPPUNIT_ASSERT_EQUAL(std::string("939e7578ed9e3c518a452acee763bce9"), ha1);
+
+  auto authConfig = AuthConfig::create("Mufasa", "/dir/index.html", "GET",
+                                       params, ha1, *md);
+  CPPUNIT_ASSERT_EQUAL(
+      std::string("Digest username=\"Mufasa\", realm=\"testrealm@host.com\", "
+                  "nonce=\"dcd98b7102dd2f0e8b11d0f600bfb0c093\", "
+                  "uri=\"/dir/index.html\", "
+                  "response=\"6629fae49393a05397450978507c4ef1\", "
+                  "qop=auth, nc=00000001, cnonce=\"0a4f113b\""),
+      authConfig->getAuthText());
+
+  // response-auth uses A2 = ":" digest-uri-value
+  CPPUNIT_ASSERT(authConfig->verifyResponseAuth(
+      "376602cfd2f4e8e5e78b948a85263e85", ha1, *md));
+  CPPUNIT_ASSERT(!authConfig->verifyResponseAuth(
+      "6629fae49393a05397450978507c4ef1", ha1, *md));
+}
+
+void AuthConfigFactoryTest::testCreateDigestAuthConfig_rfc7616()
+{
+  // Example in RFC 7616, section 3.9.1
+  DigestAuthParams params;
+  params.realm = "http-auth@example.org";
+  params.serverNonce = "7ypf/xlj9XXwfDPEoM4URrv/xwf94BcCAzFZH4GiTo0v";
+  params.qop = "auth";
+  params.nonceCount = 1;
+  params.clientNonce = "f2/wE4q74E6zIJEtWaHKaf5wv/H5QzzpXusqGemxURZJ";
+
+  params.algorithm = "MD5";
+  auto md = MessageDigest::create(getDigestHashType(params.algorithm));
+  auto ha1 = AuthConfig::createDigestHA1(*md, "Mufasa", params.realm,
+                                         "Circle of Life");
+  auto authText = AuthConfig::create("Mufasa", "/dir/index.html", "GET",
+                                     params, ha1, *md)
+                      ->getAuthText();
+  CPPUNIT_ASSERT(
+      authText.find("response=\"8ca523f5e9506fed4657c9700eebdbec\"") !=
+      std::string::npos);
+
+  params.algorithm = "SHA-256";
+  md = MessageDigest::create(getDigestHashType(params.algorithm));
+  ha1 = AuthConfig::createDigestHA1(*md, "Mufasa", params.realm,
+                                    "Circle of Life");
+  authText = AuthConfig::create("Mufasa", "/dir/index.html", "GET", params,
+                                ha1, *md)
+                 ->getAuthText();
+  CPPUNIT_ASSERT(authText.find("algorithm=SHA-256, "
+                               "response=\"753927fa0e85d155564e2e272a28d180"
+                               "2ca10daf4496794697cf8db5856cb6c1\"") !=
+                 std::string::npos);
+}
+
+void AuthConfigFactoryTest::testGetDigestAlgorithmStrength()
+{
+  CPPUNIT_ASSERT_EQUAL(0, getDigestAlgorithmStrength(""));
+  CPPUNIT_ASSERT_EQUAL(0, getDigestAlgorithmStrength("MD5"));
+  CPPUNIT_ASSERT_EQUAL(0, getDigestAlgorithmStrength("MD5-sess"));
+  CPPUNIT_ASSERT_EQUAL(1, getDigestAlgorithmStrength("SHA-256"));
+  CPPUNIT_ASSERT_EQUAL(1, getDigestAlgorithmStrength("sha-256-SESS"));
+  CPPUNIT_ASSERT_EQUAL(-1, getDigestAlgorithmStrength("SHA-1"));
+  CPPUNIT_ASSERT_EQUAL(-1, getDigestAlgorithmStrength("-sess"));
+  CPPUNIT_ASSERT_EQUAL(std::string("sha-256"),
+                       getDigestHashType("SHA-256-sess"));
+  CPPUNIT_ASSERT(isDigestSessionAlgorithm("MD5-sess"));
+  CPPUNIT_ASSERT(!isDigestSessionAlgorithm("MD5"));
+}
+
+void AuthConfigFactoryTest::testActivateAuthCred_digestDomain()
+{
+  Option option;
+  option.put(PREF_NO_NETRC, A2_V_TRUE);
+  option.put(PREF_HTTP_USER, "aria2user");
+  option.put(PREF_HTTP_PASSWD, "aria2password");
+
+  AuthConfigFactory factory;
+
+  auto params = make_unique<DigestAuthParams>();
+  params->realm = "aria2";
+  params->serverNonce = "n1";
+  params->qop = "auth";
+  params->opaque = "opq";
+  params->domain = {"/private/", "http://localhost/mirror",
+                    "http://example.org/"};
+  CPPUNIT_ASSERT(factory.activateAuthCred("localhost", 80, "/download/",
+                                          &option, std::move(params)));
+
+  std::shared_ptr<Request> req(new Request());
+  req->setUri("http://localhost/private/a.txt");
+  auto authConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL(AUTH_DIGEST, authConfig->getAuthScheme());
+  CPPUNIT_ASSERT_EQUAL((uint32_t)1, authConfig->getNonceCount());
+  CPPUNIT_ASSERT(authConfig->getAuthText().find("opaque=\"opq\"") !=
+                 std::string::npos);
+
+  // The paths in the same protection space share nonce-count.
+  req->setUri("http://localhost/mirror/b.txt");
+  authConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL(AUTH_DIGEST, authConfig->getAuthScheme());
+  CPPUNIT_ASSERT_EQUAL((uint32_t)2, authConfig->getNonceCount());
+
+  // Other hosts are not registered.
+  req->setUri("http://example.org/c.txt");
+  CPPUNIT_ASSERT_EQUAL(AUTH_BASIC,
+                       factory.createAuthConfig(req, &option)->getAuthScheme());
+
+  // New nonce is propagated to the whole protection space.
+  params = make_unique<DigestAuthParams>();
+  params->realm = "aria2";
+  params->serverNonce = "n2";
+  params->stale = true;
+  CPPUNIT_ASSERT(factory.activateAuthCred("localhost", 80, "/download/",
+                                          &option, std::move(params)));
+  req->setUri("http://localhost/private/a.txt");
+  authConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL((uint32_t)1, authConfig->getNonceCount());
+  CPPUNIT_ASSERT(authConfig->getAuthText().find("nonce=\"n2\"") !=
+                 std::string::npos);
+}
+
 namespace {
 std::unique_ptr<AuthCred>
 createBasicCred(const std::string& user, const std::string& password,
@@ -198,6 +409,106 @@ createBasicCred(const std::string& user, const std::string& password,
 }
 } // namespace
 
+void AuthConfigFactoryTest::testUpdateDigestAuthInfo()
+{
+  std::shared_ptr<Request> req(new Request());
+  req->setUri("http://localhost/download/aria2-1.0.0.tar.bz2");
+
+  Option option;
+  option.put(PREF_NO_NETRC, A2_V_TRUE);
+  option.put(PREF_HTTP_USER, "aria2user");
+  option.put(PREF_HTTP_PASSWD, "aria2password");
+
+  AuthConfigFactory factory;
+
+  auto params = make_unique<DigestAuthParams>();
+  params->realm = "aria2";
+  params->serverNonce = "dcd98b7102dd2f0e8b11d0f600bfb0c093";
+  params->qop = "auth";
+  CPPUNIT_ASSERT(factory.activateAuthCred("localhost", 80, "/download/",
+                                          &option, std::move(params)));
+
+  auto authConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL((uint32_t)1, authConfig->getNonceCount());
+  authConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL((uint32_t)2, authConfig->getNonceCount());
+
+  // rspauth mismatch
+  CPPUNIT_ASSERT(!factory.updateDigestAuthInfo(
+      req, *authConfig, "rspauth=\"00000000000000000000000000000000\""));
+
+  // nextnonce replaces the cached nonce and nonce-count starts over
+  CPPUNIT_ASSERT(factory.updateDigestAuthInfo(
+      req, *authConfig, "qop=auth, nextnonce=\"0a4f113b\", nc=00000002"));
+  auto nextAuthConfig = factory.createAuthConfig(req, &option);
+  CPPUNIT_ASSERT_EQUAL((uint32_t)1, nextAuthConfig->getNonceCount());
+  CPPUNIT_ASSERT_EQUAL(std::string("0a4f113b"),
+                       nextAuthConfig->getServerNonce());
+
+  // Authentication-Info for the request sent with the old nonce is
+  // ignored.
+  CPPUNIT_ASSERT(factory.updateDigestAuthInfo(
+      req, *authConfig, "rspauth=\"00000000000000000000000000000000\", "
+                        "nextnonce=\"f2/wE4q74E6zIJEt\""));
+  CPPUNIT_ASSERT_EQUAL(std::string("0a4f113b"),
+                       factory.createAuthConfig(req, &option)
+                           ->getServerNonce());
+}
+
+namespace {
+std::string md5(const std::string& s)
+{
+  auto ctx = MessageDigest::create("md5");
+  ctx->update(s.data(), s.size());
+  return util::toHex(ctx->digest());
+}
+} // namespace
+
+void AuthConfigFactoryTest::testUpdateDigestAuthInfo_sessNextnonceFirst()
+{
+  std::shared_ptr<Request> req(new Request());
+  req->setUri("http://localhost/download/aria2-1.0.0.tar.bz2");
+
+  Option option;
+  option.put(PREF_NO_NETRC, A2_V_TRUE);
+  option.put(PREF_HTTP_USER, "aria2user");
+  option.put(PREF_HTTP_PASSWD, "aria2password");
+
+  AuthConfigFactory factory;
+
+  auto params = make_unique<DigestAuthParams>();
+  params->realm = "aria2";
+  params->serverNonce = "dcd98b7102dd2f0e8b11d0f600bfb0c093";
+  params->qop = "auth";
+  params->algorithm = "MD5-sess";
+  CPPUNIT_ASSERT(factory.activateAuthCred("localhost", 80, "/download/",
+                                          &option, std::move(params)));
+
+  auto authConfig = factory.createAuthConfig(req, &option);
+  std::string cnonce;
+  for (auto& p : parseAuthParams(authConfig->getAuthText().substr(7))) {
+    if (p.first == "cnonce") {
+      cnonce = p.second;
+    }
+  }
+  CPPUNIT_ASSERT(!cnonce.empty());
+  auto ha1 = md5(md5("aria2user:aria2:aria2password") +
+                 ":dcd98b7102dd2f0e8b11d0f600bfb0c093:" + cnonce);
+  auto rspauth = md5(ha1 + ":dcd98b7102dd2f0e8b11d0f600bfb0c093:00000001:" +
+                     cnonce + ":auth:" +
+                     md5(":/download/aria2-1.0.0.tar.bz2"));
+
+  // Apache sends nextnonce before rspauth.  rspauth is verified with
+  // H(A1) of the nonce the request was sent with.
+  CPPUNIT_ASSERT(factory.updateDigestAuthInfo(
+      req, *authConfig,
+      "nextnonce=\"0a4f113b\", qop=auth, rspauth=\"" + rspauth +
+          "\", cnonce=\"" + cnonce + "\", nc=00000001"));
+  CPPUNIT_ASSERT_EQUAL(std::string("0a4f113b"),
+                       factory.createAuthConfig(req, &option)
+                           ->getServerNonce());
+}
+
 void AuthConfigFactoryTest::testUpdateBasicCred()
 {
   Option option;
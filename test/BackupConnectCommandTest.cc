@@ -0,0 +1,115 @@
+#include "BackupConnectCommand.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "DownloadEngine.h"
+#include "SelectEventPoll.h"
+#include "RequestGroupMan.h"
+#include "RequestGroup.h"
+#include "GroupId.h"
+#include "SocketCore.h"
+#include "Option.h"
+#include "prefs.h"
+
+namespace aria2 {
+
+class BackupConnectCommandTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(BackupConnectCommandTest);
+  CPPUNIT_TEST(testExecute_race);
+  CPPUNIT_TEST(testExecute_lost);
+  CPPUNIT_TEST(testExecute_cancel);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  class MainCommand : public Command {
+  public:
+    MainCommand() : Command(1) {}
+    virtual bool execute() CXX11_OVERRIDE { return true; }
+  };
+
+  std::unique_ptr<DownloadEngine> e_;
+  std::shared_ptr<Option> option_;
+  std::shared_ptr<RequestGroup> group_;
+  SocketCore server_;
+  uint16_t port_;
+  MainCommand mainCommand_;
+
+  void addCommand(const std::string& ipaddr, std::chrono::milliseconds delay,
+                  const std::shared_ptr<BackupConnectInfo>& info)
+  {
+    e_->addCommand(make_unique<BackupConnectCommand>(
+        e_->newCUID(), "localhost", ipaddr, port_, delay, info, &mainCommand_,
+        group_.get(), e_.get()));
+  }
+
+  // Runs the engine until all commands finish.  Returns false if
+  // they don't.
+  bool run()
+  {
+    for (int i = 0; i < 10; ++i) {
+      if (e_->run(true) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+public:
+  void setUp()
+  {
+    option_ = std::make_shared<Option>();
+    option_->put(PREF_CONNECT_TIMEOUT, "10");
+    e_ = make_unique<DownloadEngine>(make_unique<SelectEventPoll>());
+    e_->setOption(option_.get());
+    e_->setRequestGroupMan(make_unique<RequestGroupMan>(
+        std::vector<std::shared_ptr<RequestGroup>>{}, 3, option_.get()));
+    group_ = std::make_shared<RequestGroup>(GroupId::create(), option_);
+
+    server_.bind("127.0.0.1", 0, AF_INET);
+    server_.beginListen();
+    port_ = server_.getAddrInfo().port;
+  }
+
+  void testExecute_race();
+  void testExecute_lost();
+  void testExecute_cancel();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BackupConnectCommandTest);
+
+void BackupConnectCommandTest::testExecute_race()
+{
+  auto info = std::make_shared<BackupConnectInfo>();
+  addCommand("127.0.0.1", std::chrono::milliseconds(0), info);
+  // Staggered behind the first one, which connects well before this
+  // one starts.  It must give up without connecting.
+  addCommand("127.0.0.2", std::chrono::seconds(30), info);
+  CPPUNIT_ASSERT(run());
+  CPPUNIT_ASSERT_EQUAL(std::string("127.0.0.1"), info->ipaddr);
+  CPPUNIT_ASSERT(info->socket);
+  CPPUNIT_ASSERT(mainCommand_.statusMatch(Command::STATUS_ONESHOT_REALTIME));
+}
+
+void BackupConnectCommandTest::testExecute_lost()
+{
+  auto info = std::make_shared<BackupConnectInfo>();
+  // The main command or another backup command has already won.
+  info->ipaddr = "192.0.2.1";
+  addCommand("127.0.0.1", std::chrono::milliseconds(0), info);
+  CPPUNIT_ASSERT(run());
+  CPPUNIT_ASSERT_EQUAL(std::string("192.0.2.1"), info->ipaddr);
+  CPPUNIT_ASSERT(!info->socket);
+}
+
+void BackupConnectCommandTest::testExecute_cancel()
+{
+  auto info = std::make_shared<BackupConnectInfo>();
+  info->cancel = true;
+  addCommand("127.0.0.1", std::chrono::milliseconds(0), info);
+  CPPUNIT_ASSERT(run());
+  CPPUNIT_ASSERT(info->ipaddr.empty());
+  CPPUNIT_ASSERT(!info->socket);
+}
+
+} // namespace aria2
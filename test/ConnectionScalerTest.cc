@@ -0,0 +1,95 @@
+#include "ConnectionScaler.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace aria2 {
+
+class ConnectionScalerTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(ConnectionScalerTest);
+  CPPUNIT_TEST(testUpdate_saturate);
+  CPPUNIT_TEST(testUpdate_max);
+  CPPUNIT_TEST(testUpdate_waitConnections);
+  CPPUNIT_TEST(testOnServerBusy);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testUpdate_saturate();
+  void testUpdate_max();
+  void testUpdate_waitConnections();
+  void testOnServerBusy();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ConnectionScalerTest);
+
+namespace {
+// Each connection gets 100 up to |limit| in total.
+int speedOf(int numConnections, int limit)
+{
+  return std::min(numConnections * 100, limit);
+}
+} // namespace
+
+void ConnectionScalerTest::testUpdate_saturate()
+{
+  ConnectionScaler scaler(1, 32);
+  CPPUNIT_ASSERT_EQUAL(2, scaler.getTarget());
+  // 2 -> 3 -> 4 -> 6 -> 9
+  int n = scaler.getTarget();
+  for (int i = 0; i < 4; ++i) {
+    n = scaler.update(speedOf(n, 550), n);
+  }
+  CPPUNIT_ASSERT_EQUAL(9, n);
+  // 9 connections gives 550, which is not better than 6 connections.
+  CPPUNIT_ASSERT_EQUAL(6, scaler.update(speedOf(n, 550), n));
+  n = 6;
+  for (int i = 0; i < ConnectionScaler::REPROBE_ROUNDS - 1; ++i) {
+    CPPUNIT_ASSERT_EQUAL(6, scaler.update(speedOf(n, 550), n));
+  }
+  // Probe again
+  CPPUNIT_ASSERT_EQUAL(9, scaler.update(speedOf(n, 550), n));
+}
+
+void ConnectionScalerTest::testUpdate_max()
+{
+  ConnectionScaler scaler(1, 5);
+  int n = scaler.getTarget();
+  for (int i = 0; i < 10; ++i) {
+    n = scaler.update(speedOf(n, 10000), n);
+  }
+  CPPUNIT_ASSERT_EQUAL(5, n);
+
+  scaler.setMaxConnections(3);
+  CPPUNIT_ASSERT_EQUAL(3, scaler.getTarget());
+}
+
+void ConnectionScalerTest::testUpdate_waitConnections()
+{
+  ConnectionScaler scaler(1, 16);
+  // No data yet
+  CPPUNIT_ASSERT_EQUAL(2, scaler.update(0, 2));
+  CPPUNIT_ASSERT_EQUAL(3, scaler.update(200, 2));
+  // Connections are not made yet.
+  CPPUNIT_ASSERT_EQUAL(3, scaler.update(200, 2));
+  CPPUNIT_ASSERT_EQUAL(3, scaler.update(200, 2));
+  // Gave up waiting. 3rd connection did not help.
+  CPPUNIT_ASSERT_EQUAL(2, scaler.update(200, 2));
+}
+
+void ConnectionScalerTest::testOnServerBusy()
+{
+  ConnectionScaler scaler(1, 32);
+  int n = scaler.getTarget();
+  for (int i = 0; i < 5; ++i) {
+    n = scaler.update(speedOf(n, 10000), n);
+  }
+  CPPUNIT_ASSERT_EQUAL(13, n);
+  scaler.onServerBusy();
+  n = scaler.update(speedOf(n, 10000), n);
+  CPPUNIT_ASSERT_EQUAL(6, n);
+  for (int i = 0; i < ConnectionScaler::BUSY_HOLD_ROUNDS; ++i) {
+    CPPUNIT_ASSERT_EQUAL(6, scaler.update(speedOf(n, 10000), n));
+  }
+}
+
+} // namespace aria2
@@ -2,6 +2,8 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include "wallclock.h"
+
 namespace aria2 {
 
 class DNSCacheTest : public CppUnit::TestFixture {
@@ -11,6 +13,10 @@ class DNSCacheTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testMarkBad);
   CPPUNIT_TEST(testPutBadAddr);
   CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST(testExpire);
+  CPPUNIT_TEST(testPutError);
+  CPPUNIT_TEST(testEvict);
+  CPPUNIT_TEST(testSetRTT);
   CPPUNIT_TEST_SUITE_END();
 
   DNSCache cache_;
@@ -29,6 +35,10 @@ public:
   void testMarkBad();
   void testPutBadAddr();
   void testRemove();
+  void testExpire();
+  void testPutError();
+  void testEvict();
+  void testSetRTT();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DNSCacheTest);
@@ -61,4 +71,92 @@ void DNSCacheTest::testRemove()
   CPPUNIT_ASSERT_EQUAL(std::string(""), cache_.find("www", 80));
 }
 
+void DNSCacheTest::testExpire()
+{
+  DNSCache cache;
+  cache.setTTL(std::chrono::seconds(60));
+  cache.put("www", "192.168.0.1", 80);
+  // TTL of DNS record is shorter than the default.
+  cache.put("cdn", "192.168.0.2", 80, std::chrono::seconds(10));
+  // TTL of DNS record is capped by the default.
+  cache.put("long", "192.168.0.3", 80, std::chrono::seconds(3600));
+
+  global::wallclock().advance(std::chrono::seconds(11));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), cache.find("www", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache.find("cdn", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.3"), cache.find("long", 80));
+
+  // Expired entry is replaced rather than extended.
+  cache.put("cdn", "192.168.0.4", 80, std::chrono::seconds(10));
+  std::vector<std::string> addrs;
+  cache.findAll(std::back_inserter(addrs), "cdn", 80);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, addrs.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.4"), addrs[0]);
+
+  global::wallclock().advance(std::chrono::seconds(50));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache.find("www", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache.find("long", 80));
+
+  global::wallclock().sub(std::chrono::seconds(61));
+}
+
+void DNSCacheTest::testPutError()
+{
+  DNSCache cache;
+  cache.setNegativeTTL(std::chrono::seconds(10));
+  cache.putError("nx", 80, "Domain name not found");
+  CPPUNIT_ASSERT_EQUAL(std::string("Domain name not found"),
+                       cache.findError("nx", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache.find("nx", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache_.findError("www", 80));
+
+  global::wallclock().advance(std::chrono::seconds(11));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache.findError("nx", 80));
+  global::wallclock().sub(std::chrono::seconds(11));
+
+  // Successful resolution overwrites negative entry.
+  cache.putError("nx", 80, "Timeout");
+  cache.put("nx", "192.168.0.1", 80);
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache.findError("nx", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), cache.find("nx", 80));
+
+  cache.setNegativeTTL(std::chrono::seconds(0));
+  cache.putError("nx2", 80, "Timeout");
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache.findError("nx2", 80));
+}
+
+void DNSCacheTest::testEvict()
+{
+  DNSCache cache(2);
+  cache.put("a", "192.168.0.1", 80);
+  cache.put("b", "192.168.0.2", 80);
+  // Make "a" more recently used than "b".
+  cache.find("a", 80);
+  cache.put("c", "192.168.0.3", 80);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, cache.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), cache.find("a", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache.find("b", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.3"), cache.find("c", 80));
+}
+
+void DNSCacheTest::testSetRTT()
+{
+  cache_.put("www", "192.168.0.2", 80);
+  cache_.setRTT("www", "192.168.0.2", 80, std::chrono::milliseconds(100));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.2"), cache_.find("www", 80));
+  cache_.setRTT("www", "::1", 80, std::chrono::milliseconds(30));
+  std::vector<std::string> addrs;
+  cache_.findAll(std::back_inserter(addrs), "www", 80);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, addrs.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("::1"), addrs[0]);
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.2"), addrs[1]);
+  // Address whose RTT is unknown comes last.
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), addrs[2]);
+  // RTT is smoothed: (30 * 7 + 830) / 8 = 130
+  cache_.setRTT("www", "::1", 80, std::chrono::milliseconds(830));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.2"), cache_.find("www", 80));
+  cache_.markBad("www", "192.168.0.2", 80);
+  CPPUNIT_ASSERT_EQUAL(std::string("::1"), cache_.find("www", 80));
+}
+
 } // namespace aria2
@@ -0,0 +1,208 @@
+#include "DiskIOEngine.h"
+
+#include <cstring>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "DirectDiskAdaptor.h"
+#include "DefaultDiskWriter.h"
+#include "WrDiskCache.h"
+#include "WrDiskCacheEntry.h"
+#include "Piece.h"
+#include "RequestGroup.h"
+#include "DownloadContext.h"
+#include "DownloadResult.h"
+#include "PieceStorage.h"
+#include "Option.h"
+#include "DlAbortEx.h"
+#include "File.h"
+#include "TestUtil.h"
+
+namespace aria2 {
+
+class DiskIOEngineTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(DiskIOEngineTest);
+  CPPUNIT_TEST(testWrite);
+  CPPUNIT_TEST(testWrite_adjacent);
+  CPPUNIT_TEST(testWrite_error);
+  CPPUNIT_TEST(testWriteToDisk);
+  CPPUNIT_TEST(testFlushWrCache_error);
+  CPPUNIT_TEST(testCloseFile_error);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::unique_ptr<DiskIOEngine> engine_;
+
+public:
+  void setUp()
+  {
+    engine_ = make_unique<DiskIOEngine>(2);
+    DiskIOEngine::setInstance(engine_.get());
+  }
+
+  void tearDown() { engine_.reset(); }
+
+  void testWrite();
+  void testWrite_adjacent();
+  void testWrite_error();
+  void testWriteToDisk();
+  void testFlushWrCache_error();
+  void testCloseFile_error();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DiskIOEngineTest);
+
+void DiskIOEngineTest::testWrite()
+{
+  std::string path = A2_TEST_OUT_DIR "/aria2_DiskIOEngineTest_testWrite";
+  File(path).remove();
+  DefaultDiskWriter dw(path);
+  dw.initAndOpenFile();
+  auto buf = std::make_shared<std::string>("hello world");
+  auto data = reinterpret_cast<const unsigned char*>(buf->data());
+  {
+    DiskIOEngine::BufferScope scope(buf);
+    dw.writeData(data + 6, 5, 6);
+    dw.writeData(data, 6, 0);
+    dw.writeData(data, 5, 11);
+  }
+  // The size is only known after pending writes complete.
+  CPPUNIT_ASSERT_EQUAL((int64_t)16, dw.size());
+  CPPUNIT_ASSERT_EQUAL(1L, buf.use_count());
+  dw.closeFile();
+  CPPUNIT_ASSERT_EQUAL(std::string("hello worldhello"), readFile(path));
+}
+
+void DiskIOEngineTest::testWrite_adjacent()
+{
+  std::string path =
+      A2_TEST_OUT_DIR "/aria2_DiskIOEngineTest_testWrite_adjacent";
+  File(path).remove();
+  DefaultDiskWriter dw(path);
+  dw.initAndOpenFile();
+  auto buf1 = std::make_shared<std::string>("0123456789");
+  auto buf2 = std::make_shared<std::string>("abcdefghij");
+  auto data1 = reinterpret_cast<const unsigned char*>(buf1->data());
+  auto data2 = reinterpret_cast<const unsigned char*>(buf2->data());
+  // Contiguous writes are merged into one write if the worker has
+  // not started them yet.
+  for (int i = 0; i < 100; ++i) {
+    {
+      DiskIOEngine::BufferScope scope(buf1);
+      dw.writeData(data1, 5, i * 20);
+      dw.writeData(data1 + 5, 5, i * 20 + 5);
+    }
+    {
+      DiskIOEngine::BufferScope scope(buf2);
+      dw.writeData(data2, 10, i * 20 + 10);
+    }
+  }
+  DiskIOEngine::BufferScope scope(buf1);
+  dw.writeData(data1, 3, 2005);
+  CPPUNIT_ASSERT_EQUAL((int64_t)2008, dw.size());
+  CPPUNIT_ASSERT_EQUAL(1L, buf2.use_count());
+  dw.closeFile();
+  std::string expected;
+  for (int i = 0; i < 100; ++i) {
+    expected += "0123456789abcdefghij";
+  }
+  expected += std::string(5, '\0') + "012";
+  CPPUNIT_ASSERT(expected == readFile(path));
+}
+
+void DiskIOEngineTest::testWrite_error()
+{
+  std::string path = A2_TEST_OUT_DIR "/aria2_DiskIOEngineTest_testWrite_error";
+  createFile(path, 0);
+  DefaultDiskWriter dw(path);
+  dw.enableReadOnly();
+  dw.openExistingFile();
+  auto buf = std::make_shared<std::string>("hello");
+  {
+    DiskIOEngine::BufferScope scope(buf);
+    dw.writeData(reinterpret_cast<const unsigned char*>(buf->data()), 5, 0);
+  }
+  CPPUNIT_ASSERT_THROW(dw.flushOSBuffers(), DlAbortEx);
+  // The error is reported once.
+  dw.flushOSBuffers();
+  engine_->poll();
+}
+
+void DiskIOEngineTest::testWriteToDisk()
+{
+  std::string path = A2_TEST_OUT_DIR "/aria2_DiskIOEngineTest_testWriteToDisk";
+  File(path).remove();
+  auto adaptor = std::make_shared<DirectDiskAdaptor>();
+  {
+    auto dw = make_unique<DefaultDiskWriter>(path);
+    dw->initAndOpenFile();
+    adaptor->setDiskWriter(std::move(dw));
+  }
+  WrDiskCacheEntry e(adaptor);
+  e.cacheData(createDataCell(0, "??01234567", 2));
+  e.cacheData(createDataCell(8, "890"));
+  e.writeToDisk();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e.getSize());
+  CPPUNIT_ASSERT(e.getDataSet().empty());
+  adaptor->closeFile();
+  CPPUNIT_ASSERT_EQUAL(std::string("01234567890"), readFile(path));
+}
+
+void DiskIOEngineTest::testFlushWrCache_error()
+{
+  std::string path =
+      A2_TEST_OUT_DIR "/aria2_DiskIOEngineTest_testFlushWrCache_error";
+  createFile(path, 0);
+  auto adaptor = std::make_shared<DirectDiskAdaptor>();
+  {
+    auto dw = make_unique<DefaultDiskWriter>(path);
+    dw->enableReadOnly();
+    dw->openExistingFile();
+    adaptor->setDiskWriter(std::move(dw));
+  }
+  Piece p(0, 10);
+  WrDiskCache dc(100);
+  p.initWrCache(&dc, adaptor);
+  auto data = new unsigned char[10];
+  memcpy(data, "0123456789", 10);
+  p.updateWrCache(&dc, data, 0, 10, 0);
+  // The failure of the write is known when the piece is flushed, not
+  // on the next write.
+  p.flushWrCache(&dc);
+  CPPUNIT_ASSERT_EQUAL((int)WrDiskCacheEntry::CACHE_ERR_ERROR,
+                       p.getWrDiskCacheEntry()->getError());
+  CPPUNIT_ASSERT_EQUAL(error_code::FILE_IO_ERROR,
+                       p.getWrDiskCacheEntry()->getErrorCode());
+  p.releaseWrCache(&dc);
+  engine_->poll();
+}
+
+void DiskIOEngineTest::testCloseFile_error()
+{
+  std::string path =
+      A2_TEST_OUT_DIR "/aria2_DiskIOEngineTest_testCloseFile_error";
+  createFile(path, 10);
+  auto option = std::make_shared<Option>();
+  RequestGroup group(GroupId::create(), option);
+  group.setDownloadContext(std::make_shared<DownloadContext>(10, 10, path));
+  group.initPieceStorage();
+  auto adaptor = group.getPieceStorage()->getDiskAdaptor();
+  adaptor->enableReadOnly();
+  adaptor->openFile();
+  auto buf = std::make_shared<std::string>("0123456789");
+  {
+    DiskIOEngine::BufferScope scope(buf);
+    adaptor->writeData(reinterpret_cast<const unsigned char*>(buf->data()), 10,
+                       0);
+  }
+  // The last write fails after the last piece is completed.
+  group.getPieceStorage()->markAllPiecesDone();
+  CPPUNIT_ASSERT(group.downloadFinished());
+  group.closeFile();
+  CPPUNIT_ASSERT(!group.downloadFinished());
+  CPPUNIT_ASSERT_EQUAL(error_code::FILE_IO_ERROR,
+                       group.createDownloadResult()->result);
+  engine_->poll();
+}
+
+} // namespace aria2
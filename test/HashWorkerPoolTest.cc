@@ -0,0 +1,115 @@
+#include "HashWorkerPool.h"
+
+#include <chrono>
+
+#include <sys/select.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "WakeupPipe.h"
+#include "util.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class HashWorkerPoolTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(HashWorkerPoolTest);
+  CPPUNIT_TEST(testSubmit);
+  CPPUNIT_TEST(testCancel);
+  CPPUNIT_TEST(testWakeupPipe);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testSubmit();
+  void testCancel();
+  void testWakeupPipe();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HashWorkerPoolTest);
+
+namespace {
+std::vector<unsigned char> toData(const std::string& s)
+{
+  return std::vector<unsigned char>(std::begin(s), std::end(s));
+}
+
+// Calls poll() until all callbacks are invoked.
+void waitAll(HashWorkerPool& pool)
+{
+  for (int i = 0; i < 10000 && pool.getNumPending() > 0; ++i) {
+    pool.poll();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)0, pool.getNumPending());
+}
+} // namespace
+
+namespace {
+// Returns true if the read end of |pipe| becomes readable in |sec|
+// seconds.
+bool waitReadable(WakeupPipe& pipe, int sec)
+{
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(pipe.getReadFd(), &fds);
+  struct timeval tv = {sec, 0};
+  return select(pipe.getReadFd() + 1, &fds, nullptr, nullptr, &tv) == 1;
+}
+} // namespace
+
+void HashWorkerPoolTest::testSubmit()
+{
+  HashWorkerPool pool(2, 4);
+  // A job is accepted whatever its size if the pool is idle.
+  CPPUNIT_ASSERT(pool.hasRoom(1_m));
+  std::string d1, d2;
+  pool.submit(this, "sha-1", toData("hello"),
+              [&](const std::string& digest) { d1 = digest; });
+  pool.submit(this, "md5", toData("world"),
+              [&](const std::string& digest) { d2 = digest; });
+  waitAll(pool);
+  CPPUNIT_ASSERT_EQUAL(std::string("aaf4c61ddcc5e8a2dabede0f3b482cd9aea9434d"),
+                       util::toHex(d1));
+  CPPUNIT_ASSERT_EQUAL(std::string("7d793037a0760186574b0282f2f435e7"),
+                       util::toHex(d2));
+}
+
+void HashWorkerPoolTest::testCancel()
+{
+  HashWorkerPool pool(1, 1_m);
+  int owner1, owner2;
+  int called1 = 0, called2 = 0;
+  for (int i = 0; i < 8; ++i) {
+    pool.submit(&owner1, "sha-1", toData(std::string(64_k, 'a')),
+                [&](const std::string& digest) { ++called1; });
+    pool.submit(&owner2, "sha-1", toData("hello"),
+                [&](const std::string& digest) { ++called2; });
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)16, pool.getNumPending());
+  pool.cancel(&owner1);
+  CPPUNIT_ASSERT_EQUAL((size_t)8, pool.getNumPending());
+  waitAll(pool);
+  CPPUNIT_ASSERT_EQUAL(0, called1);
+  CPPUNIT_ASSERT_EQUAL(8, called2);
+}
+
+void HashWorkerPoolTest::testWakeupPipe()
+{
+  WakeupPipe pipe;
+  HashWorkerPool pool(1, 1_m);
+  pool.setWakeupPipe(&pipe);
+  CPPUNIT_ASSERT(!waitReadable(pipe, 0));
+  std::string d;
+  pool.submit(this, "sha-1", toData("hello"),
+              [&](const std::string& digest) { d = digest; });
+  CPPUNIT_ASSERT(waitReadable(pipe, 10));
+  pipe.drain();
+  CPPUNIT_ASSERT(!waitReadable(pipe, 0));
+  pool.poll();
+  CPPUNIT_ASSERT_EQUAL(std::string("aaf4c61ddcc5e8a2dabede0f3b482cd9aea9434d"),
+                       util::toHex(d));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, pool.getNumPending());
+}
+
+} // namespace aria2
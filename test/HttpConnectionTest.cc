@@ -0,0 +1,140 @@
+#include "HttpConnection.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+#include "HttpHeader.h"
+#include "Request.h"
+#include "Option.h"
+#include "AuthConfigFactory.h"
+#include "PiecedSegment.h"
+#include "Piece.h"
+#include "FileEntry.h"
+#include "SocketCore.h"
+#include "SocketRecvBuffer.h"
+#include "DlRetryEx.h"
+#include "prefs.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class HttpConnectionTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(HttpConnectionTest);
+  CPPUNIT_TEST(testReceiveResponse_idleClose);
+  CPPUNIT_TEST(testReceiveResponse_pipelinedRequestLost);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::unique_ptr<Option> option_;
+  std::unique_ptr<AuthConfigFactory> authConfigFactory_;
+  std::shared_ptr<Request> request_;
+  std::shared_ptr<FileEntry> fileEntry_;
+  std::shared_ptr<SocketCore> server_;
+  std::shared_ptr<SocketCore> client_;
+  std::shared_ptr<SocketCore> inbound_;
+
+  std::unique_ptr<HttpRequest> createHttpRequest(size_t index)
+  {
+    auto httpRequest = make_unique<HttpRequest>();
+    httpRequest->disableContentEncoding();
+    httpRequest->setRequest(request_);
+    httpRequest->setSegment(std::make_shared<PiecedSegment>(
+        1_k, std::make_shared<Piece>(index, 1_k)));
+    httpRequest->setFileEntry(fileEntry_);
+    httpRequest->setAuthConfigFactory(authConfigFactory_.get());
+    httpRequest->setOption(option_.get());
+    httpRequest->setNoWantDigest(true);
+    return httpRequest;
+  }
+
+  std::unique_ptr<HttpResponse> receiveResponse(HttpConnection& conn)
+  {
+    for (;;) {
+      auto res = conn.receiveResponse();
+      if (res) {
+        return res;
+      }
+    }
+  }
+
+public:
+  void setUp()
+  {
+    option_ = make_unique<Option>();
+    option_->put(PREF_HTTP_AUTH_CHALLENGE, A2_V_TRUE);
+    authConfigFactory_ = make_unique<AuthConfigFactory>();
+    request_ = std::make_shared<Request>();
+    request_->supportsPersistentConnection(true);
+    request_->setPipeliningHint(true);
+    request_->setUri("http://localhost/file");
+    fileEntry_ = std::make_shared<FileEntry>("file", 10_k, 0);
+
+    server_ = std::make_shared<SocketCore>();
+    server_->bind(0);
+    server_->beginListen();
+    server_->setBlockingMode();
+    client_ = std::make_shared<SocketCore>();
+    client_->establishConnection("localhost", server_->getAddrInfo().port);
+    while (!client_->isWritable(0)) {
+    }
+    client_->setBlockingMode();
+    inbound_ = server_->acceptConnection();
+    inbound_->setBlockingMode();
+  }
+
+  void testReceiveResponse_idleClose();
+  void testReceiveResponse_pipelinedRequestLost();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HttpConnectionTest);
+
+void HttpConnectionTest::testReceiveResponse_idleClose()
+{
+  HttpConnection conn(1, client_, std::make_shared<SocketRecvBuffer>(client_));
+  conn.sendRequest(createHttpRequest(0));
+  inbound_->writeData("HTTP/1.1 200 OK\r\n"
+                      "Content-Length: 0\r\n"
+                      "\r\n");
+  auto res = receiveResponse(conn);
+  CPPUNIT_ASSERT(!res->getHttpRequest()->isPipelined());
+
+  // The next request is sent alone and the server closes the idle
+  // connection, as it does when its keep-alive timeout expires.
+  conn.sendRequest(createHttpRequest(1));
+  inbound_->closeConnection();
+  try {
+    receiveResponse(conn);
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (DlRetryEx& e) {
+    // success
+  }
+  CPPUNIT_ASSERT(request_->isPipeliningEnabled());
+  CPPUNIT_ASSERT(!request_->isPipeliningDisabled());
+}
+
+void HttpConnectionTest::testReceiveResponse_pipelinedRequestLost()
+{
+  HttpConnection conn(1, client_, std::make_shared<SocketRecvBuffer>(client_));
+  conn.sendRequest(createHttpRequest(0));
+  conn.sendRequest(createHttpRequest(1));
+  // The server answers the first request only and drops the second.
+  inbound_->writeData("HTTP/1.1 200 OK\r\n"
+                      "Content-Length: 0\r\n"
+                      "\r\n");
+  inbound_->closeConnection();
+  receiveResponse(conn);
+  try {
+    receiveResponse(conn);
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (DlRetryEx& e) {
+    // success
+  }
+  CPPUNIT_ASSERT(!request_->isPipeliningEnabled());
+  CPPUNIT_ASSERT(request_->isPipeliningDisabled());
+}
+
+} // namespace aria2
@@ -0,0 +1,160 @@
+// Microbenchmark for HttpHeaderProcessor.  This is not part of the
+// test suite.  Build and run it with:
+//
+//   make -C test HttpHeaderProcessorBench
+//   ./test/HttpHeaderProcessorBench [ITERATIONS]
+//
+// It parses a set of response headers captured from real servers,
+// feeding each of them in small chunks as SocketRecvBuffer does, and
+// reports time and heap allocations per header.
+#include "HttpHeaderProcessor.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "HttpHeader.h"
+
+namespace {
+size_t numAllocs = 0;
+} // namespace
+
+void* operator new(size_t size)
+{
+  ++numAllocs;
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+namespace aria2 {
+
+namespace {
+const char* CAPTURES[] = {
+    // nginx, ranged response from a mirror
+    "HTTP/1.1 206 Partial Content\r\n"
+    "Server: nginx/1.18.0\r\n"
+    "Date: Tue, 14 Mar 2023 09:12:44 GMT\r\n"
+    "Content-Type: application/octet-stream\r\n"
+    "Content-Length: 1048576\r\n"
+    "Last-Modified: Fri, 10 Mar 2023 21:03:11 GMT\r\n"
+    "Connection: keep-alive\r\n"
+    "ETag: \"640b9b0f-3c8a0000\"\r\n"
+    "Content-Range: bytes 4194304-5242879/1015414784\r\n"
+    "\r\n",
+    // Object storage behind a CDN
+    "HTTP/1.1 200 OK\r\n"
+    "x-amz-id-2: "
+    "Xf2OiqT7Ds1ZrjGjT1QHbK9hTiW1H2nCDoCZ8Nd5y3ahzZ5n5ax7Pn4Gx0WAyy0Pm+l5Eec=\r\n"
+    "x-amz-request-id: 4T8H4W0QYTKZ4C3M\r\n"
+    "Date: Tue, 14 Mar 2023 09:12:45 GMT\r\n"
+    "Last-Modified: Wed, 01 Feb 2023 17:40:02 GMT\r\n"
+    "ETag: \"9b2cf535f27731c974343645a3985328-12\"\r\n"
+    "x-amz-server-side-encryption: AES256\r\n"
+    "Accept-Ranges: bytes\r\n"
+    "Content-Type: application/x-tar\r\n"
+    "Server: AmazonS3\r\n"
+    "Content-Length: 201326592\r\n"
+    "Via: 1.1 3e1c8a5f0e1d3f4a.cloudfront.net (CloudFront)\r\n"
+    "X-Cache: Miss from cloudfront\r\n"
+    "X-Amz-Cf-Pop: FRA56-P5\r\n"
+    "X-Amz-Cf-Id: r0i9yO6y2S0TzH4mE1eR6PjSnr0aE4GMqgMBi5H9q0h0YcA1hbvE4w==\r\n"
+    "Age: 371\r\n"
+    "\r\n",
+    // Redirect from a download portal
+    "HTTP/1.1 302 Found\r\n"
+    "Date: Tue, 14 Mar 2023 09:12:46 GMT\r\n"
+    "Content-Type: text/html; charset=UTF-8\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: keep-alive\r\n"
+    "Location: https://mirror.example.org/pub/releases/22.04/"
+    "ubuntu-22.04.2-desktop-amd64.iso\r\n"
+    "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+    "Set-Cookie: __cf_bm=Z0l4cQ.w1_6yJ3RCu9ltlG0dQm; path=/; "
+    "expires=Tue, 14-Mar-23 09:42:46 GMT; domain=.example.org; HttpOnly\r\n"
+    "Set-Cookie: session=8d3a7b; Path=/; Secure\r\n"
+    "Link: <https://mirror2.example.org/pub/releases/22.04/"
+    "ubuntu-22.04.2-desktop-amd64.iso>; rel=duplicate; pri=2\r\n"
+    "Server: cloudflare\r\n"
+    "CF-RAY: 7a7a4c1a5ef72c3d-FRA\r\n"
+    "\r\n",
+    // Apache, Digest challenge
+    "HTTP/1.1 401 Unauthorized\r\n"
+    "Date: Tue, 14 Mar 2023 09:12:47 GMT\r\n"
+    "Server: Apache/2.4.41 (Ubuntu)\r\n"
+    "WWW-Authenticate: Digest realm=\"private\", "
+    "nonce=\"KP9rXbH1BQA=4e9fa1bd7d58b7e6f00e3e4bd3c9ec0e52b1f8cd\", "
+    "algorithm=MD5, qop=\"auth\"\r\n"
+    "Content-Length: 381\r\n"
+    "Keep-Alive: timeout=5, max=100\r\n"
+    "Connection: Keep-Alive\r\n"
+    "Content-Type: text/html; charset=iso-8859-1\r\n"
+    "\r\n",
+    // Chunked, gzip encoded API response
+    "HTTP/1.1 200 OK\r\n"
+    "Server: gunicorn\r\n"
+    "Date: Tue, 14 Mar 2023 09:12:48 GMT\r\n"
+    "Connection: keep-alive\r\n"
+    "Transfer-Encoding: chunked\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Encoding: gzip\r\n"
+    "Vary: Accept-Encoding, Cookie\r\n"
+    "X-Frame-Options: DENY\r\n"
+    "Strict-Transport-Security: max-age=31536000; includeSubDomains\r\n"
+    "X-Content-Type-Options: nosniff\r\n"
+    "Referrer-Policy: same-origin\r\n"
+    "\r\n"};
+} // namespace
+
+} // namespace aria2
+
+int main(int argc, char** argv)
+{
+  using namespace aria2;
+  const size_t chunkSize = 512;
+  size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+  std::vector<std::string> captures(std::begin(CAPTURES), std::end(CAPTURES));
+
+  HttpHeaderProcessor proc(HttpHeaderProcessor::CLIENT_PARSER);
+  size_t bytes = 0;
+  size_t allocs = numAllocs;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    for (const auto& s : captures) {
+      auto data = reinterpret_cast<const unsigned char*>(s.data());
+      for (size_t off = 0; off < s.size();) {
+        auto len = std::min(chunkSize, s.size() - off);
+        if (proc.parse(data + off, len)) {
+          break;
+        }
+        off += proc.getLastBytesProcessed();
+      }
+      auto header = proc.getResult();
+      if (header->getStatusCode() < 200) {
+        fprintf(stderr, "Unexpected parse result\n");
+        return EXIT_FAILURE;
+      }
+      bytes += s.size();
+      proc.clear();
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  allocs = numAllocs - allocs;
+  size_t n = iterations * captures.size();
+  printf("headers: %zu\n", n);
+  printf("ns/header: %.1f\n", static_cast<double>(elapsed) / n);
+  printf("MB/s: %.1f\n", bytes * 1000.0 / elapsed);
+  printf("allocations/header: %.2f\n", static_cast<double>(allocs) / n);
+  return EXIT_SUCCESS;
+}
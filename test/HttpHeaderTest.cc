@@ -12,17 +12,27 @@ class HttpHeaderTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(HttpHeaderTest);
   CPPUNIT_TEST(testGetRange);
   CPPUNIT_TEST(testFindAll);
+  CPPUNIT_TEST(testFindAll_interleaved);
   CPPUNIT_TEST(testClearField);
   CPPUNIT_TEST(testFieldContains);
   CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST(testParseAuthChallenge);
+  CPPUNIT_TEST(testParseAuthChallenges);
+  CPPUNIT_TEST(testParseAuthChallenges_malformed);
+  CPPUNIT_TEST(testParseAuthParams);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void testGetRange();
   void testFindAll();
+  void testFindAll_interleaved();
   void testClearField();
   void testFieldContains();
   void testRemove();
+  void testParseAuthChallenge();
+  void testParseAuthChallenges();
+  void testParseAuthChallenges_malformed();
+  void testParseAuthParams();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(HttpHeaderTest);
@@ -151,6 +161,30 @@ void HttpHeaderTest::testFindAll()
   CPPUNIT_ASSERT_EQUAL(std::string("101"), r[1]);
 }
 
+void HttpHeaderTest::testFindAll_interleaved()
+{
+  HttpHeader h;
+  h.put(HttpHeader::SET_COOKIE, "a=1");
+  h.put(HttpHeader::CONTENT_LENGTH, "100");
+  h.put(HttpHeader::LINK, "<http://a/>");
+  h.put(HttpHeader::SET_COOKIE, "b=2");
+  h.put(HttpHeader::ACCEPT_ENCODING, "gzip");
+  h.put(HttpHeader::SET_COOKIE, "c=3");
+
+  auto r = h.findAll(HttpHeader::SET_COOKIE);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, r.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("a=1"), r[0]);
+  CPPUNIT_ASSERT_EQUAL(std::string("b=2"), r[1]);
+  CPPUNIT_ASSERT_EQUAL(std::string("c=3"), r[2]);
+  CPPUNIT_ASSERT_EQUAL(std::string("a=1"), h.find(HttpHeader::SET_COOKIE));
+  CPPUNIT_ASSERT_EQUAL(std::string("100"), h.find(HttpHeader::CONTENT_LENGTH));
+  CPPUNIT_ASSERT_EQUAL(std::string("gzip"),
+                       h.find(HttpHeader::ACCEPT_ENCODING));
+  CPPUNIT_ASSERT(!h.defined(HttpHeader::LOCATION));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), h.find(HttpHeader::LOCATION));
+  CPPUNIT_ASSERT(h.findAll(HttpHeader::LOCATION).empty());
+}
+
 void HttpHeaderTest::testClearField()
 {
   HttpHeader h;
@@ -197,4 +231,160 @@ void HttpHeaderTest::testRemove()
   CPPUNIT_ASSERT(h.defined(HttpHeader::CONNECTION));
 }
 
+void HttpHeaderTest::testParseAuthChallenge()
+{
+  HttpHeader h;
+  CPPUNIT_ASSERT_EQUAL(AUTH_NONE, h.getAuthScheme());
+
+  h.parseAuthChallenge("Digest realm=\"testrealm@host.com\", "
+                       "qop=\"auth\", "
+                       "nonce=\"dcd98b7102dd2f0e8b11d0f600bfb0c093\", "
+                       "stale=TRUE");
+  // Digest is preferred over Basic
+  h.parseAuthChallenge("Basic realm=\"testrealm@host.com\"");
+  CPPUNIT_ASSERT_EQUAL(AUTH_DIGEST, h.getAuthScheme());
+  auto params = h.getDigestAuthParams();
+  CPPUNIT_ASSERT_EQUAL(std::string("testrealm@host.com"), params->realm);
+  CPPUNIT_ASSERT_EQUAL(std::string("auth"), params->qop);
+  CPPUNIT_ASSERT_EQUAL(std::string("dcd98b7102dd2f0e8b11d0f600bfb0c093"),
+                       params->serverNonce);
+  CPPUNIT_ASSERT(params->stale);
+  CPPUNIT_ASSERT_EQUAL((uint32_t)0, params->nonceCount);
+
+  // Strongest supported algorithm wins regardless of order
+  HttpHeader h2;
+  h2.parseAuthChallenge("Digest realm=\"r\", nonce=\"n1\", algorithm=MD5");
+  h2.parseAuthChallenge("Digest realm=\"r\", nonce=\"n2\", "
+                        "algorithm=SHA-256-sess, qop=\"auth-int\"");
+  h2.parseAuthChallenge("Digest realm=\"r\", nonce=\"n3\", algorithm=UNKNOWN");
+  CPPUNIT_ASSERT_EQUAL(AUTH_DIGEST, h2.getAuthScheme());
+  params = h2.getDigestAuthParams();
+  CPPUNIT_ASSERT_EQUAL(std::string("n2"), params->serverNonce);
+  CPPUNIT_ASSERT_EQUAL(std::string("SHA-256-sess"), params->algorithm);
+  CPPUNIT_ASSERT_EQUAL(std::string("auth-int"), params->qop);
+
+  // Unsupported algorithm only
+  HttpHeader h3;
+  h3.parseAuthChallenge("Digest realm=\"r\", nonce=\"n\", algorithm=FOO");
+  CPPUNIT_ASSERT_EQUAL(AUTH_NONE, h3.getAuthScheme());
+}
+
+void HttpHeaderTest::testParseAuthChallenges()
+{
+  auto res = parseAuthChallenges(
+      "Newauth realm=\"apps\", type=1, title=\"Login to \\\"apps\\\"\", "
+      "Basic realm=\"simple\"");
+  CPPUNIT_ASSERT_EQUAL((size_t)2, res.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("Newauth"), res[0].scheme);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, res[0].params.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("realm"), res[0].params[0].first);
+  CPPUNIT_ASSERT_EQUAL(std::string("apps"), res[0].params[0].second);
+  CPPUNIT_ASSERT_EQUAL(std::string("type"), res[0].params[1].first);
+  CPPUNIT_ASSERT_EQUAL(std::string("1"), res[0].params[1].second);
+  CPPUNIT_ASSERT_EQUAL(std::string("title"), res[0].params[2].first);
+  CPPUNIT_ASSERT_EQUAL(std::string("Login to \"apps\""),
+                       res[0].params[2].second);
+  CPPUNIT_ASSERT_EQUAL(std::string("Basic"), res[1].scheme);
+  CPPUNIT_ASSERT_EQUAL(std::string("simple"), res[1].params[0].second);
+
+  // Quoted commas, BWS around '=' and token68
+  res = parseAuthChallenges("Negotiate abc==, Digest Realm = \"a,b\" ,"
+                            " qop=\"auth-int,auth\",,nonce=n");
+  CPPUNIT_ASSERT_EQUAL((size_t)2, res.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("Negotiate"), res[0].scheme);
+  CPPUNIT_ASSERT(res[0].params.empty());
+  CPPUNIT_ASSERT_EQUAL(std::string("Digest"), res[1].scheme);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, res[1].params.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("realm"), res[1].params[0].first);
+  CPPUNIT_ASSERT_EQUAL(std::string("a,b"), res[1].params[0].second);
+  CPPUNIT_ASSERT_EQUAL(std::string("auth-int,auth"), res[1].params[1].second);
+  CPPUNIT_ASSERT_EQUAL(std::string("n"), res[1].params[2].second);
+
+  // Digest challenge with opaque, domain and userhash in the same
+  // header field as Basic.
+  HttpHeader h;
+  h.parseAuthChallenge(
+      "Basic realm=\"r\", Digest realm=\"r\", nonce=\"n\", "
+      "opaque=\"5ccc069c403ebaf9f0171e9517f40e41\", stale=false, "
+      "domain=\"/private/  http://localhost/other/\", userhash=true");
+  CPPUNIT_ASSERT_EQUAL(AUTH_DIGEST, h.getAuthScheme());
+  auto params = h.getDigestAuthParams();
+  CPPUNIT_ASSERT_EQUAL(std::string("5ccc069c403ebaf9f0171e9517f40e41"),
+                       params->opaque);
+  CPPUNIT_ASSERT(!params->stale);
+  CPPUNIT_ASSERT(params->userhash);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, params->domain.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("/private/"), params->domain[0]);
+  CPPUNIT_ASSERT_EQUAL(std::string("http://localhost/other/"),
+                       params->domain[1]);
+}
+
+void HttpHeaderTest::testParseAuthChallenges_malformed()
+{
+  // None of them must crash or loop forever.
+  const char* corpus[] = {
+      "",
+      " ",
+      ",",
+      ",,, ,",
+      "=",
+      "==",
+      "\"",
+      "\"\"\"",
+      "Digest",
+      "Digest ",
+      "Digest ,",
+      "Digest =",
+      "Digest realm",
+      "Digest realm=",
+      "Digest realm=\"",
+      "Digest realm=\"\\",
+      "Digest realm=\"abc\\\"",
+      "Digest realm=\"a\"\"b\", nonce=1",
+      "Digest realm==\"x\"",
+      "Digest =x, nonce=y",
+      "Digest \"realm\"=x",
+      "Digest realm=x nonce=y",
+      "Digest realm=x,, ,nonce=y,",
+      "Digest\trealm=x",
+      "Basic, Digest, Bearer",
+      "\t Digest realm=x \t",
+  };
+  for (auto s : corpus) {
+    parseAuthChallenges(s);
+    HttpHeader h;
+    h.parseAuthChallenge(s);
+  }
+
+  auto res = parseAuthChallenges("Digest =x, nonce=y");
+  CPPUNIT_ASSERT_EQUAL((size_t)1, res.size());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, res[0].params.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("nonce"), res[0].params[0].first);
+
+  res = parseAuthChallenges("Digest realm=\"unterminated");
+  CPPUNIT_ASSERT_EQUAL((size_t)1, res.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("unterminated"), res[0].params[0].second);
+
+  res = parseAuthChallenges("Basic, Digest, Bearer");
+  CPPUNIT_ASSERT_EQUAL((size_t)3, res.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("Bearer"), res[2].scheme);
+}
+
+void HttpHeaderTest::testParseAuthParams()
+{
+  auto res = parseAuthParams("NextNonce=\"0a4f113b\", qop=auth, "
+                             "rspauth=\"6629fae4\", cnonce=\"x\\\"y\", "
+                             "nc=00000001");
+  CPPUNIT_ASSERT_EQUAL((size_t)5, res.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("nextnonce"), res[0].first);
+  CPPUNIT_ASSERT_EQUAL(std::string("0a4f113b"), res[0].second);
+  CPPUNIT_ASSERT_EQUAL(std::string("auth"), res[1].second);
+  CPPUNIT_ASSERT_EQUAL(std::string("6629fae4"), res[2].second);
+  CPPUNIT_ASSERT_EQUAL(std::string("x\"y"), res[3].second);
+  CPPUNIT_ASSERT_EQUAL(std::string("00000001"), res[4].second);
+
+  CPPUNIT_ASSERT(parseAuthParams("").empty());
+  CPPUNIT_ASSERT(parseAuthParams(" , ,").empty());
+}
+
 } // namespace aria2
@@ -54,6 +54,8 @@ class HttpResponseTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testSupportsPersistentConnection);
   CPPUNIT_TEST(testGetMetalinKHttpEntries);
   CPPUNIT_TEST(testGetDigest);
+  CPPUNIT_TEST(testCreateAuthStat);
+  CPPUNIT_TEST(testProcessAuthChallenge);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -86,6 +88,8 @@ public:
   void testSupportsPersistentConnection();
   void testGetMetalinKHttpEntries();
   void testGetDigest();
+  void testCreateAuthStat();
+  void testProcessAuthChallenge();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(HttpResponseTest);
@@ -691,4 +695,109 @@ void HttpResponseTest::testGetDigest()
                        util::toHex(c.getDigest()));
 }
 
+void HttpResponseTest::testCreateAuthStat()
+{
+  Option option;
+  option.put(PREF_NO_NETRC, A2_V_TRUE);
+  option.put(PREF_HTTP_USER, "aria2user");
+  option.put(PREF_HTTP_PASSWD, "aria2password");
+  AuthConfigFactory authConfigFactory;
+  auto params = make_unique<DigestAuthParams>();
+  params->realm = "aria2";
+  params->serverNonce = "dcd98b7102dd2f0e8b11d0f600bfb0c093";
+  params->qop = "auth";
+  CPPUNIT_ASSERT(authConfigFactory.activateAuthCred(
+      "localhost", 80, "/", &option, std::move(params)));
+
+  auto request = std::make_shared<Request>();
+  request->setUri("http://localhost/aria2-1.0.0.tar.bz2");
+  auto httpRequest = make_unique<HttpRequest>();
+  httpRequest->setRequest(request);
+  httpRequest->setAuthConfigFactory(&authConfigFactory);
+  httpRequest->setOption(&option);
+  // The first response to the challenge is not preemptive.
+  httpRequest->createRequest();
+
+  HttpResponse httpResponse;
+  httpResponse.setHttpHeader(make_unique<HttpHeader>());
+  httpResponse.getHttpHeader()->setStatusCode(200);
+  httpResponse.setHttpRequest(std::move(httpRequest));
+
+  auto stat = httpResponse.createAuthStat();
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, stat.challenges);
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, stat.preemptiveHits);
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, stat.preemptiveMisses);
+
+  // The cached nonce is reused.
+  httpResponse.getHttpRequest()->createRequest();
+  stat = httpResponse.createAuthStat();
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, stat.preemptiveHits);
+
+  httpResponse.getHttpHeader()->setStatusCode(401);
+  httpResponse.getHttpHeader()->parseAuthChallenge(
+      "Digest realm=\"aria2\", nonce=\"0a4f113b\", stale=true");
+  stat = httpResponse.createAuthStat();
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, stat.challenges);
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, stat.preemptiveHits);
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, stat.preemptiveMisses);
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, stat.staleNonceRetries);
+  CPPUNIT_ASSERT(stat.retryTime >= 0);
+
+  AuthStat total;
+  total += stat;
+  total += stat;
+  CPPUNIT_ASSERT_EQUAL((int64_t)2, total.challenges);
+}
+
+void HttpResponseTest::testProcessAuthChallenge()
+{
+  Option option;
+  option.put(PREF_HTTP_USER, "aria2user");
+  option.put(PREF_HTTP_PASSWD, "aria2password");
+  AuthConfigFactory authConfigFactory;
+  auto params = make_unique<DigestAuthParams>();
+  params->realm = "aria2";
+  params->serverNonce = "dcd98b7102dd2f0e8b11d0f600bfb0c093";
+  params->qop = "auth";
+  CPPUNIT_ASSERT(authConfigFactory.activateAuthCred(
+      "localhost", 80, "/", &option, std::move(params)));
+
+  auto request = std::make_shared<Request>();
+  request->setUri("http://localhost/aria2-1.0.0.tar.bz2");
+  auto httpRequest = make_unique<HttpRequest>();
+  httpRequest->setRequest(request);
+  httpRequest->setAuthConfigFactory(&authConfigFactory);
+  httpRequest->setOption(&option);
+  httpRequest->createRequest();
+
+  HttpResponse httpResponse;
+  httpResponse.setHttpHeader(make_unique<HttpHeader>());
+  httpResponse.getHttpHeader()->setStatusCode(401);
+  httpResponse.setHttpRequest(std::move(httpRequest));
+
+  // The credentials sent for the fresh challenge were rejected.
+  httpResponse.getHttpHeader()->parseAuthChallenge(
+      "Digest realm=\"aria2\", nonce=\"0a4f113b\", qop=\"auth\"");
+  CPPUNIT_ASSERT(!httpResponse.processAuthChallenge(&option));
+
+  // The request built from nextnonce is sent with nc=1, but it was not
+  // an answer to a challenge, so the new challenge is answered.
+  CPPUNIT_ASSERT(authConfigFactory.updateDigestAuthInfo(
+      request, *httpResponse.getHttpRequest()->getAuthConfig(),
+      "nextnonce=\"f2/wE4q74E6zIJEt\""));
+  httpResponse.getHttpRequest()->createRequest();
+  const auto& authConfig = httpResponse.getHttpRequest()->getAuthConfig();
+  CPPUNIT_ASSERT_EQUAL((uint32_t)1, authConfig->getNonceCount());
+  CPPUNIT_ASSERT(authConfig->isPreemptive());
+  httpResponse.getHttpHeader()->parseAuthChallenge(
+      "Digest realm=\"aria2\", nonce=\"0a4f113b\", qop=\"auth\"");
+  CPPUNIT_ASSERT(httpResponse.processAuthChallenge(&option));
+
+  // Answering that challenge is rejected again.
+  httpResponse.getHttpRequest()->createRequest();
+  httpResponse.getHttpHeader()->parseAuthChallenge(
+      "Digest realm=\"aria2\", nonce=\"0a4f113b\", qop=\"auth\"");
+  CPPUNIT_ASSERT(!httpResponse.processAuthChallenge(&option));
+}
+
 } // namespace aria2
@@ -9,6 +9,7 @@
 #include "DiskAdaptor.h"
 #include "FileEntry.h"
 #include "PieceSelector.h"
+#include "HashWorkerPool.h"
 
 namespace aria2 {
 
@@ -17,6 +18,7 @@ class IteratableChunkChecksumValidatorTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(IteratableChunkChecksumValidatorTest);
   CPPUNIT_TEST(testValidate);
   CPPUNIT_TEST(testValidate_readError);
+  CPPUNIT_TEST(testValidate_hashWorkerPool);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -27,6 +29,7 @@ public:
 
   void testValidate();
   void testValidate_readError();
+  void testValidate_hashWorkerPool();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(IteratableChunkChecksumValidatorTest);
@@ -106,4 +109,40 @@ void IteratableChunkChecksumValidatorTest::testValidate_readError()
   CPPUNIT_ASSERT(!ps->hasPiece(4));
 }
 
+void IteratableChunkChecksumValidatorTest::testValidate_hashWorkerPool()
+{
+  // Only 1 piece fits in the memory limit at a time.
+  HashWorkerPool pool(2, 150);
+  HashWorkerPool::setInstance(&pool);
+  Option option;
+  std::shared_ptr<DownloadContext> dctx(new DownloadContext(
+      100, 250, A2_TEST_DIR "/chunkChecksumTestFile250.txt"));
+  std::deque<std::string> hashes(&csArray[0], &csArray[3]);
+  hashes[1] = fromHex("ffffffffffffffffffffffffffffffffffffffff");
+  dctx->setPieceHashes("sha-1", hashes.begin(), hashes.end());
+  std::shared_ptr<DefaultPieceStorage> ps(
+      new DefaultPieceStorage(dctx, &option));
+  ps->initStorage();
+  ps->getDiskAdaptor()->enableReadOnly();
+  ps->getDiskAdaptor()->openFile();
+
+  IteratableChunkChecksumValidator validator(dctx, ps);
+  validator.init();
+
+  validator.validateChunk();
+  CPPUNIT_ASSERT(!validator.finished());
+  CPPUNIT_ASSERT(validator.waiting());
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, validator.getCurrentOffset());
+
+  while (!validator.finished()) {
+    pool.poll();
+    validator.validateChunk();
+  }
+  CPPUNIT_ASSERT_EQUAL((int64_t)250, validator.getCurrentOffset());
+  CPPUNIT_ASSERT(ps->hasPiece(0));
+  CPPUNIT_ASSERT(!ps->hasPiece(1));
+  CPPUNIT_ASSERT(ps->hasPiece(2));
+  HashWorkerPool::setInstance(nullptr);
+}
+
 } // namespace aria2
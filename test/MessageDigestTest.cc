@@ -70,6 +70,14 @@ void MessageDigestTest::testDigest()
   CPPUNIT_ASSERT_EQUAL(std::string("024d0127"),
                        util::toHex(adler32_->digest()));
 #endif // HAVE_ZLIB
+
+  if (MessageDigest::supports("sha-512-256")) {
+    auto sha512_256 = MessageDigest::create("sha-512-256");
+    sha512_256->update("abc", 3);
+    CPPUNIT_ASSERT_EQUAL(std::string("53048e2681941ef99b2e29b76b4c7dabe4c2d0c6"
+                                     "34fc6d46e0e2f13107e7af23"),
+                         util::toHex(sha512_256->digest()));
+  }
 }
 
 void MessageDigestTest::testSupports()
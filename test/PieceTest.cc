@@ -20,6 +20,7 @@ class PieceTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testAppendWrCache);
 
   CPPUNIT_TEST(testGetDigestWithWrCache);
+  CPPUNIT_TEST(testGetDataWithWrCache);
   CPPUNIT_TEST(testUpdateHash);
 
   CPPUNIT_TEST_SUITE_END();
@@ -43,6 +44,7 @@ public:
   void testAppendWrCache();
 
   void testGetDigestWithWrCache();
+  void testGetDataWithWrCache();
   void testUpdateHash();
 };
 
@@ -139,6 +141,26 @@ void PieceTest::testGetDigestWithWrCache()
       util::toHex(p.getDigestWithWrCache(p.getLength(), adaptor_)));
 }
 
+void PieceTest::testGetDataWithWrCache()
+{
+  unsigned char* data;
+  Piece p(1, 10);
+  WrDiskCache dc(64);
+  //                  01234567890123456789
+  writer_->setString("??????????abc..f..ij");
+  p.initWrCache(&dc, adaptor_);
+  data = new unsigned char[2];
+  memcpy(data, "de", 2);
+  p.updateWrCache(&dc, data, 0, 2, 13);
+  data = new unsigned char[2];
+  memcpy(data, "gh", 2);
+  p.updateWrCache(&dc, data, 0, 2, 16);
+
+  auto buf = p.getDataWithWrCache(10, adaptor_);
+  CPPUNIT_ASSERT_EQUAL(std::string("abcdefghij"),
+                       std::string(std::begin(buf), std::end(buf)));
+}
+
 void PieceTest::testUpdateHash()
 {
   Piece p(0, 16, 2_m);
@@ -0,0 +1,180 @@
+#include "PredictiveURISelector.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ServerStatMan.h"
+#include "ServerStat.h"
+#include "FileEntry.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class PredictiveURISelectorTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(PredictiveURISelectorTest);
+  CPPUNIT_TEST(testSelect_withoutServerStat);
+  CPPUNIT_TEST(testSelect);
+  CPPUNIT_TEST(testSelect_latency);
+  CPPUNIT_TEST(testSelect_errorRate);
+  CPPUNIT_TEST(testSelect_withUsedHosts);
+  CPPUNIT_TEST(testSelect_unknownLatency);
+  CPPUNIT_TEST(testSelect_explorationCap);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  FileEntry fileEntry_;
+
+  std::shared_ptr<ServerStatMan> ssm;
+
+  std::shared_ptr<PredictiveURISelector> sel;
+
+  std::vector<std::pair<size_t, std::string>> usedHosts_;
+
+  std::shared_ptr<ServerStat> addServerStat(const std::string& host,
+                                            int speed)
+  {
+    auto ss = std::make_shared<ServerStat>(host, "http");
+    ss->updateDownloadSpeed(speed);
+    ssm->add(ss);
+    return ss;
+  }
+
+public:
+  void setUp()
+  {
+    fileEntry_.setUris(
+        {"http://alpha/file", "http://bravo/file", "http://charlie/file"});
+    fileEntry_.setLength(10_m);
+
+    ssm.reset(new ServerStatMan());
+    sel.reset(new PredictiveURISelector(ssm));
+    usedHosts_.clear();
+  }
+
+  void tearDown() {}
+
+  void testSelect_withoutServerStat();
+
+  void testSelect();
+
+  void testSelect_latency();
+
+  void testSelect_errorRate();
+
+  void testSelect_withUsedHosts();
+
+  void testSelect_unknownLatency();
+
+  void testSelect_explorationCap();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PredictiveURISelectorTest);
+
+void PredictiveURISelectorTest::testSelect_withoutServerStat()
+{
+  CPPUNIT_ASSERT_EQUAL(std::string("http://alpha/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, fileEntry_.getRemainingUris().size());
+}
+
+void PredictiveURISelectorTest::testSelect()
+{
+  addServerStat("alpha", 100_k);
+  addServerStat("bravo", 1_m);
+  addServerStat("charlie", 500_k)->setError();
+
+  CPPUNIT_ASSERT_EQUAL(std::string("http://bravo/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+  CPPUNIT_ASSERT_EQUAL(std::string("http://alpha/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+  // All remaining servers are in error state.
+  CPPUNIT_ASSERT_EQUAL(std::string("http://charlie/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), sel->select(&fileEntry_, usedHosts_));
+}
+
+void PredictiveURISelectorTest::testSelect_latency()
+{
+  fileEntry_.setLength(10_k);
+  auto alpha = addServerStat("alpha", 1_m);
+  auto bravo = addServerStat("bravo", 100_k);
+  auto charlie = addServerStat("charlie", 100_k);
+  alpha->addConnectTime(std::chrono::seconds(2));
+  alpha->addTTFB(std::chrono::seconds(2));
+  bravo->addConnectTime(std::chrono::milliseconds(20));
+  bravo->addTTFB(std::chrono::milliseconds(50));
+  charlie->addConnectTime(std::chrono::milliseconds(20));
+  charlie->addTTFB(std::chrono::milliseconds(500));
+
+  // For small file, latency dominates.
+  CPPUNIT_ASSERT_EQUAL(std::string("http://bravo/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+}
+
+void PredictiveURISelectorTest::testSelect_errorRate()
+{
+  addServerStat("alpha", 1_m)->setErrorRate(0.8);
+  addServerStat("bravo", 800_k);
+  // charlie has no ServerStat and is assumed to be as fast as alpha.
+
+  CPPUNIT_ASSERT_EQUAL(std::string("http://charlie/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+  CPPUNIT_ASSERT_EQUAL(std::string("http://bravo/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+  CPPUNIT_ASSERT_EQUAL(std::string("http://alpha/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+}
+
+void PredictiveURISelectorTest::testSelect_withUsedHosts()
+{
+  addServerStat("alpha", 1_m);
+  addServerStat("bravo", 500_k);
+  addServerStat("charlie", 100_k);
+  usedHosts_.push_back(std::make_pair(1, "alpha"));
+  usedHosts_.push_back(std::make_pair(1, "bravo"));
+
+  CPPUNIT_ASSERT_EQUAL(std::string("http://charlie/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+  // If all hosts are used, the best one is selected.
+  CPPUNIT_ASSERT_EQUAL(std::string("http://alpha/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+}
+
+void PredictiveURISelectorTest::testSelect_unknownLatency()
+{
+  fileEntry_.setUris(
+      {"http://alpha/file", "http://bravo/file", "http://charlie/file",
+       "http://delta/file"});
+  fileEntry_.setLength(10_k);
+  auto alpha = addServerStat("alpha", 1_m);
+  auto bravo = addServerStat("bravo", 1_m);
+  auto delta = addServerStat("delta", 1_m);
+  alpha->addConnectTime(std::chrono::seconds(1));
+  alpha->addTTFB(std::chrono::seconds(1));
+  bravo->addConnectTime(std::chrono::milliseconds(20));
+  bravo->addTTFB(std::chrono::milliseconds(50));
+  delta->addConnectTime(std::chrono::milliseconds(100));
+  delta->addTTFB(std::chrono::milliseconds(400));
+  // charlie has no ServerStat and gets the median latency, which is
+  // delta's.  It is not assumed to be faster than bravo.
+
+  CPPUNIT_ASSERT_EQUAL(std::string("http://bravo/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+}
+
+void PredictiveURISelectorTest::testSelect_explorationCap()
+{
+  addServerStat("alpha", 1_m)->setErrorRate(0.5);
+  // bravo and charlie have no ServerStat.  Only one of them is
+  // explored.
+
+  CPPUNIT_ASSERT_EQUAL(std::string("http://bravo/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+  CPPUNIT_ASSERT_EQUAL(std::string("http://alpha/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+  // Nothing else is left.
+  CPPUNIT_ASSERT_EQUAL(std::string("http://charlie/file"),
+                       sel->select(&fileEntry_, usedHosts_));
+}
+
+} // namespace aria2
@@ -0,0 +1,135 @@
+#include "RdDiskCache.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "TestUtil.h"
+#include "DirectDiskAdaptor.h"
+#include "ByteArrayDiskWriter.h"
+#include "WrDiskCache.h"
+#include "WrDiskCacheEntry.h"
+#include "DlAbortEx.h"
+
+namespace aria2 {
+
+class RdDiskCacheTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(RdDiskCacheTest);
+  CPPUNIT_TEST(testReadData);
+  CPPUNIT_TEST(testReadData_tooLarge);
+  CPPUNIT_TEST(testEnsureLimit);
+  CPPUNIT_TEST(testEnsureLimit_wrDiskCache);
+  CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::shared_ptr<DirectDiskAdaptor> adaptor_;
+  ByteArrayDiskWriter* writer_;
+
+public:
+  void setUp()
+  {
+    adaptor_ = std::make_shared<DirectDiskAdaptor>();
+    auto dw = make_unique<ByteArrayDiskWriter>();
+    writer_ = dw.get();
+    writer_->setString("0123456789abcdefghijklmnopqrstuvwxyz");
+    adaptor_->setDiskWriter(std::move(dw));
+  }
+
+  // Reads |len| bytes at |begin| in the 10 bytes long piece |index|.
+  std::string read(RdDiskCache& cache, const void* owner, size_t index,
+                   size_t begin, size_t len)
+  {
+    unsigned char buf[10];
+    if (!cache.readData(buf, len, begin, owner, index, index * 10, 10,
+                        adaptor_.get())) {
+      return "";
+    }
+    return std::string(&buf[0], &buf[len]);
+  }
+
+  void testReadData();
+  void testReadData_tooLarge();
+  void testEnsureLimit();
+  void testEnsureLimit_wrDiskCache();
+  void testRemove();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RdDiskCacheTest);
+
+void RdDiskCacheTest::testReadData()
+{
+  RdDiskCache cache(100, nullptr);
+  CPPUNIT_ASSERT_EQUAL(std::string("bcd"), read(cache, this, 1, 1, 3));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getNumPieces());
+  CPPUNIT_ASSERT_EQUAL((size_t)10, cache.getSize());
+  // The whole piece was read ahead.
+  writer_->setString("");
+  CPPUNIT_ASSERT_EQUAL(std::string("efghij"), read(cache, this, 1, 4, 6));
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, cache.getStat().hits);
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, cache.getStat().misses);
+  // The block is not in the piece.
+  CPPUNIT_ASSERT_EQUAL(std::string(""), read(cache, this, 1, 5, 6));
+  // Short read
+  CPPUNIT_ASSERT_THROW(read(cache, this, 2, 0, 3), DlAbortEx);
+}
+
+void RdDiskCacheTest::testReadData_tooLarge()
+{
+  RdDiskCache cache(19, nullptr);
+  CPPUNIT_ASSERT_EQUAL(std::string(""), read(cache, this, 0, 0, 3));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getNumPieces());
+}
+
+void RdDiskCacheTest::testEnsureLimit()
+{
+  RdDiskCache cache(25, nullptr);
+  read(cache, this, 0, 0, 1);
+  read(cache, this, 1, 0, 1);
+  // Piece 0 becomes the most recently used.
+  read(cache, this, 0, 0, 1);
+  read(cache, this, 2, 0, 1);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, cache.getNumPieces());
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, cache.getStat().evictions);
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, cache.getStat().hits);
+  read(cache, this, 0, 0, 1);
+  read(cache, this, 2, 0, 1);
+  CPPUNIT_ASSERT_EQUAL((int64_t)3, cache.getStat().hits);
+  read(cache, this, 1, 0, 1);
+  CPPUNIT_ASSERT_EQUAL((int64_t)4, cache.getStat().misses);
+}
+
+void RdDiskCacheTest::testEnsureLimit_wrDiskCache()
+{
+  WrDiskCache wrDiskCache(30);
+  RdDiskCache cache(30, &wrDiskCache);
+  read(cache, this, 0, 0, 1);
+  read(cache, this, 1, 0, 1);
+  CPPUNIT_ASSERT_EQUAL((size_t)20, cache.getSize());
+  WrDiskCacheEntry e(adaptor_);
+  e.cacheData(createDataCell(0, "who knows?"));
+  CPPUNIT_ASSERT(wrDiskCache.add(&e));
+  // The downloaded data take precedence.
+  cache.ensureLimit();
+  CPPUNIT_ASSERT_EQUAL((size_t)20, cache.getSize());
+  e.cacheData(createDataCell(10, "!"));
+  CPPUNIT_ASSERT(wrDiskCache.update(&e, 1));
+  cache.ensureLimit();
+  CPPUNIT_ASSERT_EQUAL((size_t)10, cache.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("b"), read(cache, this, 1, 1, 1));
+  CPPUNIT_ASSERT(wrDiskCache.remove(&e));
+}
+
+void RdDiskCacheTest::testRemove()
+{
+  int owner;
+  RdDiskCache cache(100, nullptr);
+  read(cache, this, 0, 0, 1);
+  read(cache, &owner, 0, 0, 1);
+  read(cache, this, 1, 0, 1);
+  cache.remove(this);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getNumPieces());
+  CPPUNIT_ASSERT_EQUAL((size_t)10, cache.getSize());
+  read(cache, &owner, 0, 0, 1);
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, cache.getStat().hits);
+}
+
+} // namespace aria2
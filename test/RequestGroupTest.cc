@@ -7,6 +7,9 @@
 #include "FileEntry.h"
 #include "PieceStorage.h"
 #include "DownloadResult.h"
+#include "DownloadEngine.h"
+#include "SelectEventPoll.h"
+#include "ConnectionScaler.h"
 
 namespace aria2 {
 
@@ -16,6 +19,7 @@ class RequestGroupTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetFirstFilePath);
   CPPUNIT_TEST(testTryAutoFileRenaming);
   CPPUNIT_TEST(testCreateDownloadResult);
+  CPPUNIT_TEST(testReleaseRuntimeResource_connectionScaler);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -27,6 +31,7 @@ public:
   void testGetFirstFilePath();
   void testTryAutoFileRenaming();
   void testCreateDownloadResult();
+  void testReleaseRuntimeResource_connectionScaler();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RequestGroupTest);
@@ -147,4 +152,20 @@ void RequestGroupTest::testCreateDownloadResult()
   }
 }
 
+void RequestGroupTest::testReleaseRuntimeResource_connectionScaler()
+{
+  DownloadEngine e(make_unique<SelectEventPoll>());
+  RequestGroup group(GroupId::create(), option_);
+  group.setDownloadContext(
+      std::make_shared<DownloadContext>(1_k, 1_k, "/tmp/myfile"));
+  auto scaler = make_unique<ConnectionScaler>(1, 5);
+  group.setNumConcurrentCommand(scaler->getTarget());
+  group.setConnectionScaler(std::move(scaler));
+
+  group.releaseRuntimeResource(&e);
+  // The scaler starts over when the download is restarted.
+  CPPUNIT_ASSERT(!group.getConnectionScaler());
+  CPPUNIT_ASSERT_EQUAL(5, group.getNumConcurrentCommand());
+}
+
 } // namespace aria2
@@ -19,10 +19,12 @@ class SegmentManTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testNullBitfield);
   CPPUNIT_TEST(testCompleteSegment);
   CPPUNIT_TEST(testGetSegment_sameFileEntry);
+  CPPUNIT_TEST(testGetPipelinedSegment);
   CPPUNIT_TEST(testRegisterPeerStat);
   CPPUNIT_TEST(testCancelAllSegments);
   CPPUNIT_TEST(testGetPeerStat);
   CPPUNIT_TEST(testGetCleanSegmentIfOwnerIsIdle);
+  CPPUNIT_TEST(testStealSegment);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -45,10 +47,12 @@ public:
   void testNullBitfield();
   void testCompleteSegment();
   void testGetSegment_sameFileEntry();
+  void testGetPipelinedSegment();
   void testRegisterPeerStat();
   void testCancelAllSegments();
   void testGetPeerStat();
   void testGetCleanSegmentIfOwnerIsIdle();
+  void testStealSegment();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SegmentManTest);
@@ -144,6 +148,32 @@ void SegmentManTest::testGetSegment_sameFileEntry()
   CPPUNIT_ASSERT_EQUAL((size_t)3, segments.size());
 }
 
+void SegmentManTest::testGetPipelinedSegment()
+{
+  size_t minSplitSize = 1_m;
+  std::vector<std::shared_ptr<Segment>> segments;
+  segmentMan_->getPipelinedSegment(segments, 1, minSplitSize, 3);
+  // Segments are contiguous
+  CPPUNIT_ASSERT_EQUAL((size_t)3, segments.size());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, segments[0]->getIndex());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, segments[1]->getIndex());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, segments[2]->getIndex());
+
+  // The next segment is taken by another connection.
+  CPPUNIT_ASSERT(segmentMan_->getSegmentWithIndex(2, 3));
+  segmentMan_->getPipelinedSegment(segments, 1, minSplitSize, 4);
+  CPPUNIT_ASSERT_EQUAL((size_t)4, segments.size());
+  CPPUNIT_ASSERT(segments[3]->getIndex() > 3);
+
+  // Up to the last piece
+  segmentMan_->cancelSegment(1);
+  segments.clear();
+  segments.push_back(segmentMan_->getSegmentWithIndex(1, 63));
+  segmentMan_->getPipelinedSegment(segments, 1, minSplitSize, 2);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, segments.size());
+  CPPUNIT_ASSERT(segments[1]->getIndex() < 63);
+}
+
 void SegmentManTest::testRegisterPeerStat()
 {
   Option op;
@@ -195,4 +225,33 @@ void SegmentManTest::testGetCleanSegmentIfOwnerIsIdle()
   CPPUNIT_ASSERT(!segmentMan_->getCleanSegmentIfOwnerIsIdle(5, 1));
 }
 
+void SegmentManTest::testStealSegment()
+{
+  size_t minSplitSize = 20_m;
+  // Pieces 0-57 are done.  cuid#1 has piece 58 and its range extends
+  // to the last piece.
+  pieceStorage_->markPiecesDone(58_m);
+  std::shared_ptr<Segment> seg1 = segmentMan_->getSegmentWithIndex(1, 58);
+  CPPUNIT_ASSERT(seg1);
+  // The remaining free run is too short to split.
+  CPPUNIT_ASSERT(!segmentMan_->getSegment(2, minSplitSize));
+
+  // cuid#2 takes the second half of the run, so that cuid#1 has 3
+  // pieces to download instead of 6.
+  std::shared_ptr<Segment> seg2 = segmentMan_->stealSegment(2);
+  CPPUNIT_ASSERT(seg2);
+  CPPUNIT_ASSERT_EQUAL((size_t)61, seg2->getIndex());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, segmentMan_->countFreePieceFrom(59));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, segmentMan_->countFreePieceFrom(62));
+
+  // Connection never steals from itself.
+  segmentMan_->cancelSegment(2);
+  CPPUNIT_ASSERT_EQUAL((size_t)5, segmentMan_->countFreePieceFrom(59));
+  segmentMan_->cancelSegment(1);
+  segmentMan_->getSegmentWithIndex(1, 62);
+  CPPUNIT_ASSERT(!segmentMan_->stealSegment(1));
+  // Run shorter than 2 pieces is not split.
+  CPPUNIT_ASSERT(!segmentMan_->stealSegment(2));
+}
+
 } // namespace aria2
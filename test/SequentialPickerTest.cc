@@ -10,10 +10,12 @@ class SequentialPickerTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(SequentialPickerTest);
   CPPUNIT_TEST(testPick);
+  CPPUNIT_TEST(testPick_maxPicked);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void testPick();
+  void testPick_maxPicked();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SequentialPickerTest);
@@ -48,4 +50,38 @@ void SequentialPickerTest::testPick()
   CPPUNIT_ASSERT(!picker.hasNext());
 }
 
+void SequentialPickerTest::testPick_maxPicked()
+{
+  SequentialPicker<int> picker;
+  picker.setMaxPicked(2);
+
+  picker.pushEntry(make_unique<int>(1));
+  picker.pushEntry(make_unique<int>(2));
+  picker.pushEntry(make_unique<int>(3));
+
+  CPPUNIT_ASSERT(picker.canPickNext());
+  picker.pickNext();
+  CPPUNIT_ASSERT(picker.canPickNext());
+  auto second = picker.pickNext();
+  CPPUNIT_ASSERT(!picker.canPickNext());
+  CPPUNIT_ASSERT(picker.hasNext());
+
+  CPPUNIT_ASSERT_EQUAL((size_t)2, picker.getPickedEntries().size());
+  CPPUNIT_ASSERT_EQUAL(1, *picker.getPickedEntry());
+  CPPUNIT_ASSERT_EQUAL(second, picker.findPickedEntry(
+                                   [](const int& i) { return i == 2; }));
+  CPPUNIT_ASSERT(!picker.findPickedEntry([](const int& i) { return i == 3; }));
+
+  picker.dropPickedEntry(second);
+
+  CPPUNIT_ASSERT_EQUAL((size_t)1, picker.getPickedEntries().size());
+  CPPUNIT_ASSERT_EQUAL(1, *picker.getPickedEntry());
+  CPPUNIT_ASSERT(picker.canPickNext());
+
+  picker.pickNext();
+
+  CPPUNIT_ASSERT_EQUAL(3, *picker.getPickedEntries().back());
+  CPPUNIT_ASSERT(!picker.hasNext());
+}
+
 } // namespace aria2
@@ -18,6 +18,7 @@ class ServerStatManTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testAddAndFind);
   CPPUNIT_TEST(testSave);
   CPPUNIT_TEST(testLoad);
+  CPPUNIT_TEST(testLoad_predictiveFields);
   CPPUNIT_TEST(testRemoveStaleServerStat);
   CPPUNIT_TEST_SUITE_END();
 
@@ -29,6 +30,7 @@ public:
   void testAddAndFind();
   void testSave();
   void testLoad();
+  void testLoad_predictiveFields();
   void testRemoveStaleServerStat();
 };
 
@@ -143,6 +145,43 @@ void ServerStatManTest::testLoad()
   CPPUNIT_ASSERT_EQUAL(ServerStat::A2_ERROR, mirror->getStatus());
 }
 
+void ServerStatManTest::testLoad_predictiveFields()
+{
+  const char* filename =
+      A2_TEST_OUT_DIR "/aria2_ServerStatManTest_testLoad_predictiveFields";
+  std::string in =
+      "host=localhost, protocol=http, dl_speed=25000, last_updated=1210000000, "
+      "status=OK, ewma_speed=24000, error_rate=0.1250, connect_time=0:0:3, "
+      "ttfb=0:0:0:1:1\n"
+      // Malformed sketch; this line is ignored.
+      "host=mirror, protocol=http, dl_speed=0, last_updated=1210000002, "
+      "status=OK, ttfb=1:x\n";
+  BufferedFile fp(filename, BufferedFile::WRITE);
+  CPPUNIT_ASSERT_EQUAL((size_t)in.size(), fp.write(in.data(), in.size()));
+  CPPUNIT_ASSERT(fp.close() != EOF);
+
+  ServerStatMan ssm;
+  CPPUNIT_ASSERT(ssm.load(filename));
+
+  auto localhost_http = ssm.find("localhost", "http");
+  CPPUNIT_ASSERT(localhost_http);
+  CPPUNIT_ASSERT_EQUAL(24000, localhost_http->getThroughputEwma());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.125, localhost_http->getErrorRate(), 1e-9);
+  CPPUNIT_ASSERT_EQUAL(3u, localhost_http->getConnectTime().getCount());
+  CPPUNIT_ASSERT_EQUAL(std::string("0:0:0:1:1"),
+                       localhost_http->getTTFB().toString());
+  // Saved line is loaded back as is.
+  CPPUNIT_ASSERT_EQUAL(std::string("host=localhost, protocol=http,"
+                                   " dl_speed=25000, sc_avg_speed=0,"
+                                   " mc_avg_speed=0, last_updated=1210000000,"
+                                   " counter=0, status=OK, ewma_speed=24000,"
+                                   " error_rate=0.1250, connect_time=0:0:3,"
+                                   " ttfb=0:0:0:1:1"),
+                       localhost_http->toString());
+
+  CPPUNIT_ASSERT(!ssm.find("mirror", "http"));
+}
+
 void ServerStatManTest::testRemoveStaleServerStat()
 {
   Time now;
@@ -15,6 +15,9 @@ class ServerStatTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ServerStatTest);
   CPPUNIT_TEST(testSetStatus);
   CPPUNIT_TEST(testToString);
+  CPPUNIT_TEST(testToString_predictiveFields);
+  CPPUNIT_TEST(testUpdateDownloadSpeed);
+  CPPUNIT_TEST(testLatencySketch);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -24,6 +27,9 @@ public:
 
   void testSetStatus();
   void testToString();
+  void testToString_predictiveFields();
+  void testUpdateDownloadSpeed();
+  void testLatencySketch();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ServerStatTest);
@@ -71,4 +77,91 @@ void ServerStatTest::testToString()
       localhost_ftp.toString());
 }
 
+void ServerStatTest::testToString_predictiveFields()
+{
+  ServerStat ss("localhost", "http");
+  ss.setLastUpdated(Time(1000));
+  ss.setThroughputEwma(4096);
+  ss.setErrorRate(0.25);
+  ss.addConnectTime(std::chrono::milliseconds(3));
+  ss.addTTFB(std::chrono::milliseconds(0));
+
+  CPPUNIT_ASSERT_EQUAL(
+      std::string("host=localhost, protocol=http, dl_speed=0,"
+                  " sc_avg_speed=0, mc_avg_speed=0,"
+                  " last_updated=1000, counter=0, status=OK,"
+                  " ewma_speed=4096, error_rate=0.2500,"
+                  " connect_time=0:0:1, ttfb=1"),
+      ss.toString());
+}
+
+void ServerStatTest::testUpdateDownloadSpeed()
+{
+  ServerStat ss("localhost", "http");
+  ss.updateDownloadSpeed(1000);
+  CPPUNIT_ASSERT_EQUAL(1000, ss.getThroughputEwma());
+  ss.updateDownloadSpeed(2000);
+  CPPUNIT_ASSERT_EQUAL(1300, ss.getThroughputEwma());
+  // 0 is not a sample of throughput
+  ss.updateDownloadSpeed(0);
+  CPPUNIT_ASSERT_EQUAL(1300, ss.getThroughputEwma());
+
+  ss.setError();
+  CPPUNIT_ASSERT(ss.isError());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.3, ss.getErrorRate(), 1e-9);
+  ss.setError();
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.51, ss.getErrorRate(), 1e-9);
+  ss.updateDownloadSpeed(1300);
+  CPPUNIT_ASSERT(ss.isOK());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.357, ss.getErrorRate(), 1e-9);
+
+  auto now = Time(1000);
+  ss.setLastUpdated(now);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, ss.getRecencyWeight(now), 1e-9);
+  ss.setLastUpdated(Time(1000 - 7 * 24 * 3600));
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, ss.getRecencyWeight(now), 1e-9);
+}
+
+void ServerStatTest::testLatencySketch()
+{
+  LatencySketch sketch;
+  CPPUNIT_ASSERT(sketch.empty());
+  CPPUNIT_ASSERT_EQUAL(0.0, sketch.percentile(0.5));
+  CPPUNIT_ASSERT_EQUAL(std::string(), sketch.toString());
+
+  // [8, 16)
+  sketch.add(std::chrono::milliseconds(10));
+  sketch.add(std::chrono::milliseconds(12));
+  // [64, 128)
+  sketch.add(std::chrono::milliseconds(100));
+  sketch.add(std::chrono::milliseconds(127));
+  CPPUNIT_ASSERT_EQUAL(4u, sketch.getCount());
+  CPPUNIT_ASSERT_EQUAL(std::string("0:0:0:0:2:0:0:2"), sketch.toString());
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(16.0, sketch.percentile(0.5), 1e-9);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(96.0, sketch.percentile(0.75), 1e-9);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(128.0, sketch.percentile(1.0), 1e-9);
+
+  // Very long samples go to the last bucket.
+  LatencySketch s2;
+  s2.add(std::chrono::hours(1));
+  CPPUNIT_ASSERT_EQUAL(std::string("0:0:0:0:0:0:0:0:0:0:0:0:0:0:0:1"),
+                       s2.toString());
+
+  // Old samples are aged out.
+  LatencySketch s3;
+  for (size_t i = 0; i < LatencySketch::AGE_THRESHOLD; ++i) {
+    s3.add(std::chrono::milliseconds(1));
+  }
+  CPPUNIT_ASSERT_EQUAL(LatencySketch::AGE_THRESHOLD / 2, s3.getCount());
+
+  LatencySketch s4;
+  CPPUNIT_ASSERT(s4.parse("0:0:0:0:2:0:0:2"));
+  CPPUNIT_ASSERT_EQUAL(4u, s4.getCount());
+  CPPUNIT_ASSERT_EQUAL(sketch.toString(), s4.toString());
+  CPPUNIT_ASSERT(!s4.parse("1::2"));
+  CPPUNIT_ASSERT(!s4.parse("a"));
+  CPPUNIT_ASSERT(!s4.parse("0:0:0:0:0:0:0:0:0:0:0:0:0:0:0:0:1"));
+  CPPUNIT_ASSERT_EQUAL(4u, s4.getCount());
+}
+
 } // namespace aria2
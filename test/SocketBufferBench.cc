@@ -0,0 +1,122 @@
+// Microbenchmark for SocketBuffer.  This is not part of the test
+// suite.  Build and run it with:
+//
+//   make -C test SocketBufferBench
+//   ./test/SocketBufferBench [ITERATIONS]
+//
+// It emulates a seeding BitTorrent peer which flushes a deep queue of
+// have messages and piece messages at once, and reports time and the
+// number of write system calls per flush.  System calls are counted
+// on Linux only.
+#include "SocketBuffer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#endif // __linux__
+
+#include "SocketCore.h"
+#include "a2functional.h"
+
+namespace {
+size_t numWrites = 0;
+} // namespace
+
+#ifdef __linux__
+extern "C" ssize_t writev(int fd, const struct iovec* iov, int iovcnt)
+{
+  ++numWrites;
+  return syscall(SYS_writev, fd, iov, iovcnt);
+}
+
+extern "C" ssize_t send(int fd, const void* buf, size_t len, int flags)
+{
+  ++numWrites;
+  return syscall(SYS_sendto, fd, buf, len, flags, nullptr, 0);
+}
+#endif // __linux__
+
+namespace aria2 {
+
+namespace {
+// The number of have messages and piece messages queued per flush.
+const size_t NUM_HAVES = 64;
+const size_t NUM_PIECES = 16;
+const size_t BLOCK_LENGTH = 16_k;
+
+std::vector<unsigned char> createMessage(size_t payloadLength)
+{
+  // 4 bytes length prefix followed by message ID and payload.  The
+  // contents do not matter here.
+  return std::vector<unsigned char>(4 + payloadLength, 0);
+}
+} // namespace
+
+} // namespace aria2
+
+int main(int argc, char** argv)
+{
+  using namespace aria2;
+  size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000;
+
+  SocketCore server;
+  server.bind(0);
+  server.beginListen();
+  server.setBlockingMode();
+  auto client = std::make_shared<SocketCore>();
+  client->establishConnection("localhost", server.getAddrInfo().port);
+  while (!client->isWritable(0)) {
+  }
+  auto peer = server.acceptConnection();
+  peer->setNonBlockingMode();
+
+  SocketBuffer buf(client);
+  std::vector<unsigned char> sink(1_m);
+  size_t bytes = 0;
+  size_t flushes = 0;
+  size_t writes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    for (size_t j = 0; j < NUM_HAVES; ++j) {
+      buf.pushBytes(createMessage(5));
+    }
+    for (size_t j = 0; j < NUM_PIECES; ++j) {
+      buf.pushBytes(createMessage(9 + BLOCK_LENGTH));
+    }
+    // Flush until the queue is empty as the event loop would do on
+    // each writable event.
+    while (!buf.sendBufferIsEmpty()) {
+      size_t before = numWrites;
+      bytes += buf.send();
+      writes += numWrites - before;
+      ++flushes;
+      for (;;) {
+        size_t len = sink.size();
+        peer->readData(sink.data(), len);
+        if (len == 0) {
+          break;
+        }
+      }
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  printf("flushes: %zu\n", flushes);
+  printf("us/flush: %.2f\n", static_cast<double>(elapsed) / 1000 / flushes);
+  printf("MB/s: %.1f\n", bytes * 1000.0 / elapsed);
+#ifdef __linux__
+  printf("write syscalls/flush: %.2f\n",
+         static_cast<double>(writes) / flushes);
+#else  // !__linux__
+  printf("write syscalls/flush: n/a\n");
+#endif // !__linux__
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include "SocketBuffer.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SocketCore.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class SocketBufferTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SocketBufferTest);
+  CPPUNIT_TEST(testSend);
+  CPPUNIT_TEST(testSend_partial);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::shared_ptr<SocketCore> client_;
+  std::shared_ptr<SocketCore> peer_;
+
+public:
+  void setUp()
+  {
+    SocketCore server;
+    server.bind(0);
+    server.beginListen();
+    server.setBlockingMode();
+    client_ = std::make_shared<SocketCore>();
+    client_->establishConnection("localhost", server.getAddrInfo().port);
+    while (!client_->isWritable(0)) {
+    }
+    peer_ = server.acceptConnection();
+    peer_->setNonBlockingMode();
+  }
+
+  void testSend();
+  void testSend_partial();
+
+  // Reads all data available in peer_.
+  std::string receive()
+  {
+    std::string res;
+    char buf[16_k];
+    for (;;) {
+      size_t len = sizeof(buf);
+      peer_->readData(buf, len);
+      if (len == 0) {
+        return res;
+      }
+      res.append(buf, len);
+    }
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SocketBufferTest);
+
+namespace {
+struct ProgressCounter : public ProgressUpdate {
+  ProgressCounter(size_t& length, size_t& complete)
+      : length(length), complete(complete)
+  {
+  }
+  virtual void update(size_t len, bool comp) CXX11_OVERRIDE
+  {
+    length += len;
+    if (comp) {
+      ++complete;
+    }
+  }
+  size_t& length;
+  size_t& complete;
+};
+} // namespace
+
+void SocketBufferTest::testSend()
+{
+  SocketBuffer buf(client_);
+  size_t length = 0, complete = 0;
+  buf.pushStr("hello", make_unique<ProgressCounter>(length, complete));
+  buf.pushBytes(std::vector<unsigned char>{' ', 'a', 'r', 'i', 'a', '2'},
+                make_unique<ProgressCounter>(length, complete));
+  buf.pushStr("");
+  buf.pushStr(" world", make_unique<ProgressCounter>(length, complete));
+  CPPUNIT_ASSERT_EQUAL((size_t)3, buf.getBufferEntrySize());
+  CPPUNIT_ASSERT_EQUAL((ssize_t)17, buf.send());
+  CPPUNIT_ASSERT(buf.sendBufferIsEmpty());
+  CPPUNIT_ASSERT_EQUAL((size_t)17, length);
+  CPPUNIT_ASSERT_EQUAL((size_t)3, complete);
+  peer_->isReadable(1);
+  CPPUNIT_ASSERT_EQUAL(std::string("hello aria2 world"), receive());
+}
+
+void SocketBufferTest::testSend_partial()
+{
+  // Queue more data than the kernel accepts at once, so that some
+  // writes stop in the middle of an entry.
+  SocketBuffer buf(client_);
+  std::string expected;
+  size_t length = 0, complete = 0;
+  for (size_t i = 0; i < 512; ++i) {
+    std::string s(i % 2 == 0 ? 9 : 16_k + 13, 'a' + i % 26);
+    expected += s;
+    buf.pushStr(std::move(s), make_unique<ProgressCounter>(length, complete));
+  }
+  std::string received;
+  size_t sent = 0;
+  for (int i = 0; i < 10000 && !buf.sendBufferIsEmpty(); ++i) {
+    sent += buf.send();
+    peer_->isReadable(0);
+    received += receive();
+  }
+  CPPUNIT_ASSERT(buf.sendBufferIsEmpty());
+  CPPUNIT_ASSERT_EQUAL(expected.size(), sent);
+  CPPUNIT_ASSERT_EQUAL(expected.size(), length);
+  CPPUNIT_ASSERT_EQUAL((size_t)512, complete);
+  while (received.size() < expected.size() && peer_->isReadable(1)) {
+    received += receive();
+  }
+  CPPUNIT_ASSERT(expected == received);
+}
+
+} // namespace aria2
@@ -0,0 +1,163 @@
+#include "SocketPool.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SocketCore.h"
+#include "wallclock.h"
+#include "A2STR.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+class SocketPoolTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SocketPoolTest);
+  CPPUNIT_TEST(testAddAndPop);
+  CPPUNIT_TEST(testMaxSizePerHost);
+  CPPUNIT_TEST(testMaxSize);
+  CPPUNIT_TEST(testEvictExpired);
+  CPPUNIT_TEST(testManyHosts);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testAddAndPop();
+  void testMaxSizePerHost();
+  void testMaxSize();
+  void testEvictExpired();
+  void testManyHosts();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SocketPoolTest);
+
+namespace {
+SocketPoolKey createKey(const std::string& host)
+{
+  return SocketPoolKey(host, 80, A2STR::NIL, A2STR::NIL, 0);
+}
+} // namespace
+
+void SocketPoolTest::testAddAndPop()
+{
+  SocketPool pool;
+  auto s1 = std::make_shared<SocketCore>();
+  auto s2 = std::make_shared<SocketCore>();
+  pool.add(createKey("192.168.0.1"), s1, "a", std::chrono::seconds(15));
+  pool.add(createKey("192.168.0.1"), s2, "b", std::chrono::seconds(15));
+  pool.add(SocketPoolKey("192.168.0.1", 80, "alice", A2STR::NIL, 0),
+           std::make_shared<SocketCore>(), A2STR::NIL,
+           std::chrono::seconds(15));
+  CPPUNIT_ASSERT_EQUAL((size_t)3, pool.size());
+
+  std::string options;
+  // The most recently pooled socket comes first.
+  CPPUNIT_ASSERT(s2 == pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT_EQUAL(std::string("b"), options);
+  CPPUNIT_ASSERT(s1 == pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT_EQUAL(std::string("a"), options);
+  CPPUNIT_ASSERT(!pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT(!pool.pop(options, createKey("192.168.0.2")));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, pool.size());
+
+  CPPUNIT_ASSERT_EQUAL((int64_t)2, pool.getStat().hits);
+  CPPUNIT_ASSERT_EQUAL((int64_t)2, pool.getStat().misses);
+}
+
+void SocketPoolTest::testMaxSizePerHost()
+{
+  SocketPool pool(10, 2);
+  auto s1 = std::make_shared<SocketCore>();
+  auto s2 = std::make_shared<SocketCore>();
+  auto s3 = std::make_shared<SocketCore>();
+  pool.add(createKey("192.168.0.1"), s1, A2STR::NIL, std::chrono::seconds(15));
+  pool.add(createKey("192.168.0.1"), s2, A2STR::NIL, std::chrono::seconds(15));
+  pool.add(createKey("192.168.0.1"), s3, A2STR::NIL, std::chrono::seconds(15));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pool.size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, pool.getStat().evictions);
+
+  std::string options;
+  CPPUNIT_ASSERT(s3 == pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT(s2 == pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT(!pool.pop(options, createKey("192.168.0.1")));
+}
+
+void SocketPoolTest::testMaxSize()
+{
+  SocketPool pool(2, 2);
+  auto s1 = std::make_shared<SocketCore>();
+  auto s2 = std::make_shared<SocketCore>();
+  auto s3 = std::make_shared<SocketCore>();
+  pool.add(createKey("192.168.0.1"), s1, A2STR::NIL, std::chrono::seconds(15));
+  pool.add(createKey("192.168.0.2"), s2, A2STR::NIL, std::chrono::seconds(15));
+  pool.add(createKey("192.168.0.3"), s3, A2STR::NIL, std::chrono::seconds(15));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, pool.size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, pool.getStat().evictions);
+
+  std::string options;
+  CPPUNIT_ASSERT(!pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT(s2 == pool.pop(options, createKey("192.168.0.2")));
+  CPPUNIT_ASSERT(s3 == pool.pop(options, createKey("192.168.0.3")));
+}
+
+void SocketPoolTest::testEvictExpired()
+{
+  SocketPool pool;
+  auto s1 = std::make_shared<SocketCore>();
+  auto s2 = std::make_shared<SocketCore>();
+  pool.add(createKey("192.168.0.1"), s1, A2STR::NIL, std::chrono::seconds(5));
+  pool.add(createKey("192.168.0.1"), s2, A2STR::NIL,
+           std::chrono::seconds(15));
+
+  global::wallclock().advance(std::chrono::seconds(10));
+  pool.evictExpired();
+  CPPUNIT_ASSERT_EQUAL((size_t)1, pool.size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, pool.getStat().timeouts);
+
+  global::wallclock().advance(std::chrono::seconds(10));
+  std::string options;
+  CPPUNIT_ASSERT(!pool.pop(options, createKey("192.168.0.1")));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, pool.size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)2, pool.getStat().timeouts);
+
+  global::wallclock().sub(std::chrono::seconds(20));
+}
+
+void SocketPoolTest::testManyHosts()
+{
+  const size_t n = 500;
+  auto key = [](size_t i) {
+    return createKey(fmt("192.168.%lu.%lu", static_cast<unsigned long>(i / 256),
+                         static_cast<unsigned long>(i % 256)));
+  };
+  SocketPool pool(n, 2);
+  std::vector<std::shared_ptr<SocketCore>> sockets;
+  for (size_t i = 0; i < n; ++i) {
+    sockets.push_back(std::make_shared<SocketCore>());
+    pool.add(key(i), sockets.back(), A2STR::NIL,
+             std::chrono::seconds(i % 2 == 0 ? 5 : 15));
+  }
+  CPPUNIT_ASSERT_EQUAL(n, pool.size());
+  // Closes the socket for the first host.
+  pool.add(createKey("192.168.255.0"), std::make_shared<SocketCore>(),
+           A2STR::NIL, std::chrono::seconds(15));
+  CPPUNIT_ASSERT_EQUAL(n, pool.size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, pool.getStat().evictions);
+
+  std::string options;
+  for (size_t i = 1; i < n; i += 3) {
+    CPPUNIT_ASSERT(sockets[i] == pool.pop(options, key(i)));
+  }
+  global::wallclock().advance(std::chrono::seconds(10));
+  pool.evictExpired();
+  for (size_t i = 0; i < n; ++i) {
+    auto socket = pool.pop(options, key(i));
+    if (i % 2 == 1 && i % 3 != 1) {
+      CPPUNIT_ASSERT(sockets[i] == socket);
+    }
+    else {
+      CPPUNIT_ASSERT(!socket);
+    }
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)1, pool.size());
+  global::wallclock().sub(std::chrono::seconds(10));
+}
+
+} // namespace aria2
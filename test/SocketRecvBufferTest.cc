@@ -0,0 +1,166 @@
+#include "SocketRecvBuffer.h"
+
+#include <cstring>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SocketCore.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class SocketRecvBufferTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SocketRecvBufferTest);
+  CPPUNIT_TEST(testCapacity);
+  CPPUNIT_TEST(testRecv_compact);
+  CPPUNIT_TEST(testRecv_grow);
+  CPPUNIT_TEST(testRecv_memoryLimit);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testCapacity();
+  void testRecv_compact();
+  void testRecv_grow();
+  void testRecv_memoryLimit();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SocketRecvBufferTest);
+
+void SocketRecvBufferTest::testCapacity()
+{
+  CPPUNIT_ASSERT_EQUAL(SocketRecvBuffer::MIN_CAPACITY,
+                       SocketRecvBuffer(nullptr).getCapacity());
+  CPPUNIT_ASSERT_EQUAL(SocketRecvBuffer::MIN_CAPACITY,
+                       SocketRecvBuffer(nullptr, 1_k).getCapacity());
+  CPPUNIT_ASSERT_EQUAL((size_t)256_k,
+                       SocketRecvBuffer(nullptr, 256_k).getCapacity());
+
+  SocketRecvBuffer::setDefaultCapacity(256_k);
+  CPPUNIT_ASSERT_EQUAL((size_t)256_k, SocketRecvBuffer(nullptr).getCapacity());
+  SocketRecvBuffer::setDefaultCapacity(0);
+  CPPUNIT_ASSERT_EQUAL(SocketRecvBuffer::MIN_CAPACITY,
+                       SocketRecvBuffer::getDefaultCapacity());
+}
+
+void SocketRecvBufferTest::testRecv_compact()
+{
+  SocketCore server;
+  server.bind(0);
+  server.beginListen();
+  server.setBlockingMode();
+
+  SocketCore client;
+  client.establishConnection("localhost", server.getAddrInfo().port);
+  while (!client.isWritable(0)) {
+  }
+  client.setBlockingMode();
+
+  std::shared_ptr<SocketCore> inbound = server.acceptConnection();
+  inbound->setBlockingMode();
+
+  const size_t capacity = SocketRecvBuffer::MIN_CAPACITY;
+  std::string data;
+  for (size_t i = 0; i < capacity; ++i) {
+    data += static_cast<char>('a' + i % 26);
+  }
+  client.writeData(data);
+
+  SocketRecvBuffer buf(inbound, capacity);
+  while (buf.getBufferLength() < capacity) {
+    CPPUNIT_ASSERT(buf.recv() > 0);
+  }
+  // Buffer is full and nothing has been consumed yet.
+  CPPUNIT_ASSERT_EQUAL((ssize_t)0, buf.recv());
+
+  buf.drain(10);
+  client.writeData("0123456789");
+  size_t received = 0;
+  while (received < 10) {
+    auto n = buf.recv();
+    CPPUNIT_ASSERT(n > 0);
+    received += n;
+  }
+  CPPUNIT_ASSERT_EQUAL(capacity, buf.getBufferLength());
+  CPPUNIT_ASSERT(memcmp(data.data() + 10, buf.getBuffer(), capacity - 10) ==
+                 0);
+  CPPUNIT_ASSERT(memcmp("0123456789", buf.getBuffer() + capacity - 10, 10) ==
+                 0);
+}
+
+namespace {
+// Returns the inbound end of a connection in non-blocking mode after
+// data is written from the other end.
+std::shared_ptr<SocketCore> receiveData(const std::string& data)
+{
+  SocketCore server;
+  server.bind(0);
+  server.beginListen();
+  server.setBlockingMode();
+
+  SocketCore client;
+  client.establishConnection("localhost", server.getAddrInfo().port);
+  while (!client.isWritable(0)) {
+  }
+  client.setBlockingMode();
+
+  std::shared_ptr<SocketCore> inbound = server.acceptConnection();
+  client.writeData(data);
+  client.closeConnection();
+  inbound->setNonBlockingMode();
+  return inbound;
+}
+} // namespace
+
+void SocketRecvBufferTest::testRecv_grow()
+{
+  const size_t length = 100_k;
+  std::string data(length, 'a');
+  size_t total = SocketRecvBuffer::getTotalCapacity();
+  {
+    SocketRecvBuffer buf(receiveData(data));
+    CPPUNIT_ASSERT_EQUAL(SocketRecvBuffer::MIN_CAPACITY, buf.getCapacity());
+    CPPUNIT_ASSERT_EQUAL(total + buf.getCapacity(),
+                         SocketRecvBuffer::getTotalCapacity());
+    for (int i = 0; i < 1000 && buf.getBufferLength() < length; ++i) {
+      buf.getSocket()->isReadable(1);
+      buf.recv();
+    }
+    CPPUNIT_ASSERT_EQUAL(length, buf.getBufferLength());
+    // 16K -> 32K -> 64K -> 128K
+    CPPUNIT_ASSERT_EQUAL((size_t)128_k, buf.getCapacity());
+    CPPUNIT_ASSERT_EQUAL(total + buf.getCapacity(),
+                         SocketRecvBuffer::getTotalCapacity());
+
+    // The connection is idle.  The buffer is halved after
+    // SHRINK_ROUNDS calls which read little.
+    buf.drain(length);
+    for (int i = 0; i < SocketRecvBuffer::SHRINK_ROUNDS; ++i) {
+      buf.recv();
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)128_k, buf.getCapacity());
+    buf.recv();
+    CPPUNIT_ASSERT_EQUAL((size_t)64_k, buf.getCapacity());
+    CPPUNIT_ASSERT_EQUAL(total + buf.getCapacity(),
+                         SocketRecvBuffer::getTotalCapacity());
+  }
+  CPPUNIT_ASSERT_EQUAL(total, SocketRecvBuffer::getTotalCapacity());
+}
+
+void SocketRecvBufferTest::testRecv_memoryLimit()
+{
+  const size_t length = 100_k;
+  std::string data(length, 'a');
+  size_t limit = SocketRecvBuffer::getMemoryLimit();
+  SocketRecvBuffer buf(receiveData(data));
+  SocketRecvBuffer::setMemoryLimit(SocketRecvBuffer::getTotalCapacity());
+  for (int i = 0; i < 1000 && buf.getBufferLength() < buf.getCapacity();
+       ++i) {
+    buf.getSocket()->isReadable(1);
+    buf.recv();
+  }
+  SocketRecvBuffer::setMemoryLimit(limit);
+  CPPUNIT_ASSERT_EQUAL(SocketRecvBuffer::MIN_CAPACITY, buf.getCapacity());
+  CPPUNIT_ASSERT_EQUAL(SocketRecvBuffer::MIN_CAPACITY, buf.getBufferLength());
+}
+
+} // namespace aria2
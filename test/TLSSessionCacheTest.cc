@@ -0,0 +1,98 @@
+#include "TLSSessionCache.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "wallclock.h"
+
+namespace aria2 {
+
+class TLSSessionCacheTest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TLSSessionCacheTest);
+  CPPUNIT_TEST(testPutAndFind);
+  CPPUNIT_TEST(testExpire);
+  CPPUNIT_TEST(testExpire_replace);
+  CPPUNIT_TEST(testEvict);
+  CPPUNIT_TEST(testCountHandshake);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testPutAndFind();
+  void testExpire();
+  void testExpire_replace();
+  void testEvict();
+  void testCountHandshake();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TLSSessionCacheTest);
+
+void TLSSessionCacheTest::testPutAndFind()
+{
+  TLSSessionCache cache;
+  cache.put("example.org", 443, "session1");
+  cache.put("example.org", 8443, "session2");
+  // Empty data is ignored.
+  cache.put("example.net", 443, "");
+  CPPUNIT_ASSERT_EQUAL((size_t)2, cache.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("session1"),
+                       cache.find("example.org", 443));
+  CPPUNIT_ASSERT_EQUAL(std::string("session2"),
+                       cache.find("example.org", 8443));
+  CPPUNIT_ASSERT_EQUAL(std::string(), cache.find("example.net", 443));
+
+  cache.put("example.org", 443, "session3");
+  CPPUNIT_ASSERT_EQUAL(std::string("session3"),
+                       cache.find("example.org", 443));
+
+  cache.remove("example.org", 443);
+  CPPUNIT_ASSERT_EQUAL(std::string(), cache.find("example.org", 443));
+}
+
+void TLSSessionCacheTest::testExpire()
+{
+  TLSSessionCache cache(16, std::chrono::seconds(60));
+  cache.put("example.org", 443, "session1");
+  global::wallclock().advance(std::chrono::seconds(61));
+  CPPUNIT_ASSERT_EQUAL(std::string(), cache.find("example.org", 443));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, cache.size());
+  global::wallclock().sub(std::chrono::seconds(61));
+}
+
+void TLSSessionCacheTest::testExpire_replace()
+{
+  TLSSessionCache cache(16, std::chrono::seconds(60));
+  cache.put("example.org", 443, "session1");
+  global::wallclock().advance(std::chrono::seconds(40));
+  // Storing the session again on close does not extend its expiry.
+  cache.put("example.org", 443, "session2");
+  CPPUNIT_ASSERT_EQUAL(std::string("session2"),
+                       cache.find("example.org", 443));
+  global::wallclock().advance(std::chrono::seconds(21));
+  CPPUNIT_ASSERT_EQUAL(std::string(), cache.find("example.org", 443));
+  global::wallclock().sub(std::chrono::seconds(61));
+}
+
+void TLSSessionCacheTest::testEvict()
+{
+  TLSSessionCache cache(2);
+  cache.put("a.example.org", 443, "a");
+  cache.put("b.example.org", 443, "b");
+  // a.example.org is now more recently used than b.example.org.
+  cache.find("a.example.org", 443);
+  cache.put("c.example.org", 443, "c");
+  CPPUNIT_ASSERT_EQUAL((size_t)2, cache.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("a"), cache.find("a.example.org", 443));
+  CPPUNIT_ASSERT_EQUAL(std::string(), cache.find("b.example.org", 443));
+  CPPUNIT_ASSERT_EQUAL(std::string("c"), cache.find("c.example.org", 443));
+}
+
+void TLSSessionCacheTest::testCountHandshake()
+{
+  TLSSessionCache cache;
+  cache.countHandshake(false);
+  cache.countHandshake(true);
+  cache.countHandshake(true);
+  CPPUNIT_ASSERT_EQUAL((int64_t)1, cache.getFullHandshakes());
+  CPPUNIT_ASSERT_EQUAL((int64_t)2, cache.getResumedHandshakes());
+}
+
+} // namespace aria2
@@ -0,0 +1,181 @@
+// Microbenchmark for WrDiskCache.  This is not part of the test
+// suite.  Build and run it with:
+//
+//   make -C test WrDiskCacheBench
+//   ./test/WrDiskCacheBench [NUM_PIECES [FILE]]
+//
+// It emulates a BitTorrent download from 64 peers.  Each peer
+// downloads its own piece and receives its blocks slightly out of
+// order, and the blocks of all peers are interleaved.  Completed
+// pieces are flushed as DefaultPieceStorage does.  The data are
+// written to FILE through DiskIOEngine, and FILE is removed at the
+// end.  It reports time per cached block and the number and size of
+// the write system calls.  System calls are counted on Linux only.
+#include "WrDiskCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#endif // __linux__
+
+#include "WrDiskCacheEntry.h"
+#include "DirectDiskAdaptor.h"
+#include "DefaultDiskWriter.h"
+#include "DiskIOEngine.h"
+#include "Piece.h"
+#include "File.h"
+#include "console.h"
+#include "a2functional.h"
+
+namespace {
+size_t numWrites = 0;
+size_t bytesWritten = 0;
+} // namespace
+
+#ifdef __linux__
+extern "C" ssize_t pwrite64(int fd, const void* buf, size_t count,
+                            off_t offset)
+{
+  ++numWrites;
+  ssize_t n = syscall(SYS_pwrite64, fd, buf, count, offset);
+  bytesWritten += n > 0 ? n : 0;
+  return n;
+}
+
+extern "C" ssize_t pwrite(int fd, const void* buf, size_t count, off_t offset)
+{
+  return pwrite64(fd, buf, count, offset);
+}
+
+extern "C" ssize_t pwritev64(int fd, const struct iovec* iov, int iovcnt,
+                             off_t offset)
+{
+  ++numWrites;
+  ssize_t n = syscall(SYS_pwritev, fd, iov, iovcnt, offset, 0);
+  bytesWritten += n > 0 ? n : 0;
+  return n;
+}
+
+extern "C" ssize_t pwritev(int fd, const struct iovec* iov, int iovcnt,
+                           off_t offset)
+{
+  return pwritev64(fd, iov, iovcnt, offset);
+}
+#endif // __linux__
+
+namespace aria2 {
+
+namespace {
+const size_t NUM_PEERS = 64;
+const size_t PIECE_LENGTH = 4_m;
+const size_t BLOCK_LENGTH = 16_k;
+// The number of requests each peer keeps outstanding.  Blocks within
+// the window arrive in random order.
+const size_t WINDOW = 8;
+// --disk-cache default
+const size_t CACHE_LIMIT = 16_m;
+// --disk-io-queue-depth default
+const size_t QUEUE_DEPTH = 8;
+
+struct Peer {
+  std::unique_ptr<Piece> piece;
+  // Blocks requested but not received yet
+  std::vector<size_t> window;
+  size_t nextBlock;
+};
+} // namespace
+
+} // namespace aria2
+
+int main(int argc, char** argv)
+{
+  using namespace aria2;
+  size_t numPieces = argc > 1 ? strtoul(argv[1], nullptr, 10) : 256;
+  std::string path = argc > 2 ? argv[2] : "WrDiskCacheBench.dat";
+  const size_t numBlocks = PIECE_LENGTH / BLOCK_LENGTH;
+  global::initConsole(true);
+
+  auto adaptor = std::make_shared<DirectDiskAdaptor>();
+  {
+    auto dw = make_unique<DefaultDiskWriter>(path);
+    dw->initAndOpenFile();
+    adaptor->setDiskWriter(std::move(dw));
+  }
+  auto engine = make_unique<DiskIOEngine>(QUEUE_DEPTH);
+  DiskIOEngine::setInstance(engine.get());
+  WrDiskCache cache(CACHE_LIMIT);
+  std::mt19937 gen(0);
+
+  std::vector<Peer> peers(NUM_PEERS);
+  size_t nextPiece = 0;
+  auto assignPiece = [&](Peer& peer) {
+    if (nextPiece == numPieces) {
+      peer.piece.reset();
+      return;
+    }
+    peer.piece = make_unique<Piece>(nextPiece++, PIECE_LENGTH, BLOCK_LENGTH);
+    peer.piece->initWrCache(&cache, adaptor);
+    peer.window.clear();
+    peer.nextBlock = 0;
+  };
+  for (auto& peer : peers) {
+    assignPiece(peer);
+  }
+
+  size_t blocks = 0;
+  size_t active = std::min(NUM_PEERS, numPieces);
+  auto start = std::chrono::steady_clock::now();
+  while (active > 0) {
+    auto& peer = peers[gen() % NUM_PEERS];
+    if (!peer.piece) {
+      continue;
+    }
+    while (peer.window.size() < WINDOW && peer.nextBlock < numBlocks) {
+      peer.window.push_back(peer.nextBlock++);
+    }
+    auto i = gen() % peer.window.size();
+    size_t block = peer.window[i];
+    peer.window.erase(peer.window.begin() + i);
+
+    auto& piece = peer.piece;
+    int64_t goff = static_cast<int64_t>(piece->getIndex()) * PIECE_LENGTH +
+                   block * BLOCK_LENGTH;
+    auto data = new unsigned char[BLOCK_LENGTH]();
+    piece->updateWrCache(&cache, data, 0, BLOCK_LENGTH, BLOCK_LENGTH, goff);
+    piece->completeBlock(block);
+    ++blocks;
+    if (piece->pieceComplete()) {
+      piece->flushWrCache(&cache);
+      piece->releaseWrCache(&cache);
+      assignPiece(peer);
+      if (!peer.piece) {
+        --active;
+      }
+    }
+  }
+  adaptor->closeFile();
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  engine.reset();
+  File(path).remove();
+  printf("blocks: %zu\n", blocks);
+  printf("ns/block: %.1f\n", static_cast<double>(elapsed) / blocks);
+#ifdef __linux__
+  printf("write syscalls: %zu\n", numWrites);
+  printf("KiB/write: %.1f\n",
+         static_cast<double>(bytesWritten) / 1024 / numWrites);
+#else  // !__linux__
+  printf("write syscalls: n/a\n");
+#endif // !__linux__
+  return EXIT_SUCCESS;
+}
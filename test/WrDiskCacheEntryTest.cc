@@ -14,6 +14,7 @@ class WrDiskCacheEntryTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(WrDiskCacheEntryTest);
   CPPUNIT_TEST(testWriteToDisk);
+  CPPUNIT_TEST(testCacheData_outOfOrder);
   CPPUNIT_TEST(testAppend);
   CPPUNIT_TEST(testClear);
   CPPUNIT_TEST_SUITE_END();
@@ -31,6 +32,7 @@ public:
   }
 
   void testWriteToDisk();
+  void testCacheData_outOfOrder();
   void testAppend();
   void testClear();
 };
@@ -47,6 +49,33 @@ void WrDiskCacheEntryTest::testWriteToDisk()
   CPPUNIT_ASSERT_EQUAL(std::string("01234567890"), writer_->getString());
 }
 
+void WrDiskCacheEntryTest::testCacheData_outOfOrder()
+{
+  WrDiskCacheEntry e(adaptor_);
+  CPPUNIT_ASSERT(e.cacheData(createDataCell(10, "xyz")));
+  CPPUNIT_ASSERT(e.cacheData(createDataCell(0, "abc")));
+  CPPUNIT_ASSERT(e.cacheData(createDataCell(6, "??gh", 2)));
+  CPPUNIT_ASSERT(e.cacheData(createDataCell(3, "def")));
+  CPPUNIT_ASSERT(e.cacheData(createDataCell(13, "!")));
+  auto dup = createDataCell(3, "DEF");
+  CPPUNIT_ASSERT(!e.cacheData(dup));
+  delete[] dup->data;
+  delete dup;
+  CPPUNIT_ASSERT_EQUAL((size_t)12, e.getSize());
+  auto& cells = e.getDataSet();
+  CPPUNIT_ASSERT_EQUAL((size_t)5, cells.size());
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, cells[0]->goff);
+  CPPUNIT_ASSERT_EQUAL((int64_t)3, cells[1]->goff);
+  CPPUNIT_ASSERT_EQUAL((int64_t)6, cells[2]->goff);
+  CPPUNIT_ASSERT_EQUAL((int64_t)10, cells[3]->goff);
+  CPPUNIT_ASSERT_EQUAL((int64_t)13, cells[4]->goff);
+
+  e.writeToDisk();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("abcdefgh\0\0xyz!", 14),
+                       writer_->getString());
+}
+
 void WrDiskCacheEntryTest::testAppend()
 {
   WrDiskCacheEntry e(adaptor_);
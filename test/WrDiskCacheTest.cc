@@ -14,6 +14,7 @@ class WrDiskCacheTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(WrDiskCacheTest);
   CPPUNIT_TEST(testAdd);
+  CPPUNIT_TEST(testEnsureLimit);
   CPPUNIT_TEST_SUITE_END();
 
   std::shared_ptr<DirectDiskAdaptor> adaptor_;
@@ -29,6 +30,7 @@ public:
   }
 
   void testAdd();
+  void testEnsureLimit();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(WrDiskCacheTest);
@@ -58,19 +60,69 @@ void WrDiskCacheTest::testAdd()
   e3.cacheData(createDataCell(15, " world"));
   CPPUNIT_ASSERT(dc.update(&e3, 6));
 
+  // e2 and e3 are in the same size class.  e2 is flushed to the disk
+  // because it is less recently updated, although e3 is larger.
+  CPPUNIT_ASSERT_EQUAL(std::string("seconddata"),
+                       writer_->getString().substr(21));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e2.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)11, e3.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)11, dc.getSize());
+
+  e2.cacheData(createDataCell(31, "01234567890"));
+  CPPUNIT_ASSERT(dc.update(&e2, 11));
   // e3 is flushed to the disk
-  CPPUNIT_ASSERT_EQUAL(std::string("who knows?hello world"),
+  CPPUNIT_ASSERT_EQUAL(std::string("who knows?hello worldseconddata"),
                        writer_->getString());
   CPPUNIT_ASSERT_EQUAL((size_t)0, e3.getSize());
-  CPPUNIT_ASSERT_EQUAL((size_t)10, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)11, e2.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)11, dc.getSize());
 
-  e2.cacheData(createDataCell(31, "01234567890"));
-  CPPUNIT_ASSERT(dc.update(&e2, 11));
-  // e2 is flushed to the disk
-  CPPUNIT_ASSERT_EQUAL(
-      std::string("who knows?hello worldseconddata01234567890"),
-      writer_->getString());
-  CPPUNIT_ASSERT_EQUAL((size_t)0, e2.getSize());
+  CPPUNIT_ASSERT(dc.remove(&e2));
+  e2.clear();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
+}
+
+void WrDiskCacheTest::testEnsureLimit()
+{
+  WrDiskCache dc(12);
+  WrDiskCacheEntry e1(adaptor_);
+  e1.cacheData(createDataCell(0, "12345"));
+  CPPUNIT_ASSERT(dc.add(&e1));
+  WrDiskCacheEntry e2(adaptor_);
+  e2.cacheData(createDataCell(10, "ABCDEF"));
+  CPPUNIT_ASSERT(dc.add(&e2));
+  CPPUNIT_ASSERT(!dc.add(&e2));
+
+  WrDiskCacheEntry e3(adaptor_);
+  e3.cacheData(createDataCell(20, "xy"));
+  CPPUNIT_ASSERT(dc.add(&e3));
+  // e1 and e2 are in the same size class.  e1 is flushed because it
+  // is older, although e2 is larger.
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e1.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)6, e2.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("12345"), writer_->getString());
+  CPPUNIT_ASSERT_EQUAL((size_t)8, dc.getSize());
+
+  // e4 is in a larger size class than e2, so it is flushed first
+  // although it is the most recently updated.
+  WrDiskCacheEntry e4(adaptor_);
+  e4.cacheData(createDataCell(30, "abcdefghi"));
+  CPPUNIT_ASSERT(dc.add(&e4));
+  CPPUNIT_ASSERT_EQUAL((size_t)6, e2.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e4.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("abcdefghi"),
+                       writer_->getString().substr(30));
+  CPPUNIT_ASSERT_EQUAL((size_t)8, dc.getSize());
+  CPPUNIT_ASSERT(dc.remove(&e4));
+
+  CPPUNIT_ASSERT(dc.remove(&e1));
+  CPPUNIT_ASSERT(!dc.remove(&e1));
+  CPPUNIT_ASSERT(!dc.update(&e1, 1));
+  CPPUNIT_ASSERT_EQUAL((size_t)8, dc.getSize());
+  CPPUNIT_ASSERT(dc.remove(&e2));
+  e2.clear();
+  CPPUNIT_ASSERT(dc.remove(&e3));
+  e3.clear();
   CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
 }
 